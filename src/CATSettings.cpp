@@ -27,13 +27,29 @@
 #define AT_API_KEEP_ALIVE_TIMEOUT                   PROGMEM("APIKEEPALIVETIMEOUT")
 #define AT_AP_SSID                                  PROGMEM("APSSID")
 #define AT_AP_KEY                                   PROGMEM("APKEY")
+#define AT_BRIDGE_OUTBOX_RETENTION                  PROGMEM("OUTBOXRETENTION")
+#define AT_BRIDGE_OUTBOX                            PROGMEM("OUTBOX")
+#define AT_BRIDGE_DEVICES                           PROGMEM("DEVICES")
+#define AT_FLASH_LOG                                PROGMEM("LOG")
 #define AT_RADIO_DEVICE_ID                          PROGMEM("RADIODEVICEID")
 #define AT_RADIO_SERVER_ID                          PROGMEM("RADIOSERVERID")
 #define AT_RADIO_OUTPUT_PWR                         PROGMEM("RADIOOUTPWR")
 #define AT_RADIO_MAX_RETRIES                        PROGMEM("RADIOMAXRETRIES")
 #define AT_RADIO_MESSAGE_SIGNATURE                  PROGMEM("RADIOMSGSIGNATURE")
 #define AT_RADIO_KEEP_ALIVE_TIMEOUT                 PROGMEM("RADIOKEEPALIVETIMEOUT")
+#define AT_RADIO_CHANNEL                            PROGMEM("RADIOCHANNEL")
+#define AT_RADIO_HOPPING_DWELL_TIME                 PROGMEM("RADIOHOPPING")
+#define AT_RADIO_FEC_MODE                           PROGMEM("RADIOFEC")
+#define AT_RADIO_STATS                              PROGMEM("RADIOSTATS")
+#define AT_RADIO_AGGREGATED_SAMPLES                 PROGMEM("RADIOAGGREGATE")
 #define AT_MISCELLANEOUS_SENSOR_MEASUREMENT_TIMEOUT PROGMEM("SENSORMEASUREMENTTIMEOUT")
+#define AT_MISCELLANEOUS_TEMPERATURE_DEAD_BAND      PROGMEM("SENSORTEMPERATUREDEADBAND")
+#define AT_MISCELLANEOUS_HUMIDITY_DEAD_BAND         PROGMEM("SENSORHUMIDITYDEADBAND")
+#define AT_MISCELLANEOUS_MAX_SILENCE_INTERVAL       PROGMEM("SENSORMAXSILENCE")
+#define AT_MISCELLANEOUS_MIN_MEASUREMENT_INTERVAL   PROGMEM("SENSORMININTERVAL")
+#define AT_MISCELLANEOUS_MAX_MEASUREMENT_INTERVAL   PROGMEM("SENSORMAXINTERVAL")
+#define AT_MISCELLANEOUS_SENSOR_RESOLUTION          PROGMEM("SENSORRESOLUTION")
+#define AT_MISCELLANEOUS_SENSOR_OVERSAMPLING        PROGMEM("SENSOROVERSAMPLING")
 #define AT_SENSOR_VALUES                            PROGMEM("SENSORVALUES")
 #define AT_JSON_STATUS                              PROGMEM("JSONSTATUS")
 #define AT_JSON_SETTINGS                            PROGMEM("JSONSETTINGS")
@@ -119,6 +135,32 @@ void CATSettings::updateSerialPort(Stream *p_pSerialPort) {
     m_pSerialPort = p_pSerialPort;
 }
 
+#ifdef BRIDGE_MODE
+/**
+*   Set the cache of the latest readings of the devices, cf AT+DEVICES 
+*   params: 
+*       p_pDeviceCache:  latest readings, updated by the radio
+*   return:
+*       NONE      
+*/
+void CATSettings::initDeviceCache(CDeviceCache *p_pDeviceCache) {
+    m_pDeviceCache = p_pDeviceCache;
+}
+#else
+/**
+*   Set the flash log of the readings not delivered yet, cf AT+LOG 
+*   params: 
+*       p_pFlashLog:    readings logged by the radio thread
+*       p_ulTimeBase:   flash log clock at boot (sec)
+*   return:
+*       NONE      
+*/
+void CATSettings::initFlashLog(CFlashLog *p_pFlashLog, uint32_t p_ulTimeBase) {
+    m_pFlashLog = p_pFlashLog;
+    m_ulFlashLogTimeBase = p_ulTimeBase;
+}
+#endif
+
 /**
 *   check if chars received by serial port form an AT command. Determine if AT command is a GET, SET or DO method 
 *   params: 
@@ -254,7 +296,7 @@ void CATSettings::operateATCommand() {
 
     //Set API PORT
     if (isSetCommand(AT_API_PORT)) {
-        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam) && (getParamNumericValue(m_strctATCommand.pcParam) >= 1)) {
            m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiPort = getParamNumericValue(m_strctATCommand.pcParam);
            goto ok;
         } else {
@@ -286,7 +328,7 @@ void CATSettings::operateATCommand() {
 
     //Set API KEEPALIVE TIMEOUT
     if (isSetCommand(AT_API_KEEP_ALIVE_TIMEOUT)) {
-        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam) && (getParamNumericValue(m_strctATCommand.pcParam) >= 1)) {
            m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiKeepAliveTimeout = getParamNumericValue(m_strctATCommand.pcParam);
            goto ok;
         } else {
@@ -319,6 +361,22 @@ void CATSettings::operateATCommand() {
             goto length_error;
         }
     }
+
+    //Get outbox retention
+    if (isGetCommand(AT_BRIDGE_OUTBOX_RETENTION)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiOutboxRetention);
+        goto ok;
+    }
+
+    //Set outbox retention
+    if (isSetCommand(AT_BRIDGE_OUTBOX_RETENTION)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+           m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiOutboxRetention = getParamNumericValue(m_strctATCommand.pcParam);
+           goto ok;
+        } else {
+            goto error;
+        }
+    }
 #endif
     //Get Device ID
     if (isGetCommand(AT_RADIO_DEVICE_ID)) {
@@ -431,7 +489,7 @@ void CATSettings::operateATCommand() {
 
     //Set Radio message signature
     if (isSetCommand(AT_RADIO_MESSAGE_SIGNATURE)) {
-        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam) && (getParamNumericValue(m_strctATCommand.pcParam) != 0)) {
            m_pGlobalSettingsAndStatus->strctRadioSettings.uiMessageSignature = getParamNumericValue(m_strctATCommand.pcParam);
            goto ok;
         } else {
@@ -448,7 +506,7 @@ void CATSettings::operateATCommand() {
 
     //Set Radio keep alive timeout
     if (isSetCommand(AT_RADIO_KEEP_ALIVE_TIMEOUT)) {
-        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam) && (getParamNumericValue(m_strctATCommand.pcParam) >= 1)) {
            m_pGlobalSettingsAndStatus->strctRadioSettings.uiKeepAliveTimeout = getParamNumericValue(m_strctATCommand.pcParam);
            goto ok;
         } else {
@@ -456,6 +514,80 @@ void CATSettings::operateATCommand() {
         }
     }
 
+    //Get Radio home channel
+    if (isGetCommand(AT_RADIO_CHANNEL)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiChannel);
+        goto ok;
+    }
+
+    //Set Radio home channel
+    if (isSetCommand(AT_RADIO_CHANNEL)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+            if ((getParamNumericValue(m_strctATCommand.pcParam) >= 0) && (getParamNumericValue(m_strctATCommand.pcParam) <= MAX_RADIO_CHANNEL)) {
+                m_pGlobalSettingsAndStatus->strctRadioSettings.uiChannel = getParamNumericValue(m_strctATCommand.pcParam);
+                goto ok;
+            }
+        }
+        
+        goto error;
+    }
+
+#ifdef BRIDGE_MODE
+    //Get Radio hopping dwell time
+    if (isGetCommand(AT_RADIO_HOPPING_DWELL_TIME)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiHoppingDwellTime);
+        goto ok;
+    }
+
+    //Set Radio hopping dwell time
+    if (isSetCommand(AT_RADIO_HOPPING_DWELL_TIME)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+            if ((getParamNumericValue(m_strctATCommand.pcParam) >= 0) && (getParamNumericValue(m_strctATCommand.pcParam) <= 255)) {
+                m_pGlobalSettingsAndStatus->strctRadioSettings.uiHoppingDwellTime = getParamNumericValue(m_strctATCommand.pcParam);
+                goto ok;
+            }
+        }
+        
+        goto error;
+    }
+
+    //Get Radio FEC mode
+    if (isGetCommand(AT_RADIO_FEC_MODE)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiFECMode);
+        goto ok;
+    }
+
+    //Set Radio FEC mode
+    if (isSetCommand(AT_RADIO_FEC_MODE)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+            if ((getParamNumericValue(m_strctATCommand.pcParam) >= 0) && (getParamNumericValue(m_strctATCommand.pcParam) <= 2)) {
+                m_pGlobalSettingsAndStatus->strctRadioSettings.uiFECMode = getParamNumericValue(m_strctATCommand.pcParam);
+                goto ok;
+            }
+        }
+        
+        goto error;
+    }
+#else
+    //Get Radio aggregated samples count
+    if (isGetCommand(AT_RADIO_AGGREGATED_SAMPLES)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiAggregatedSamples);
+        goto ok;
+    }
+
+    //Set Radio aggregated samples count
+    if (isSetCommand(AT_RADIO_AGGREGATED_SAMPLES)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+            if ((getParamNumericValue(m_strctATCommand.pcParam) >= 1) && (getParamNumericValue(m_strctATCommand.pcParam) <= MAX_RADIO_AGGREGATED_SAMPLES)) {
+                m_pGlobalSettingsAndStatus->strctRadioSettings.uiAggregatedSamples = getParamNumericValue(m_strctATCommand.pcParam);
+                goto ok;
+            }
+        }
+        
+        goto error;
+    }
+#endif
+
     //Get sensor values measurementtimeout reading
     if (isGetCommand(AT_MISCELLANEOUS_SENSOR_MEASUREMENT_TIMEOUT)) {
         m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout);
@@ -464,7 +596,7 @@ void CATSettings::operateATCommand() {
 
     //Set sensor values measurement timeout reading
     if (isSetCommand(AT_MISCELLANEOUS_SENSOR_MEASUREMENT_TIMEOUT)) {
-        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam) && (getParamNumericValue(m_strctATCommand.pcParam) >= 1)) {
            m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout = getParamNumericValue(m_strctATCommand.pcParam);
            goto ok;
         } else {
@@ -472,6 +604,122 @@ void CATSettings::operateATCommand() {
         }
     }
 
+    //Get temperature dead-band
+    if (isGetCommand(AT_MISCELLANEOUS_TEMPERATURE_DEAD_BAND)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiTemperatureDeadBand);
+        goto ok;
+    }
+
+    //Set temperature dead-band
+    if (isSetCommand(AT_MISCELLANEOUS_TEMPERATURE_DEAD_BAND)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+           m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiTemperatureDeadBand = getParamNumericValue(m_strctATCommand.pcParam);
+           goto ok;
+        } else {
+            goto error;
+        }
+    }
+
+    //Get humidity dead-band
+    if (isGetCommand(AT_MISCELLANEOUS_HUMIDITY_DEAD_BAND)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiHumidityDeadBand);
+        goto ok;
+    }
+
+    //Set humidity dead-band
+    if (isSetCommand(AT_MISCELLANEOUS_HUMIDITY_DEAD_BAND)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+           m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiHumidityDeadBand = getParamNumericValue(m_strctATCommand.pcParam);
+           goto ok;
+        } else {
+            goto error;
+        }
+    }
+
+    //Get maximum silence interval
+    if (isGetCommand(AT_MISCELLANEOUS_MAX_SILENCE_INTERVAL)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxSilenceInterval);
+        goto ok;
+    }
+
+    //Set maximum silence interval
+    if (isSetCommand(AT_MISCELLANEOUS_MAX_SILENCE_INTERVAL)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+           m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxSilenceInterval = getParamNumericValue(m_strctATCommand.pcParam);
+           goto ok;
+        } else {
+            goto error;
+        }
+    }
+
+    //Get adaptive measurement interval lower bound
+    if (isGetCommand(AT_MISCELLANEOUS_MIN_MEASUREMENT_INTERVAL)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMinMeasurementInterval);
+        goto ok;
+    }
+
+    //Set adaptive measurement interval lower bound
+    if (isSetCommand(AT_MISCELLANEOUS_MIN_MEASUREMENT_INTERVAL)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+           m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMinMeasurementInterval = getParamNumericValue(m_strctATCommand.pcParam);
+           goto ok;
+        } else {
+            goto error;
+        }
+    }
+
+    //Get adaptive measurement interval upper bound
+    if (isGetCommand(AT_MISCELLANEOUS_MAX_MEASUREMENT_INTERVAL)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxMeasurementInterval);
+        goto ok;
+    }
+
+    //Set adaptive measurement interval upper bound
+    if (isSetCommand(AT_MISCELLANEOUS_MAX_MEASUREMENT_INTERVAL)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+           m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxMeasurementInterval = getParamNumericValue(m_strctATCommand.pcParam);
+           goto ok;
+        } else {
+            goto error;
+        }
+    }
+
+    //Get sensor resolution
+    if (isGetCommand(AT_MISCELLANEOUS_SENSOR_RESOLUTION)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiSensorResolution);
+        goto ok;
+    }
+
+    //Set sensor resolution
+    if (isSetCommand(AT_MISCELLANEOUS_SENSOR_RESOLUTION)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+            if ((getParamNumericValue(m_strctATCommand.pcParam) >= CHTU21::ENM_RESOLUTION::RH12_T14) && (getParamNumericValue(m_strctATCommand.pcParam) <= CHTU21::ENM_RESOLUTION::RH11_T11)) {
+                m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiSensorResolution = getParamNumericValue(m_strctATCommand.pcParam);
+                goto ok;
+            }
+        }
+        
+        goto error;
+    }
+
+    //Get sensor oversampling
+    if (isGetCommand(AT_MISCELLANEOUS_SENSOR_OVERSAMPLING)) {
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiOversamplingCount);
+        goto ok;
+    }
+
+    //Set sensor oversampling
+    if (isSetCommand(AT_MISCELLANEOUS_SENSOR_OVERSAMPLING)) {
+        if (isParamNumericValue(m_strctATCommand.pcParam)) {
+            if ((getParamNumericValue(m_strctATCommand.pcParam) >= 1) && (getParamNumericValue(m_strctATCommand.pcParam) <= MAX_SENSOR_OVERSAMPLING)) {
+                m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiOversamplingCount = getParamNumericValue(m_strctATCommand.pcParam);
+                goto ok;
+            }
+        }
+        
+        goto error;
+    }
+
     //Print status formatted JSON
     if (isDoCommand(AT_JSON_STATUS)) {
         m_pSerialPort->print("{");
@@ -512,6 +760,24 @@ void CATSettings::operateATCommand() {
         m_pSerialPort->print(PROGMEM("\"api_keepalive_timeout\":\""));
         m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiKeepAliveTimeout);
         m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"outbox_retention\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiOutboxRetention);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"outbox_depth\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiOutboxDepth);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"outbox_age\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.ulOutboxAge);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"downlink_pending\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiDownlinkPending);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"alive_devices\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiAliveDevices);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"lost_devices\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiLostDevices);
+        m_pSerialPort->print(PROGMEM("\","));
 #endif
         m_pSerialPort->print(PROGMEM("\"radio_device_id\":\""));
         m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioSettings.uiDeviceID);
@@ -532,11 +798,67 @@ void CATSettings::operateATCommand() {
         m_pSerialPort->print(PROGMEM("\","));
         m_pSerialPort->print(PROGMEM("\"radio_keepalive_timeout\":\""));
         m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioSettings.uiKeepAliveTimeout);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"radio_channel\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioSettings.uiChannel);
+        m_pSerialPort->print(PROGMEM("\","));
+#ifdef BRIDGE_MODE
+        m_pSerialPort->print(PROGMEM("\"radio_hopping_dwell_time\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioSettings.uiHoppingDwellTime);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"radio_fec_mode\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioSettings.uiFECMode);
+        m_pSerialPort->print(PROGMEM("\","));
+#else
+        m_pSerialPort->print(PROGMEM("\"radio_aggregated_samples\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioSettings.uiAggregatedSamples);
+        m_pSerialPort->print(PROGMEM("\","));
+#endif
+        m_pSerialPort->print(PROGMEM("\"radio_current_channel\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioStatus.uiCurrentChannel);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"radio_channel_blacklist\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioStatus.uiChannelBlacklist);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"radio_link_profile\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctRadioStatus.uiLinkProfile);
 
         m_pSerialPort->print(PROGMEM("\","));
         m_pSerialPort->print(PROGMEM("\"sensor_values_measurement_timeout\":\""));
         m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout);
         m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_temperature_dead_band\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiTemperatureDeadBand);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_humidity_dead_band\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiHumidityDeadBand);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_max_silence_interval\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxSilenceInterval);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_min_measurement_interval\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMinMeasurementInterval);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_max_measurement_interval\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxMeasurementInterval);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_resolution\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiSensorResolution);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_oversampling\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiOversamplingCount);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_measurement_interval\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiMeasurementInterval);
+        m_pSerialPort->print(PROGMEM("\","));
+        m_pSerialPort->print(PROGMEM("\"sensor_suppressed_readings\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.ulSuppressedReadings);
+        m_pSerialPort->print(PROGMEM("\","));
+#ifndef BRIDGE_MODE
+        m_pSerialPort->print(PROGMEM("\"logged_readings\":\""));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiLoggedReadings);
+        m_pSerialPort->print(PROGMEM("\","));
+#endif
         m_pSerialPort->print(PROGMEM("\"version\":\""));
         m_pSerialPort->print(VERSION_MAJOR);
         m_pSerialPort->print(PROGMEM("."));
@@ -590,7 +912,7 @@ void CATSettings::operateATCommand() {
             strcpy(m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.cHostname, l_pcValue);
         } 
 
-        if ((l_pcValue = getJsonValueFromKey(PROGMEM("api_port"))) != NULL ) {
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("api_port"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 1)) {
             m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiPort = getParamNumericValue(l_pcValue);
         } 
 
@@ -606,16 +928,20 @@ void CATSettings::operateATCommand() {
             strcpy(m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.cAuthorizationToken, l_pcValue);
         } 
 
-        if ((l_pcValue = getJsonValueFromKey(PROGMEM("api_keepalive_timeout"))) != NULL ) {
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("api_keepalive_timeout"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 1)) {
             m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiKeepAliveTimeout = getParamNumericValue(l_pcValue);
         }  
+
+        if ((l_pcValue = getJsonValueFromKey(PROGMEM("outbox_retention"))) != NULL ) {
+            m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiOutboxRetention = getParamNumericValue(l_pcValue);
+        }  
 #endif
 
-        if ((l_pcValue = getJsonValueFromKey(PROGMEM("radio_device_id"))) != NULL ) {
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("radio_device_id"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 1) && (getParamNumericValue(l_pcValue) < MAX_RADIO_DEVICES)) {
             m_pGlobalSettingsAndStatus->strctRadioSettings.uiDeviceID = getParamNumericValue(l_pcValue);
         } 
 
-        if ((l_pcValue = getJsonValueFromKey(PROGMEM("radio_message_signature"))) != NULL ) {
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("radio_message_signature"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 1)) {
             m_pGlobalSettingsAndStatus->strctRadioSettings.uiMessageSignature = getParamNumericValue(l_pcValue);
         } 
 
@@ -632,13 +958,59 @@ void CATSettings::operateATCommand() {
             m_pGlobalSettingsAndStatus->strctRadioSettings.uiMaxRetries = getParamNumericValue(l_pcValue);
         } 
 
-        if ((l_pcValue = getJsonValueFromKey(PROGMEM("radio_keepalive_timeout"))) != NULL ) {
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("radio_keepalive_timeout"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 1)) {
             m_pGlobalSettingsAndStatus->strctRadioSettings.uiKeepAliveTimeout = getParamNumericValue(l_pcValue);
         } 
 
-        if ((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_values_measurement_timeout"))) != NULL ) {
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("radio_channel"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 0) && (getParamNumericValue(l_pcValue) <= MAX_RADIO_CHANNEL)) {
+            m_pGlobalSettingsAndStatus->strctRadioSettings.uiChannel = getParamNumericValue(l_pcValue);
+        } 
+
+#ifdef BRIDGE_MODE
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("radio_hopping_dwell_time"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 0) && (getParamNumericValue(l_pcValue) <= 255)) {
+            m_pGlobalSettingsAndStatus->strctRadioSettings.uiHoppingDwellTime = getParamNumericValue(l_pcValue);
+        } 
+
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("radio_fec_mode"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 0) && (getParamNumericValue(l_pcValue) <= 2)) {
+            m_pGlobalSettingsAndStatus->strctRadioSettings.uiFECMode = getParamNumericValue(l_pcValue);
+        } 
+#else
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("radio_aggregated_samples"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 1) && (getParamNumericValue(l_pcValue) <= MAX_RADIO_AGGREGATED_SAMPLES)) {
+            m_pGlobalSettingsAndStatus->strctRadioSettings.uiAggregatedSamples = getParamNumericValue(l_pcValue);
+        } 
+#endif
+
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_values_measurement_timeout"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 1)) {
             m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout = getParamNumericValue(l_pcValue);
         } 
+
+        if ((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_temperature_dead_band"))) != NULL ) {
+            m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiTemperatureDeadBand = getParamNumericValue(l_pcValue);
+        } 
+
+        if ((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_humidity_dead_band"))) != NULL ) {
+            m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiHumidityDeadBand = getParamNumericValue(l_pcValue);
+        } 
+
+        if ((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_max_silence_interval"))) != NULL ) {
+            m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxSilenceInterval = getParamNumericValue(l_pcValue);
+        } 
+
+        if ((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_min_measurement_interval"))) != NULL ) {
+            m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMinMeasurementInterval = getParamNumericValue(l_pcValue);
+        } 
+
+        if ((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_max_measurement_interval"))) != NULL ) {
+            m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxMeasurementInterval = getParamNumericValue(l_pcValue);
+        } 
+
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_resolution"))) != NULL ) && (getParamNumericValue(l_pcValue) >= CHTU21::ENM_RESOLUTION::RH12_T14) && (getParamNumericValue(l_pcValue) <= CHTU21::ENM_RESOLUTION::RH11_T11)) {
+            m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiSensorResolution = getParamNumericValue(l_pcValue);
+        } 
+
+        if (((l_pcValue = getJsonValueFromKey(PROGMEM("sensor_oversampling"))) != NULL ) && (getParamNumericValue(l_pcValue) >= 1) && (getParamNumericValue(l_pcValue) <= MAX_SENSOR_OVERSAMPLING)) {
+            m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiOversamplingCount = getParamNumericValue(l_pcValue);
+        } 
         goto ok;
     }
 
@@ -668,6 +1040,95 @@ void CATSettings::operateATCommand() {
         goto error;
     }
 
+    //Get radio delivery statistics per link profile
+    if (isDoCommand(AT_RADIO_STATS)) {
+        for (byte l_byLinkProfile = 0; l_byLinkProfile < RADIO_LINK_PROFILES_COUNT; l_byLinkProfile++) {
+            STRUCT_RADIO_LINK_STATS *l_pstrctLinkStats = &m_pGlobalSettingsAndStatus->strctRadioStatus.astrctLinkStats[l_byLinkProfile];
+
+            m_pSerialPort->print((l_byLinkProfile == 0) ? PROGMEM("STANDARD") : PROGMEM("FEC"));
+            m_pSerialPort->print(PROGMEM(" posted:"));
+            m_pSerialPort->print(l_pstrctLinkStats->uiPosted);
+            m_pSerialPort->print(PROGMEM(" delivered:"));
+            m_pSerialPort->print(l_pstrctLinkStats->uiDelivered);
+            m_pSerialPort->print(PROGMEM(" delivery rate (%):"));
+            m_pSerialPort->print((l_pstrctLinkStats->uiPosted != 0) ? (100.0 * l_pstrctLinkStats->uiDelivered / l_pstrctLinkStats->uiPosted) : 0.0);
+            m_pSerialPort->print(PROGMEM(" mean retries:"));
+            m_pSerialPort->println((l_pstrctLinkStats->uiPosted != 0) ? ((float)l_pstrctLinkStats->ulRetries / l_pstrctLinkStats->uiPosted) : 0.0);
+        }
+        goto ok;
+    }
+
+#ifdef BRIDGE_MODE
+    //Get outbox depth and age
+    if (isDoCommand(AT_BRIDGE_OUTBOX)) {
+        m_pSerialPort->print(PROGMEM("readings:"));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiOutboxDepth);
+        m_pSerialPort->print(PROGMEM(" oldest reading age (s):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.ulOutboxAge);
+        goto ok;
+    }
+
+    //Get latest reading of each device, with its age and link quality
+    if (isDoCommand(AT_BRIDGE_DEVICES)) {
+        CDeviceCache::STRUCT_DEVICE_CACHE_ENTRY l_strctEntry;
+
+        for (uint8_t l_uiDeviceId = 0; (m_pDeviceCache != NULL) && (l_uiDeviceId < MAX_RADIO_DEVICES); l_uiDeviceId++) {
+            if (m_pDeviceCache->get(l_uiDeviceId, &l_strctEntry)) {
+                m_pSerialPort->print(PROGMEM("device:"));
+                m_pSerialPort->print(l_uiDeviceId);
+                m_pSerialPort->print(PROGMEM(" temperature:"));
+                printHundredths(l_strctEntry.abySensorValues[0], l_strctEntry.abySensorValues[1]);
+                m_pSerialPort->print(PROGMEM(" humidity:"));
+                printHundredths(l_strctEntry.abySensorValues[2], l_strctEntry.abySensorValues[3]);
+                m_pSerialPort->print(PROGMEM(" partial pressure:"));
+                printHundredths(l_strctEntry.abySensorValues[4], l_strctEntry.abySensorValues[5]);
+                m_pSerialPort->print(PROGMEM(" dew point:"));
+                printHundredths(l_strctEntry.abySensorValues[6], l_strctEntry.abySensorValues[7]);
+                m_pSerialPort->print(PROGMEM(" age (s):"));
+                m_pSerialPort->print(m_pDeviceCache->getReadingAge(&l_strctEntry));
+                m_pSerialPort->print(PROGMEM(" RSSI (dBm):"));
+                m_pSerialPort->print(l_strctEntry.iRSSI);
+                m_pSerialPort->print(PROGMEM(" LQI:"));
+                m_pSerialPort->println(l_strctEntry.uiLQI);
+            }
+        }
+        goto ok;
+    }
+#else
+    //Get readings logged into flash and not delivered yet, oldest first
+    if (isDoCommand(AT_FLASH_LOG)) {
+        STRUCT_FLASH_LOG_RECORD l_strctRecord;
+        uint16_t l_uiCursor = 0;
+        uint32_t l_ulTime = m_ulFlashLogTimeBase + xTaskGetTickCount() / configTICK_RATE_HZ;
+        boolean l_bRead = (m_pFlashLog != NULL);
+
+        if (l_bRead) {
+            l_uiCursor = m_pFlashLog->getReplayCursor();
+        }
+
+        while (l_bRead) {
+            //the radio thread logs and replays readings meanwhile: one record read at a time, without task switching
+            vTaskSuspendAll();
+            l_bRead = m_pFlashLog->readNext(&l_uiCursor, &l_strctRecord);
+            xTaskResumeAll();
+
+            if (l_bRead) {
+                m_pSerialPort->print(PROGMEM("temperature:"));
+                printHundredths(l_strctRecord.abySensorValues[0], l_strctRecord.abySensorValues[1]);
+                m_pSerialPort->print(PROGMEM(" humidity:"));
+                printHundredths(l_strctRecord.abySensorValues[2], l_strctRecord.abySensorValues[3]);
+                m_pSerialPort->print(PROGMEM(" partial pressure:"));
+                printHundredths(l_strctRecord.abySensorValues[4], l_strctRecord.abySensorValues[5]);
+                m_pSerialPort->print(PROGMEM(" dew point:"));
+                printHundredths(l_strctRecord.abySensorValues[6], l_strctRecord.abySensorValues[7]);
+                m_pSerialPort->print(PROGMEM(" age (s):"));
+                m_pSerialPort->println((l_strctRecord.ulTimestamp < l_ulTime) ? (l_ulTime - l_strctRecord.ulTimestamp) : 0);
+            }
+        }
+        goto ok;
+    }
+#endif
+
     //Get Firmware version
     if (isDoCommand(AT_VERSION)) {
         m_pSerialPort->print(PROGMEM("Version: "));
@@ -724,6 +1185,18 @@ void CATSettings::operateATCommand() {
         m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.cAuthorizationToken);
         m_pSerialPort->print(PROGMEM("Keep-alive timeout (min):"));
         m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiKeepAliveTimeout);
+        m_pSerialPort->print(PROGMEM("Outbox retention (h):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctBridgeSettings.strctAPIServerSettings.uiOutboxRetention);
+        m_pSerialPort->print(PROGMEM("Outbox readings:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiOutboxDepth);
+        m_pSerialPort->print(PROGMEM("Outbox oldest reading age (s):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.ulOutboxAge);
+        m_pSerialPort->print(PROGMEM("Downlink commands pending:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiDownlinkPending);
+        m_pSerialPort->print(PROGMEM("Devices alive:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiAliveDevices);
+        m_pSerialPort->print(PROGMEM("Devices lost:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiLostDevices);
 #endif
         m_pSerialPort->println(PROGMEM("----RADIO SETTINGS----"));
         m_pSerialPort->print(PROGMEM("Device ID:"));
@@ -776,9 +1249,48 @@ void CATSettings::operateATCommand() {
         m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiMessageSignature);
         m_pSerialPort->print(PROGMEM("Keep-alive timeout (min): "));
         m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiKeepAliveTimeout);
+        m_pSerialPort->print(PROGMEM("Home channel:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiChannel);
+#ifdef BRIDGE_MODE
+        m_pSerialPort->print(PROGMEM("Hopping dwell time (s):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiHoppingDwellTime);
+        m_pSerialPort->print(PROGMEM("FEC mode:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiFECMode);
+#else
+        m_pSerialPort->print(PROGMEM("Aggregated samples:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioSettings.uiAggregatedSamples);
+#endif
+        m_pSerialPort->print(PROGMEM("Current channel:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioStatus.uiCurrentChannel);
+        m_pSerialPort->print(PROGMEM("Blacklisted hopping slots:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctRadioStatus.uiChannelBlacklist, 2);
+        m_pSerialPort->print(PROGMEM("Link profile:"));
+        m_pSerialPort->println((m_pGlobalSettingsAndStatus->strctRadioStatus.uiLinkProfile == 0) ? PROGMEM("STANDARD") : PROGMEM("FEC"));
         m_pSerialPort->println(PROGMEM("----MISCELLANEOUS----"));
         m_pSerialPort->print(PROGMEM("Sensor values measurement timeout (min):"));
         m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout);
+        m_pSerialPort->print(PROGMEM("Temperature dead-band (1/100 deg):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiTemperatureDeadBand);
+        m_pSerialPort->print(PROGMEM("Humidity dead-band (1/100 %RH):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiHumidityDeadBand);
+        m_pSerialPort->print(PROGMEM("Max silence interval (min):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxSilenceInterval);
+        m_pSerialPort->print(PROGMEM("Adaptive measurement interval bounds (s):"));
+        m_pSerialPort->print(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMinMeasurementInterval);
+        m_pSerialPort->print(PROGMEM("-"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiMaxMeasurementInterval);
+        m_pSerialPort->print(PROGMEM("Sensor resolution:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiSensorResolution);
+        m_pSerialPort->print(PROGMEM("Sensor oversampling (samples per measurement):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousSettings.uiOversamplingCount);
+        m_pSerialPort->print(PROGMEM("Current measurement interval (s):"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiMeasurementInterval);
+        m_pSerialPort->print(PROGMEM("Suppressed readings:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.ulSuppressedReadings);
+#ifndef BRIDGE_MODE
+        m_pSerialPort->print(PROGMEM("Logged readings:"));
+        m_pSerialPort->println(m_pGlobalSettingsAndStatus->strctMiscellaneousStatus.uiLoggedReadings);
+#endif
         goto ok;
     }
 
@@ -839,6 +1351,9 @@ void CATSettings::operateATCommand() {
         m_pSerialPort->print(AT_API_KEEP_ALIVE_TIMEOUT);
         m_pSerialPort->println(PROGMEM(": API-Server keep-alive frequency (minutes)"));
         m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_BRIDGE_OUTBOX_RETENTION);
+        m_pSerialPort->println(PROGMEM(": readings not uploaded are dropped from the outbox after (hours) - 0: kept until overwritten"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
         m_pSerialPort->print(AT_AP_SSID);
         m_pSerialPort->println(PROGMEM(": access point SSID"));
 #endif
@@ -863,9 +1378,45 @@ void CATSettings::operateATCommand() {
         m_pSerialPort->print(AT_RADIO_KEEP_ALIVE_TIMEOUT);
         m_pSerialPort->print(AT_PREFIXE_COMMAND);
         m_pSerialPort->println(PROGMEM(": bridge-server keep-alive frequency (minutes)"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_RADIO_CHANNEL);
+        m_pSerialPort->println(PROGMEM(": home channel - from 0 to 247. Hopping uses the 8 channels from it, keep 8 channels between bridges"));
+#ifdef BRIDGE_MODE
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_RADIO_HOPPING_DWELL_TIME);
+        m_pSerialPort->println(PROGMEM(": seconds spent on each hopping channel - 0 disables hopping"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_RADIO_FEC_MODE);
+        m_pSerialPort->println(PROGMEM(": 0:standard link, 1:FEC link (16 bytes messages), 2:FEC link on device request"));
+#else
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_RADIO_AGGREGATED_SAMPLES);
+        m_pSerialPort->println(PROGMEM(": readings sent together in one frame - from 1 (no aggregation) to 24"));
+#endif
         m_pSerialPort->print(AT_PREFIXE_COMMAND);
         m_pSerialPort->print(AT_MISCELLANEOUS_SENSOR_MEASUREMENT_TIMEOUT);
         m_pSerialPort->println(PROGMEM(": Sensor values measurement frequency (minutes)"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_MISCELLANEOUS_TEMPERATURE_DEAD_BAND);
+        m_pSerialPort->println(PROGMEM(": reading sent if temperature moves more (1/100 degree) - 0 disables send-on-delta"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_MISCELLANEOUS_HUMIDITY_DEAD_BAND);
+        m_pSerialPort->println(PROGMEM(": reading sent if humidity moves more (1/100 %RH) - 0 disables send-on-delta"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_MISCELLANEOUS_MAX_SILENCE_INTERVAL);
+        m_pSerialPort->println(PROGMEM(": reading sent anyway after this silence (minutes) - 0: no maximum"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_MISCELLANEOUS_MIN_MEASUREMENT_INTERVAL);
+        m_pSerialPort->println(PROGMEM(": adaptive measurement shortest interval (seconds) - 0: fixed measurement frequency"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_MISCELLANEOUS_MAX_MEASUREMENT_INTERVAL);
+        m_pSerialPort->println(PROGMEM(": adaptive measurement longest interval (seconds)"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_MISCELLANEOUS_SENSOR_RESOLUTION);
+        m_pSerialPort->println(PROGMEM(": conversion time & energy per measurement - 0:RH12/T14 66ms 98uJ, 1:RH8/T12 16ms 24uJ, 2:RH10/T13 30ms 45uJ, 3:RH11/T11 15ms 22uJ"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_MISCELLANEOUS_SENSOR_OVERSAMPLING);
+        m_pSerialPort->println(PROGMEM(": samples per measurement, outliers rejected - from 1 (no oversampling) to 9"));
 
         m_pSerialPort->println(PROGMEM("---SET ONLY (AT+COMMAND=)----"));
 #ifdef BRIDGE_MODE
@@ -894,12 +1445,27 @@ void CATSettings::operateATCommand() {
         m_pSerialPort->println(PROGMEM(": Device type, bridge or sensor"));
         m_pSerialPort->print(AT_SENSOR_VALUES);
         m_pSerialPort->println(PROGMEM(": measure and return sensor values"));
+#ifdef BRIDGE_MODE
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_BRIDGE_OUTBOX);
+        m_pSerialPort->println(PROGMEM(": readings waiting in the outbox and age of the oldest one"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_BRIDGE_DEVICES);
+        m_pSerialPort->println(PROGMEM(": latest reading of each device, with its age and link quality"));
+#else
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_FLASH_LOG);
+        m_pSerialPort->println(PROGMEM(": readings logged into flash and not delivered yet, oldest first, with their age"));
+#endif
 
         m_pSerialPort->println(PROGMEM("---DO (AT+COMMAND)---"));
         m_pSerialPort->print(AT_PREFIXE_COMMAND);
         m_pSerialPort->print(AT_SAVE_SETTINGS);
         m_pSerialPort->println(PROGMEM(": perform settings flash-saving, otherwise, new settings will be lost after reboot - reboot mandatory in order to manage with new settings"));
         m_pSerialPort->print(AT_PREFIXE_COMMAND);
+        m_pSerialPort->print(AT_RADIO_STATS);
+        m_pSerialPort->println(PROGMEM(": radio delivery rate and mean retries per link profile"));
+        m_pSerialPort->print(AT_PREFIXE_COMMAND);
         m_pSerialPort->print(AT_FACTORY_RESET);
         m_pSerialPort->print(PROGMEM(": clear settings into flash"));
 #ifdef BRIDGE_MODE
@@ -972,6 +1538,20 @@ boolean CATSettings::isDoCommand(const char *p_pcCommand) {
     return ((strcmp(m_strctATCommand.pcCommand, p_pcCommand) == 0) && (m_strctATCommand.enmMethod == CATSettings::ENM_METHOD::DO));
 }
 
+/**
+*   print a sensor value coded as quotient and hundredths, e.g. 21 and 5 => "21.05"
+*   params: 
+*       p_byQuotient:       integer part
+*       p_byRemainder:      hundredths
+*   return:
+*       NONE      
+*/
+void CATSettings::printHundredths(byte p_byQuotient, byte p_byRemainder) {
+    m_pSerialPort->print(p_byQuotient);
+    m_pSerialPort->print((p_byRemainder < 10) ? PROGMEM(".0") : PROGMEM("."));
+    m_pSerialPort->print(p_byRemainder);
+}
+
 /**
 *   check if AT-SET param is equal to a string
 *   params: 
@@ -1004,7 +1584,9 @@ boolean CATSettings::isParamLengthConsistent(size_t p_sztMaxLength) {
 boolean CATSettings::isParamNumericValue(char *p_pcValue) {
     char *l_pcEnd;
 
-    return (strtol(p_pcValue, &l_pcEnd, 10) != 0L);
+    strtol(p_pcValue, &l_pcEnd, 10);
+
+    return ((l_pcEnd != p_pcValue) && (*l_pcEnd == '\0'));
 }
 
 /**
@@ -21,9 +21,14 @@
 
 #include "Adafruit_TinyUSB.h"
 
-#include "global.h"
-#include "logging.h"
+#include "Global.h"
+#include "Logging.h"
 #include "CHTU21.h"
+#ifdef BRIDGE_MODE
+    #include "bridge/CDeviceCache.h"
+#else
+    #include "logger/CFlashLog.h"
+#endif
 
 /**	
  *	This is a free software: you can redistribute it and/or modify
@@ -55,6 +60,11 @@ public:
             EventGroupHandle_t *p_pxEventGroupMiscellaneousHandle, QueueHandle_t *p_pxQueueATSettingsHandle);     
     void pool() ;
     void updateSerialPort(Stream *p_pSerialPort);
+#ifdef BRIDGE_MODE
+    void initDeviceCache(CDeviceCache *p_pDeviceCache);
+#else
+    void initFlashLog(CFlashLog *p_pFlashLog, uint32_t p_ulTimeBase);
+#endif
 
 private:
     enum ENM_METHOD {GET, SET, DO, UNKNOWN};
@@ -77,6 +87,12 @@ private:
 
     STRCT_AT_COMMAND    m_strctATCommand;
     boolean             m_bEchoEnabled = false;
+#ifdef BRIDGE_MODE
+    CDeviceCache        *m_pDeviceCache = NULL;
+#else
+    CFlashLog           *m_pFlashLog = NULL;
+    uint32_t            m_ulFlashLogTimeBase = 0;
+#endif
 
     void                checkATCommand();
     int                 indexOf(char *p_pcBuffer, const char *p_pcSearch, size_t p_sztFromIndex);
@@ -89,6 +105,7 @@ private:
     boolean             isParamLengthConsistent(size_t p_sztMaxLength);
     boolean             isParamEqualTo(const char *p_pcParam);
     char *              getJsonValueFromKey(const char *p_pcKey);
+    void                printHundredths(byte p_byQuotient, byte p_byRemainder);
 };
 
 #endif
\ No newline at end of file
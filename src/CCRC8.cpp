@@ -0,0 +1,79 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#include "CCRC8.h"
+
+//CRC of a single byte: 8 polynomial divisions steps, evaluated by the compiler
+constexpr uint8_t crc8Step(uint8_t p_uiCRC, uint8_t p_uiBits) {
+    return (p_uiBits == 0) ? p_uiCRC : crc8Step((p_uiCRC & 0x80) ? (uint8_t)((p_uiCRC << 1) ^ CRC8_POLYNOMIAL) : (uint8_t)(p_uiCRC << 1), p_uiBits - 1);
+}
+
+#define CRC8_ENTRY(n)       crc8Step((n), 8)
+#define CRC8_ROW(n)         CRC8_ENTRY((n) + 0), CRC8_ENTRY((n) + 1), CRC8_ENTRY((n) + 2), CRC8_ENTRY((n) + 3), \
+                            CRC8_ENTRY((n) + 4), CRC8_ENTRY((n) + 5), CRC8_ENTRY((n) + 6), CRC8_ENTRY((n) + 7), \
+                            CRC8_ENTRY((n) + 8), CRC8_ENTRY((n) + 9), CRC8_ENTRY((n) + 10), CRC8_ENTRY((n) + 11), \
+                            CRC8_ENTRY((n) + 12), CRC8_ENTRY((n) + 13), CRC8_ENTRY((n) + 14), CRC8_ENTRY((n) + 15)
+
+const uint8_t CCRC8::m_auiTable[256] = {
+    CRC8_ROW(0x00), CRC8_ROW(0x10), CRC8_ROW(0x20), CRC8_ROW(0x30),
+    CRC8_ROW(0x40), CRC8_ROW(0x50), CRC8_ROW(0x60), CRC8_ROW(0x70),
+    CRC8_ROW(0x80), CRC8_ROW(0x90), CRC8_ROW(0xA0), CRC8_ROW(0xB0),
+    CRC8_ROW(0xC0), CRC8_ROW(0xD0), CRC8_ROW(0xE0), CRC8_ROW(0xF0)
+};
+
+//constant initialization, no table built at runtime
+static_assert(CRC8_ENTRY(0x01) == CRC8_POLYNOMIAL, "CRC-8 table generation");
+
+/****************************************************************************************
+ * 
+ *     *****    *     *     *****       *         *****       **** 
+ *     *    *   *     *     *    *      *           *       *     
+ *     * * *    *     *     *  *        *           *      *       
+ *     *        *     *     *    *      *           *       *        
+ *     *         * * *      ******      ******    *****       ****        
+ *    
+ * **************************************************************************************/
+
+/**
+*   Continue a CRC over more bytes
+*   params: 
+*       p_uiCRC:            CRC of the previous bytes, CRC8_INIT to start
+*       p_pbyDataArray:     bytes
+*       p_sztLength:        bytes count
+*   return:
+*       CRC
+*/
+uint8_t CCRC8::update(uint8_t p_uiCRC, const byte *p_pbyDataArray, size_t p_sztLength) {
+    while (p_sztLength--) {
+        p_uiCRC = m_auiTable[p_uiCRC ^ *p_pbyDataArray++];
+    }
+
+    return p_uiCRC;
+}
+
+/**
+*   CRC of a bytes array
+*   params: 
+*       p_pbyDataArray:     bytes
+*       p_sztLength:        bytes count
+*   return:
+*       CRC
+*/
+uint8_t CCRC8::compute(const byte *p_pbyDataArray, size_t p_sztLength) {
+    return update(CRC8_INIT, p_pbyDataArray, p_sztLength);
+}
@@ -0,0 +1,40 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#ifndef __CCRC8_H__
+#define __CCRC8_H__
+
+#include <Arduino.h>
+
+#define CRC8_POLYNOMIAL             0x31        //x^8 + x^5 + x^4 + 1, HTU21
+#define CRC8_INIT                   0x00
+
+/**
+ *  CRC-8, MSB first, no reflection, no final XOR. Byte-wise update through a 256 entries table 
+ *  computed at compile time and stored in flash
+ */
+class CCRC8 {
+public:
+    static uint8_t  update(uint8_t p_uiCRC, const byte *p_pbyDataArray, size_t p_sztLength);
+    static uint8_t  compute(const byte *p_pbyDataArray, size_t p_sztLength);
+
+private:
+    static const uint8_t m_auiTable[256];
+};
+
+#endif
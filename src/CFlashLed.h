@@ -19,7 +19,7 @@
 #ifndef _CFLASH_LED_H_
 #define _CFLASH_LED_H_
 
-#include <arduino.h>
+#include <Arduino.h>
 
 class CFlashLed {
 public:
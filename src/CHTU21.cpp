@@ -18,6 +18,32 @@
  */
 #include "CHTU21.h"
 
+//user register bits and maximum conversion times of each resolution, cf ENM_RESOLUTION
+static const struct {
+    byte        byUserRegisterBits;
+    uint16_t    uiTemperatureConversionMs;
+    uint16_t    uiHumidityConversionMs;
+} g_astrctResolutions[] = {
+    {0x00, 50, 16},
+    {0x01, 13, 3},
+    {0x80, 25, 5},
+    {0x81, 7, 8}
+};
+
+//2^(i/32), i from 0 to 32, Q16
+static const uint32_t g_aulExp2Table[] = {
+    65536, 66971, 68438, 69936, 71468, 73032, 74632, 76266, 77936, 79642, 81386, 83169, 84990, 86851, 88752, 90696,
+    92682, 94711, 96785, 98905, 101070, 103283, 105545, 107856, 110218, 112631, 115098, 117618, 120194, 122825, 125515, 128263,
+    131072
+};
+
+//log2(1 + i/32), i from 0 to 32, Q12
+static const uint16_t g_auiLog2Table[] = {
+    0, 182, 358, 530, 696, 858, 1016, 1169, 1319, 1465, 1607, 1746, 1882, 2015, 2145, 2272,
+    2396, 2518, 2637, 2754, 2869, 2982, 3092, 3200, 3307, 3412, 3514, 3615, 3715, 3812, 3908, 4003,
+    4096
+};
+
 /****************************************************************************************
  * 
  *     *****    *     *     *****       *         *****       **** 
@@ -29,61 +55,120 @@
  * **************************************************************************************/
 
 /**
-*   Init the driver and set SPI  
+*   Init the driver and set I2C. SERCOM interrupt has to call interruptHandler()
 *   params: 
-*       NONE
+*       p_enmResolution:    measurement resolution, cf ENM_RESOLUTION
 *   return:
 *       TRUE
 */
-boolean CHTU21::init() {
-    Wire.begin();
-    Wire.setClock(I2C_FREQUENCY);
+boolean CHTU21::init(ENM_RESOLUTION p_enmResolution) {
+    m_i2cMaster.init(I2C_FREQUENCY);
+
+    //default resolution is kept if the sensor does not answer
+    m_enmResolution = ENM_RESOLUTION::RH12_T14;
+    if (!setResolution(p_enmResolution)) {
+        LOG_ERROR_PRINTLN(LOG_PREFIX_CHTU21, "setResolution", p_enmResolution);
+    }
+
+#ifdef _BENCHMARK_
+    benchmarkMath();
+#endif
+
     return true;
 }
 
-CHTU21::STRUCT_SENSOR_VALUES CHTU21::getSensorValues() {
+/**
+*   Measure temperature and humidity, then compute partial pressure and dew point. 
+*   A burst of samples is taken back to back: reported temperature and humidity are the mean of the samples 
+*   left after outlier rejection, cf filterValues. Samples failing CRC retries are skipped.
+*   The calling task sleeps during conversions and between retries. Computation runs in fixed point 
+*   (hundredths), the Cortex-M0+ having no FPU
+*   params: 
+*       p_uiBurstCount:         samples per measurement, from 1 to MAX_SENSOR_OVERSAMPLING
+*       p_pstrctStatistics:     if not NULL, burst statistics. uiSamplesCount is 0 if the sensor did not answer properly
+*   return:
+*       sensor values. All are -255 if the sensor did not answer properly
+*/
+CHTU21::STRUCT_SENSOR_VALUES CHTU21::getSensorValues(uint8_t p_uiBurstCount, STRUCT_SENSOR_STATISTICS *p_pstrctStatistics) {
     CHTU21::STRUCT_SENSOR_VALUES l_strSensorValues;
+    STRUCT_SENSOR_STATISTICS l_strctStatistics;
     uint8_t l_uiRetriesCounter;
+    uint8_t l_uiBurstIndex;
+    boolean l_bTemperatureRead;
+    boolean l_bHumidityRead;
+    int16_t l_aiTemperatureValues[MAX_SENSOR_OVERSAMPLING];
+    int16_t l_aiHumidityValues[MAX_SENSOR_OVERSAMPLING];
+    int16_t l_iTemperatureValue;
+    int16_t l_iHumidityValue;
+    uint32_t l_ulPartialPressureValue;
 
-    l_uiRetriesCounter = MAX_RETRIES;
-    while (l_uiRetriesCounter-- >= 0) {
-        if ((l_strSensorValues.fTemperatureValue = readTemperatureValue()) != -1) {
-            break;
+    memset(&l_strctStatistics, 0, sizeof(STRUCT_SENSOR_STATISTICS));
+    p_uiBurstCount = constrain(p_uiBurstCount, 1, MAX_SENSOR_OVERSAMPLING);
+
+    for (l_uiBurstIndex = 0; l_uiBurstIndex < p_uiBurstCount; l_uiBurstIndex++) {
+        l_bTemperatureRead = false;
+        l_bHumidityRead = false;
+
+        for (l_uiRetriesCounter = 0; (l_uiRetriesCounter <= MAX_RETRIES) && !l_bTemperatureRead; l_uiRetriesCounter++) {
+            if (!(l_bTemperatureRead = readTemperatureValue(&l_aiTemperatureValues[l_strctStatistics.uiSamplesCount]))) {
+                //CRC is bad
+                vTaskDelay(pdMS_TO_TICKS(RETRY_BACKOFF_MS << l_uiRetriesCounter));
+            }
         }
 
-        //CRC is bad
-        l_strSensorValues.fTemperatureValue = -255 ;
-    }
+        for (l_uiRetriesCounter = 0; (l_uiRetriesCounter <= MAX_RETRIES) && !l_bHumidityRead; l_uiRetriesCounter++) {
+            if (!(l_bHumidityRead = readHumidityValue(&l_aiHumidityValues[l_strctStatistics.uiSamplesCount]))) {
+                //CRC is bad
+                vTaskDelay(pdMS_TO_TICKS(RETRY_BACKOFF_MS << l_uiRetriesCounter));
+            }
+        }
 
-    l_uiRetriesCounter = MAX_RETRIES;
-    while (l_uiRetriesCounter-- >= 0) {
-        if ((l_strSensorValues.fHumidityValue = readHumidityValue()) != -1) {
-            break;
+        //only if CRC is correct
+        if (l_bTemperatureRead && l_bHumidityRead) {
+            //relatif humidy compensation vs temperature: -0.15 %RH/degree from 25 degrees
+            l_aiHumidityValues[l_strctStatistics.uiSamplesCount] -= (15 * (2500 - l_aiTemperatureValues[l_strctStatistics.uiSamplesCount])) / 100;
+            l_strctStatistics.uiSamplesCount++;
         }
+    }
 
-        //CRC is bad
+    if (l_strctStatistics.uiSamplesCount == 0) {
+        l_strSensorValues.fTemperatureValue = -255;
         l_strSensorValues.fHumidityValue = -255;
-    }
-    
+        l_strSensorValues.fPartialPressureValue = -255;
+        l_strSensorValues.fDewPointTemperatureValue = -255;
+    } else {
+        l_iTemperatureValue = filterValues(l_aiTemperatureValues, l_strctStatistics.uiSamplesCount, OUTLIER_MIN_TEMPERATURE_DEVIATION, 
+                                            &l_strctStatistics.strctTemperature, &l_strctStatistics.uiRejectedCount);
+        l_iHumidityValue = filterValues(l_aiHumidityValues, l_strctStatistics.uiSamplesCount, OUTLIER_MIN_HUMIDITY_DEVIATION, 
+                                            &l_strctStatistics.strctHumidity, &l_strctStatistics.uiRejectedCount);
 
-    //only if CRC is correct
-    if ((l_strSensorValues.fTemperatureValue != -255) && (l_strSensorValues.fHumidityValue != -255)) {
-        //relatif humidy compensation vs temperature
-        l_strSensorValues.fHumidityValue = l_strSensorValues.fHumidityValue - (0.15 * (25 - l_strSensorValues.fTemperatureValue));
+        l_strSensorValues.fTemperatureValue = l_iTemperatureValue / 100.0f;
+        l_strSensorValues.fHumidityValue = l_iHumidityValue / 100.0f;
 
-        float l_fTemp = ((float)SENSOR_CONSTANT_A)  - ((float)SENSOR_CONSTANT_B / (float)(l_strSensorValues.fTemperatureValue + SENSOR_CONSTANT_C)); 
-        l_strSensorValues.fPartialPressureValue = powf(10.00, l_fTemp);
+        l_ulPartialPressureValue = computePartialPressure(l_iTemperatureValue);
+        l_strSensorValues.fPartialPressureValue = l_ulPartialPressureValue / 100.0f;
 
-        l_fTemp = (l_strSensorValues.fHumidityValue * l_strSensorValues.fPartialPressureValue) / 100;
-        l_fTemp = log10f(l_fTemp) - (float)SENSOR_CONSTANT_A;
-        l_fTemp = ((float)SENSOR_CONSTANT_B) / l_fTemp;
+        l_strSensorValues.fDewPointTemperatureValue = computeDewPoint(l_iTemperatureValue, l_iHumidityValue) / 100.0f;
+    }
 
-        l_strSensorValues.fDewPointTemperatureValue = (l_fTemp + (float)SENSOR_CONSTANT_C)*-1;
+    if (p_pstrctStatistics != NULL) {
+        memcpy(p_pstrctStatistics, &l_strctStatistics, sizeof(STRUCT_SENSOR_STATISTICS));
     }
 
     return l_strSensorValues;
 }
 
+/**
+*   To be called from the I2C SERCOM interrupt
+*   params: 
+*       NONE
+*   return:
+*       true if the I2C transaction is over: the measuring task has to be notified
+*/
+boolean CHTU21::interruptHandler() {
+    return m_i2cMaster.interruptHandler();
+}
+
 /****************************************************************************************
  * 
  *     *****    *****      ***     *       *     *****      *******     ******   
@@ -94,81 +179,383 @@ CHTU21::STRUCT_SENSOR_VALUES CHTU21::getSensorValues() {
  *   
  * **************************************************************************************/
 
+/**
+*   Program the resolution into the user register. Reserved bits are read first and kept
+*   params: 
+*       p_enmResolution:    measurement resolution
+*   return:
+*       true if the user register has been written
+*/
+boolean CHTU21::setResolution(ENM_RESOLUTION p_enmResolution) {
+    byte l_abyDataArray[2];
+
+    if (p_enmResolution > ENM_RESOLUTION::RH11_T11) {
+        return false;
+    }
+
+    l_abyDataArray[0] = REG_USER_READ;
+    if ((m_i2cMaster.write(HTU21_ADDR, &l_abyDataArray[0], 1, I2C_TIMEOUT_MILLISEC) != CI2CMaster::ENM_STATUS::SUCCEEDED) || 
+        (m_i2cMaster.read(HTU21_ADDR, &l_abyDataArray[1], 1, I2C_TIMEOUT_MILLISEC) != CI2CMaster::ENM_STATUS::SUCCEEDED)) {
+        return false;
+    }
+
+    l_abyDataArray[0] = REG_USER_WRITE;
+    l_abyDataArray[1] = (l_abyDataArray[1] & ~USER_REGISTER_RESOLUTION_MASK) | g_astrctResolutions[p_enmResolution].byUserRegisterBits;
+
+    if (writeI2C(HTU21_ADDR, l_abyDataArray, 2) != 2) {
+        return false;
+    }
+
+    m_enmResolution = p_enmResolution;
+    return true;
+}
+
 /**
 *   Retreive temperature value   
 *   params: 
-*       NONE
+*       p_piTemperatureValue:   temperature, hundredths of degree
 *   return:
-*       floting value
+*       false if the measure failed
 */
-float CHTU21::readTemperatureValue() {
+boolean CHTU21::readTemperatureValue(int16_t *p_piTemperatureValue) {
     byte l_byDataArray[3];
     
-    if (!this->readI2C(HTU21_ADDR, REG_TRIG_TEMP__HM, &l_byDataArray[0], 3)) {
-        return -1;
+    if (!this->readI2C(HTU21_ADDR, REG_TRIG_TEMP__NHM, &l_byDataArray[0], 3, g_astrctResolutions[m_enmResolution].uiTemperatureConversionMs)) {
+        return false;
     }
 
-    float l_fCurrentTemperatureValue = -46.85 + (175.72 * (((l_byDataArray[0] << 8) | l_byDataArray[1])) / 65536.0);
+    //T = -46.85 + 175.72 * S / 2^16
+    *p_piTemperatureValue = -4685 + (int16_t)((17572UL * (((l_byDataArray[0] << 8) | l_byDataArray[1]) & ~MEASURE_STATUS_BITS) + 32768) >> 16);
 
-    return l_fCurrentTemperatureValue; 
+    return true; 
 }
 
 /**
 *   Retreive humidity value   
 *   params: 
-*       NONE
+*       p_piHumidityValue:      relative humidity, hundredths of %RH
 *   return:
-*       floting value
+*       false if the measure failed
 */	
-float CHTU21::readHumidityValue() {
+boolean CHTU21::readHumidityValue(int16_t *p_piHumidityValue) {
     byte l_byDataArray[3];
     
-    if (!this->readI2C(HTU21_ADDR, REG_TRIG_HUM__HM, &l_byDataArray[0], 3)) {
-        return -1;
+    if (!this->readI2C(HTU21_ADDR, REG_TRIG_HUM__NHM, &l_byDataArray[0], 3, g_astrctResolutions[m_enmResolution].uiHumidityConversionMs)) {
+        return false;
     }
     
-    float l_fCurrentHumidityValue = -6 + (125.0 * ((l_byDataArray[0] << 8) | l_byDataArray[1]) / 65536.0);
+    //RH = -6 + 125 * S / 2^16
+    *p_piHumidityValue = -600 + (int16_t)((12500UL * (((l_byDataArray[0] << 8) | l_byDataArray[1]) & ~MEASURE_STATUS_BITS) + 32768) >> 16);
+
+    if (*p_piHumidityValue < 0) {
+        *p_piHumidityValue = -*p_piHumidityValue;
+    }
+
+    return true; 
+}
+
+/**
+*   Compute the saturation partial pressure (Antoine): PP = 10^(A - B / (T + C)), computed as 2^(log2(10) * (A - B / (T + C)))
+*   params: 
+*       p_iTemperatureValue:    temperature, hundredths of degree
+*   return:
+*       partial pressure, hundredths of mmHg
+*/
+uint32_t CHTU21::computePartialPressure(int16_t p_iTemperatureValue) {
+    uint32_t l_ulDenominator = p_iTemperatureValue + SENSOR_CONSTANT_C_CENTI;
+    int32_t l_lExponent;
+
+    //+log2(100): hundredths
+    l_lExponent = SENSOR_CONSTANT_A_LOG2_Q12 + LOG2_100_Q12 - (int32_t)((SENSOR_CONSTANT_B_LOG2_CENTI * 4096UL + l_ulDenominator / 2) / l_ulDenominator);
+
+    return exp2Q12(l_lExponent);
+}
+
+/**
+*   Compute the dew point: Td = B / (A - log10(RH * PP / 100)) - C. As log10(PP) = A - B / (T + C), 
+*   Td = B / (B / (T + C) - log10(RH / 100)) - C: the partial pressure rounding does not weigh on the result
+*   params: 
+*       p_iTemperatureValue:    temperature, hundredths of degree
+*       p_iHumidityValue:       relative humidity, hundredths of %RH
+*   return:
+*       dew point temperature, hundredths of degree
+*/
+int16_t CHTU21::computeDewPoint(int16_t p_iTemperatureValue, int16_t p_iHumidityValue) {
+    uint32_t l_ulDenominator = p_iTemperatureValue + SENSOR_CONSTANT_C_CENTI;
+    int32_t l_lLog10Humidity;
+    int32_t l_lDenominator;
+
+    //log10(RH / 100), RH in hundredths: 4 below 
+    l_lLog10Humidity = (int32_t)(((uint32_t)log2Q12(max(p_iHumidityValue, (int16_t)1)) * LOG10_2_Q16 + 32768) >> 16) - 4 * 4096;
+
+    //Q12
+    l_lDenominator = (int32_t)((SENSOR_CONSTANT_B_CENTI * 4096UL + l_ulDenominator / 2) / l_ulDenominator) - l_lLog10Humidity;
+
+    return (int16_t)((SENSOR_CONSTANT_B_CENTI * 4096L + l_lDenominator / 2) / l_lDenominator - SENSOR_CONSTANT_C_CENTI);
+}
+
+/**
+*   2^x in fixed point, table interpolation. Error is below 0.02%
+*   params: 
+*       p_lValue:           x, Q12. Below 31
+*   return:
+*       2^x, rounded
+*/
+uint32_t CHTU21::exp2Q12(int32_t p_lValue) {
+    int32_t l_lIntegerPart = p_lValue >> 12;
+    uint32_t l_ulFractionalPart = p_lValue & 0x0FFF;
+    uint32_t l_ulIndex = l_ulFractionalPart >> 7;
+    uint32_t l_ulMantissa;
+
+    l_ulMantissa = g_aulExp2Table[l_ulIndex] + (((g_aulExp2Table[l_ulIndex + 1] - g_aulExp2Table[l_ulIndex]) * (l_ulFractionalPart & 0x7F)) >> 7);
+
+    //mantissa is Q16
+    l_lIntegerPart -= 16;
+    if (l_lIntegerPart >= 0) {
+        return l_ulMantissa << l_lIntegerPart;
+    }
+    else if (l_lIntegerPart > -32) {
+        return (l_ulMantissa + (1UL << (-l_lIntegerPart - 1))) >> -l_lIntegerPart;
+    }
+
+    return 0;
+}
+
+/**
+*   log2(x) in fixed point, table interpolation. Error is below 0.0004, Q12 rounding included
+*   params: 
+*       p_ulValue:          x, not null
+*   return:
+*       log2(x), Q12
+*/
+int32_t CHTU21::log2Q12(uint32_t p_ulValue) {
+    int32_t l_lIntegerPart = 31 - __builtin_clz(p_ulValue);
+    uint32_t l_ulMantissa;
+    uint32_t l_ulIndex;
 
-    if (l_fCurrentHumidityValue < 0) {
-        l_fCurrentHumidityValue = l_fCurrentHumidityValue * -1.0;
+    //normalize to [1, 2), Q16 
+    l_ulMantissa = (l_lIntegerPart >= 16) ? (p_ulValue >> (l_lIntegerPart - 16)) : (p_ulValue << (16 - l_lIntegerPart));
+    l_ulMantissa &= 0xFFFF;
+    l_ulIndex = l_ulMantissa >> 11;
+
+    return (l_lIntegerPart << 12) + g_auiLog2Table[l_ulIndex] + 
+            (((g_auiLog2Table[l_ulIndex + 1] - g_auiLog2Table[l_ulIndex]) * (l_ulMantissa & 0x07FF) + 1024) >> 11);
+}
+
+/**
+*   Robust value of a burst: mean of the samples within p_uiMinDeviation, or OUTLIER_MAD_FACTOR median 
+*   absolute deviations, of the median (trimmed mean). Statistics cover all the samples
+*   params: 
+*       p_piValues:             samples, hundredths. Sorted on return
+*       p_uiCount:              samples count, not null
+*       p_uiMinDeviation:       deviation from the median always accepted, hundredths
+*       p_pstrctStatistics:     min, max, mean and standard deviation of the samples
+*       p_puiRejectedCount:     incremented by the rejected samples count
+*   return:
+*       filtered value, hundredths
+*/
+int16_t CHTU21::filterValues(int16_t *p_piValues, uint8_t p_uiCount, uint16_t p_uiMinDeviation, STRUCT_SENSOR_VALUE_STATISTICS *p_pstrctStatistics, uint8_t *p_puiRejectedCount) {
+    int16_t l_aiDeviations[MAX_SENSOR_OVERSAMPLING];
+    int16_t l_aiSortedDeviations[MAX_SENSOR_OVERSAMPLING];
+    int16_t l_iMedianValue;
+    uint32_t l_ulThreshold;
+    int32_t l_lSum = 0;
+    int32_t l_lKeptSum = 0;
+    uint8_t l_uiKeptCount = 0;
+    uint32_t l_ulSquaresSum = 0;
+    int32_t l_lDeviation;
+    uint8_t l_uiIndex;
+
+    sortValues(p_piValues, p_uiCount);
+    l_iMedianValue = (p_uiCount & 1) ? p_piValues[p_uiCount / 2] : (p_piValues[p_uiCount / 2 - 1] + p_piValues[p_uiCount / 2]) / 2;
+
+    for (l_uiIndex = 0; l_uiIndex < p_uiCount; l_uiIndex++) {
+        l_aiDeviations[l_uiIndex] = (p_piValues[l_uiIndex] >= l_iMedianValue) ? (p_piValues[l_uiIndex] - l_iMedianValue) : (l_iMedianValue - p_piValues[l_uiIndex]);
+        l_lSum += p_piValues[l_uiIndex];
     }
 
-    return l_fCurrentHumidityValue; 
+    //median absolute deviation
+    memcpy(l_aiSortedDeviations, l_aiDeviations, p_uiCount * sizeof(int16_t));
+    sortValues(l_aiSortedDeviations, p_uiCount);
+    l_ulThreshold = max((uint32_t)l_aiSortedDeviations[p_uiCount / 2] * OUTLIER_MAD_FACTOR, (uint32_t)p_uiMinDeviation);
+
+    for (l_uiIndex = 0; l_uiIndex < p_uiCount; l_uiIndex++) {
+        if ((uint32_t)l_aiDeviations[l_uiIndex] <= l_ulThreshold) {
+            l_lKeptSum += p_piValues[l_uiIndex];
+            l_uiKeptCount++;
+        } else {
+            (*p_puiRejectedCount)++;
+        }
+    }
+
+    p_pstrctStatistics->iMinValue = p_piValues[0];
+    p_pstrctStatistics->iMaxValue = p_piValues[p_uiCount - 1];
+    p_pstrctStatistics->iMeanValue = divideRounded(l_lSum, p_uiCount);
+
+    //sensor ranges keep the sum of squares within 32 bits: (165 degrees)^2 * MAX_SENSOR_OVERSAMPLING
+    for (l_uiIndex = 0; l_uiIndex < p_uiCount; l_uiIndex++) {
+        l_lDeviation = p_piValues[l_uiIndex] - p_pstrctStatistics->iMeanValue;
+        l_ulSquaresSum += (uint32_t)(l_lDeviation * l_lDeviation);
+    }
+    p_pstrctStatistics->uiStdDevValue = squareRoot(l_ulSquaresSum / p_uiCount);
+
+    //the median sample at least is kept
+    return divideRounded(l_lKeptSum, l_uiKeptCount);
+}
+
+/**
+*   Insertion sort, ascending. Bursts are a few samples long
+*   params: 
+*       p_piValues:             values
+*       p_uiCount:              values count
+*   return:
+*       NONE
+*/
+void CHTU21::sortValues(int16_t *p_piValues, uint8_t p_uiCount) {
+    uint8_t l_uiIndex;
+    uint8_t l_uiInsertIndex;
+    int16_t l_iValue;
+
+    for (l_uiIndex = 1; l_uiIndex < p_uiCount; l_uiIndex++) {
+        l_iValue = p_piValues[l_uiIndex];
+        for (l_uiInsertIndex = l_uiIndex; (l_uiInsertIndex > 0) && (p_piValues[l_uiInsertIndex - 1] > l_iValue); l_uiInsertIndex--) {
+            p_piValues[l_uiInsertIndex] = p_piValues[l_uiInsertIndex - 1];
+        }
+        p_piValues[l_uiInsertIndex] = l_iValue;
+    }
 }
 
+/**
+*   Signed division rounded to nearest
+*   params: 
+*       p_lDividend:            dividend
+*       p_uiDivisor:            divisor, not null
+*   return:
+*       quotient
+*/
+int16_t CHTU21::divideRounded(int32_t p_lDividend, uint8_t p_uiDivisor) {
+    return (int16_t)((p_lDividend >= 0) ? ((p_lDividend + p_uiDivisor / 2) / p_uiDivisor) : ((p_lDividend - p_uiDivisor / 2) / p_uiDivisor));
+}
 
 /**
-*   Read I2C register
+*   Integer square root, bit by bit
+*   params: 
+*       p_ulValue:              value
+*   return:
+*       floor of the square root
+*/
+uint16_t CHTU21::squareRoot(uint32_t p_ulValue) {
+    uint32_t l_ulRoot = 0;
+    uint32_t l_ulBit = 1UL << 30;
+
+    while (l_ulBit > p_ulValue) {
+        l_ulBit >>= 2;
+    }
+
+    while (l_ulBit != 0) {
+        if (p_ulValue >= l_ulRoot + l_ulBit) {
+            p_ulValue -= l_ulRoot + l_ulBit;
+            l_ulRoot = (l_ulRoot >> 1) + l_ulBit;
+        } else {
+            l_ulRoot >>= 1;
+        }
+        l_ulBit >>= 2;
+    }
+
+    return (uint16_t)l_ulRoot;
+}
+
+#ifdef _BENCHMARK_
+/**
+*   Log the duration of the fixed point computation of partial pressure and dew point. 48 cycles per us
+*   params: 
+*       NONE
+*   return:
+*       NONE
+*/
+void CHTU21::benchmarkMath() {
+    const uint16_t l_uiLoops = 1000;
+    uint32_t l_ulStartTime;
+    uint16_t l_uiIndex;
+    volatile uint32_t l_ulPartialPressureValue;
+    volatile int16_t l_iDewPointValue;
+
+    l_ulStartTime = micros();
+    for (l_uiIndex = 0; l_uiIndex < l_uiLoops; l_uiIndex++) {
+        l_ulPartialPressureValue = computePartialPressure(l_uiIndex * 3);
+        l_iDewPointValue = computeDewPoint(l_uiIndex * 3, 2000 + l_uiIndex * 6);
+    }
+    LOG_INFO_PRINTLN(LOG_PREFIX_CHTU21, "partial pressure + dew point (us x1000)", micros() - l_ulStartTime);
+}
+#endif
+
+/**
+*   Perform a measure in no hold master mode: the bus is released during the conversion while 
+*   the calling task sleeps
 *   params: 
 *       p_byDeviceAddr:         I2C address of the device
-*       p_byRegister:           register address to read
+*       p_byRegister:           trigger measure register (no hold master)
 *       p_byDataArray:          byte array to store the result of the reading
 *       p_byLengthToRead:       length to read
+*       p_uiConversionTimeMs:   conversion time
 *   return:
 *       true if register has been read. Otherwise false
 */
-bool CHTU21::readI2C(byte p_byDeviceAddr, byte p_byRegister, byte *p_pbyDataArray, byte p_byLengthToRead) {
-    Wire.beginTransmission(p_byDeviceAddr);
-    Wire.write(p_byRegister);
-    Wire.endTransmission(false);
-    Wire.requestFrom((int)p_byDeviceAddr, 3);
+bool CHTU21::readI2C(byte p_byDeviceAddr, byte p_byRegister, byte *p_pbyDataArray, byte p_byLengthToRead, uint16_t p_uiConversionTimeMs) {
+    CI2CMaster::ENM_STATUS l_enmStatus;
+    TickType_t l_xStartTick;
 
-    unsigned long l_timeoutCounter = millis();
-    
-    while (Wire.available() < p_byLengthToRead) {
-        if (millis() > (l_timeoutCounter + TIMEOUT_MILLISEC)) {
-            return false;
+    if ((l_enmStatus = startConversion(p_byDeviceAddr, p_byRegister)) != CI2CMaster::ENM_STATUS::SUCCEEDED) {
+        LOG_ERROR_PRINTLN(LOG_PREFIX_CHTU21, "startConversion", l_enmStatus);
+        return false;
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(p_uiConversionTimeMs));
+
+    //sensor NACKs the read request until conversion completes
+    l_xStartTick = xTaskGetTickCount();
+    while ((l_enmStatus = readConversion(p_byDeviceAddr, p_pbyDataArray, p_byLengthToRead)) == CI2CMaster::ENM_STATUS::NACK) {
+        if ((xTaskGetTickCount() - l_xStartTick) > pdMS_TO_TICKS(TIMEOUT_MILLISEC)) {
+            l_enmStatus = CI2CMaster::ENM_STATUS::TIMEOUT;
+            break;
         }
-    };
 
-    byte l_byDataCount = 0; 
-    for (l_byDataCount=0; l_byDataCount<p_byLengthToRead; l_byDataCount++) {
-       p_pbyDataArray[l_byDataCount] = Wire.read();
+        vTaskDelay(pdMS_TO_TICKS(CONVERSION_POLL_MS));
+    }
+
+    if (l_enmStatus != CI2CMaster::ENM_STATUS::SUCCEEDED) {
+        LOG_ERROR_PRINTLN(LOG_PREFIX_CHTU21, "readConversion", l_enmStatus);
+        return false;
     }
 
     return checkCRC((p_pbyDataArray[0] << 8) | p_pbyDataArray[1], p_pbyDataArray[2]);
 }
 
+/**
+*   Trigger a measure in no hold master mode 
+*   params: 
+*       p_byDeviceAddr:         I2C address of the device
+*       p_byRegister:           trigger measure register
+*   return:
+*       SUCCEEDED if the device acknowledged the command, cf CI2CMaster::ENM_STATUS
+*/
+CI2CMaster::ENM_STATUS CHTU21::startConversion(byte p_byDeviceAddr, byte p_byRegister) {
+    return m_i2cMaster.write(p_byDeviceAddr, &p_byRegister, 1, I2C_TIMEOUT_MILLISEC);
+}
+
+/**
+*   Read the result of a measure 
+*   params: 
+*       p_byDeviceAddr:         I2C address of the device
+*       p_byDataArray:          byte array to store the result of the reading
+*       p_byLengthToRead:       length to read
+*   return:
+*       NACK if the conversion is not completed yet, cf CI2CMaster::ENM_STATUS
+*/
+CI2CMaster::ENM_STATUS CHTU21::readConversion(byte p_byDeviceAddr, byte *p_pbyDataArray, byte p_byLengthToRead) {
+    return m_i2cMaster.read(p_byDeviceAddr, p_pbyDataArray, p_byLengthToRead, I2C_TIMEOUT_MILLISEC);
+}
+
 /**
 *   Write to I2C register
 *   params: 
@@ -176,16 +563,15 @@ bool CHTU21::readI2C(byte p_byDeviceAddr, byte p_byRegister, byte *p_pbyDataArra
 *       p_byDataArray:          byte array containing the data to write
 *       p_byLengthToWrite:      length to write
 *   return:
-*       true if register has been read. Otherwise false
+*       length written, 0 if the transaction failed
 */
 byte CHTU21::writeI2C(byte p_byDeviceAddr, byte* p_byDataArray, byte p_byLengthToWrite) {
-    Wire.beginTransmission(p_byDeviceAddr);
-    byte l_byDataWritten = Wire.write(p_byDataArray, p_byLengthToWrite);
-    Wire.endTransmission(false);
-    
-    return l_byDataWritten;
-}
+    if (m_i2cMaster.write(p_byDeviceAddr, p_byDataArray, p_byLengthToWrite, I2C_TIMEOUT_MILLISEC) != CI2CMaster::ENM_STATUS::SUCCEEDED) {
+        return 0;
+    }
 
+    return p_byLengthToWrite;
+}
 
 /**
 *   Verify CRC accuracy
@@ -196,23 +582,7 @@ byte CHTU21::writeI2C(byte p_byDeviceAddr, byte* p_byDataArray, byte p_byLengthT
 *       true if CRC calculated is equal to the one returned by the sensor 
 */
 boolean CHTU21::checkCRC(uint16_t p_uiMeasureValue, uint8_t p_uiCRCValue) {
-    
-    uint32_t p_uiPolynom = 0x988000; // x^8 + x^5 + x^4 + 1
-	uint32_t p_uiMsb     = 0x800000;
-	uint32_t p_uiMask    = 0xFF8000;
-	uint32_t p_uiResult  = (uint32_t)p_uiMeasureValue << 8; // Pad with zeros as specified in spec
-	
-	while( p_uiMsb != 0x80 ) {
-		
-		// Check if msb of current value is 1 and apply XOR mask
-		if( p_uiResult & p_uiMsb )
-			p_uiResult = ((p_uiResult ^ p_uiPolynom) & p_uiMask) | ( p_uiResult & ~p_uiMask);
-			
-		// Shift by one
-		p_uiMsb >>= 1;
-		p_uiMask >>= 1;
-		p_uiPolynom >>=1;
-	}
-	
-    return ((uint8_t)p_uiResult == p_uiCRCValue) ? true : false;
+    byte l_abyDataArray[2] = {(byte)(p_uiMeasureValue >> 8), (byte)(p_uiMeasureValue & 0xFF)};
+
+    return (CCRC8::compute(l_abyDataArray, 2) == p_uiCRCValue);
 }
@@ -20,8 +20,11 @@
 #define __CHTU21_H__
 
 #include <Arduino.h>
-#include <Wire.h>
-#include "logging.h"
+#include <FreeRTOS_SAMD21.h>
+#include "CI2CMaster.h"
+#include "CCRC8.h"
+#include "Global.h"
+#include "Logging.h"
 
 #define HTU21_ADDR          		0x40
 #define REG_TRIG_TEMP__HM   		0xE3
@@ -32,22 +35,49 @@
 #define REG_USER_READ       		0xE7
 #define REG_SOFT_RESET      		0xFE
 
-#define I2C_FREQUENCY       		4000000
+#define I2C_FREQUENCY       		400000
 
-#define TIMEOUT_MILLISEC    		100
+#define TIMEOUT_MILLISEC    		100			//conversion completion
+#define I2C_TIMEOUT_MILLISEC		10			//single bus transaction
 
-#define SENSOR_CONSTANT_A			8.1332
-#define SENSOR_CONSTANT_B			1762.39
-#define SENSOR_CONSTANT_C			235.66
+//user register resolution bits (bit 7 and bit 0), other bits are kept
+#define USER_REGISTER_RESOLUTION_MASK	0x81
 
-#define HTU21_CRC					0x131		
+#define CONVERSION_POLL_MS			2			//measure not ready yet (NACK): poll period
+#define RETRY_BACKOFF_MS			10			//first retry delay, doubled on each retry
+
+//Antoine constants (A=8.1332, B=1762.39, C=235.66), scaled for fixed point computation 
+#define SENSOR_CONSTANT_B_CENTI		176239		//B * 100
+#define SENSOR_CONSTANT_C_CENTI		23566		//C * 100
+#define SENSOR_CONSTANT_A_LOG2_Q12	110665		//A * log2(10) * 4096
+#define SENSOR_CONSTANT_B_LOG2_CENTI	585453		//B * log2(10) * 100
+#define LOG10_2_Q16					19728		//log10(2) * 65536
+#define LOG2_100_Q12				27213		//log2(100) * 4096
+
+#define MEASURE_STATUS_BITS			0x0003
 
 #define MAX_RETRIES					2
 
+//outlier rejection: samples farther from the burst median than OUTLIER_MAD_FACTOR median absolute deviations (~3 sigma),
+//and than a floor absorbing the quantization noise
+#define OUTLIER_MAD_FACTOR							4
+#define OUTLIER_MIN_TEMPERATURE_DEVIATION			30			//hundredths of degree
+#define OUTLIER_MIN_HUMIDITY_DEVIATION				100			//hundredths of %RH
+
 class CHTU21 {
 public:
-	boolean		init();
-    void 		i2cReceiveCallback(int p_iCountAvailable);
+	/**
+	 *	Resolution modes. Datasheet maximum conversion times, energy per measurement (temperature + humidity)
+	 *	at 3.3V / 450uA:
+	 *		RH12_T14:	T 50ms, RH 16ms		~98uJ		(default, best resolution)
+	 *		RH8_T12:	T 13ms, RH 3ms		~24uJ
+	 *		RH10_T13:	T 25ms, RH 5ms		~45uJ
+	 *		RH11_T11:	T 7ms, RH 8ms		~22uJ		(high rate / battery nodes)
+	 */
+	enum ENM_RESOLUTION {RH12_T14=0, RH8_T12, RH10_T13, RH11_T11};
+
+	boolean		init(ENM_RESOLUTION p_enmResolution);
+	boolean		interruptHandler();
 
 	struct STRUCT_SENSOR_VALUES {
 		float	fTemperatureValue;
@@ -56,13 +86,34 @@ public:
 		float	fDewPointTemperatureValue;
 	};
 
-	STRUCT_SENSOR_VALUES getSensorValues();
+	STRUCT_SENSOR_VALUES getSensorValues(uint8_t p_uiBurstCount = 1, STRUCT_SENSOR_STATISTICS *p_pstrctStatistics = NULL);
 
 private:
-	boolean		readI2C(byte p_byDeviceAddr, byte p_byRegister, byte *p_byDataArray, byte p_byLengthToRead);
+#ifdef PIO_UNIT_TESTING
+	friend class CHTU21Test;		//host tests, cf test/test_sensor_math
+#endif
+
+	ENM_RESOLUTION	m_enmResolution;
+	CI2CMaster		m_i2cMaster;
+
+	boolean		setResolution(ENM_RESOLUTION p_enmResolution);
+	boolean		readI2C(byte p_byDeviceAddr, byte p_byRegister, byte *p_byDataArray, byte p_byLengthToRead, uint16_t p_uiConversionTimeMs);
+	CI2CMaster::ENM_STATUS	startConversion(byte p_byDeviceAddr, byte p_byRegister);
+	CI2CMaster::ENM_STATUS	readConversion(byte p_byDeviceAddr, byte *p_byDataArray, byte p_byLengthToRead);
     byte 		writeI2C(byte p_byDeviceAddr, byte* p_byDataArray, byte p_byLengthToWrite);
-	float 		readTemperatureValue();
-	float 		readHumidityValue();
+	boolean		readTemperatureValue(int16_t *p_piTemperatureValue);
+	boolean		readHumidityValue(int16_t *p_piHumidityValue);
+	uint32_t	computePartialPressure(int16_t p_iTemperatureValue);
+	int16_t		computeDewPoint(int16_t p_iTemperatureValue, int16_t p_iHumidityValue);
+	uint32_t	exp2Q12(int32_t p_lValue);
+	int32_t		log2Q12(uint32_t p_ulValue);
+	int16_t		filterValues(int16_t *p_piValues, uint8_t p_uiCount, uint16_t p_uiMinDeviation, STRUCT_SENSOR_VALUE_STATISTICS *p_pstrctStatistics, uint8_t *p_puiRejectedCount);
+	void		sortValues(int16_t *p_piValues, uint8_t p_uiCount);
+	int16_t		divideRounded(int32_t p_lDividend, uint8_t p_uiDivisor);
+	uint16_t	squareRoot(uint32_t p_ulValue);
+#ifdef _BENCHMARK_
+	void		benchmarkMath();
+#endif
 	boolean		checkCRC(uint16_t p_uiMeasureValue, uint8_t p_uiCRCValue);
 };
 
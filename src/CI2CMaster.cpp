@@ -0,0 +1,239 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#include "CI2CMaster.h"
+#include "wiring_private.h"
+
+/****************************************************************************************
+ * 
+ *     *****    *     *     *****       *         *****       **** 
+ *     *    *   *     *     *    *      *           *       *     
+ *     * * *    *     *     *  *        *           *      *       
+ *     *        *     *     *    *      *           *       *        
+ *     *         * * *      ******      ******    *****       ****        
+ *    
+ * **************************************************************************************/
+
+/**
+*   Set the SERCOM in I2C master mode and route the Wire pins to it
+*   params: 
+*       p_ulFrequency:      SCL frequency (Hz)
+*   return:
+*       NONE
+*/
+void CI2CMaster::init(uint32_t p_ulFrequency) {
+    //clock, baud rate and NVIC line
+    PERIPH_WIRE.initMasterWIRE(p_ulFrequency);
+    PERIPH_WIRE.enableWIRE();
+
+    pinPeripheral(PIN_WIRE_SDA, g_APinDescription[PIN_WIRE_SDA].ulPinType);
+    pinPeripheral(PIN_WIRE_SCL, g_APinDescription[PIN_WIRE_SCL].ulPinType);
+
+    m_bCompleted = true;
+}
+
+/**
+*   Write bytes to a device, then stop
+*   params: 
+*       p_byDeviceAddr:     I2C address of the device
+*       p_pbyDataArray:     bytes to write. May be empty: address probe
+*       p_byLength:         length to write
+*       p_uiTimeoutMs:      transaction timeout
+*   return:
+*       SUCCEEDED, NACK if the address or a byte was not acknowledged, BUS_ERROR or TIMEOUT
+*/
+CI2CMaster::ENM_STATUS CI2CMaster::write(byte p_byDeviceAddr, const byte *p_pbyDataArray, byte p_byLength, uint16_t p_uiTimeoutMs) {
+    return transfer(p_byDeviceAddr, (byte *)p_pbyDataArray, p_byLength, false, p_uiTimeoutMs);
+}
+
+/**
+*   Read bytes from a device, the last one not acknowledged, then stop
+*   params: 
+*       p_byDeviceAddr:     I2C address of the device
+*       p_pbyDataArray:     bytes read
+*       p_byLength:         length to read, not null
+*       p_uiTimeoutMs:      transaction timeout
+*   return:
+*       SUCCEEDED, NACK if the address was not acknowledged, BUS_ERROR or TIMEOUT
+*/
+CI2CMaster::ENM_STATUS CI2CMaster::read(byte p_byDeviceAddr, byte *p_pbyDataArray, byte p_byLength, uint16_t p_uiTimeoutMs) {
+    if (p_byLength == 0) {
+        return ENM_STATUS::BUS_ERROR;
+    }
+
+    return transfer(p_byDeviceAddr, p_pbyDataArray, p_byLength, true, p_uiTimeoutMs);
+}
+
+/**
+*   To be called from the SERCOM interrupt: send or receive the next byte, end the transaction on 
+*   completion or error
+*   params: 
+*       NONE
+*   return:
+*       true if the transaction is over: the calling task has to be notified
+*/
+boolean CI2CMaster::interruptHandler() {
+    Sercom *l_pSercom = I2C_MASTER_SERCOM;
+    uint8_t l_uiFlags = l_pSercom->I2CM.INTFLAG.reg;
+
+    //no transaction pending: late interrupt of a timed out transaction
+    if (m_bCompleted) {
+        l_pSercom->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MB | SERCOM_I2CM_INTENCLR_SB | SERCOM_I2CM_INTENCLR_ERROR;
+        l_pSercom->I2CM.INTFLAG.reg = l_uiFlags;
+        return false;
+    }
+
+    //bus error or arbitration lost: the bus is not ours anymore, no stop condition
+    if ((l_uiFlags & SERCOM_I2CM_INTFLAG_ERROR) || l_pSercom->I2CM.STATUS.bit.BUSERR || l_pSercom->I2CM.STATUS.bit.ARBLOST) {
+        l_pSercom->I2CM.INTFLAG.reg = l_uiFlags;
+        return complete(ENM_STATUS::BUS_ERROR);
+    }
+
+    //master on bus: address or byte sent
+    if (l_uiFlags & SERCOM_I2CM_INTFLAG_MB) {
+        //MB is raised on read transactions only if the address was not acknowledged
+        if (l_pSercom->I2CM.STATUS.bit.RXNACK || m_bRead) {
+            sendCommand(I2C_MASTER_CMD_STOP, false);
+            return complete(ENM_STATUS::NACK);
+        }
+
+        if (m_byIndex < m_byLength) {
+            l_pSercom->I2CM.DATA.reg = m_pbyDataArray[m_byIndex++];
+            return false;
+        }
+
+        sendCommand(I2C_MASTER_CMD_STOP, false);
+        return complete(ENM_STATUS::SUCCEEDED);
+    }
+
+    //slave on bus: byte received. Read before the command, which starts the next byte reception
+    if (l_uiFlags & SERCOM_I2CM_INTFLAG_SB) {
+        m_pbyDataArray[m_byIndex++] = l_pSercom->I2CM.DATA.reg;
+
+        if (m_byIndex >= m_byLength) {
+            sendCommand(I2C_MASTER_CMD_STOP, true);
+            return complete(ENM_STATUS::SUCCEEDED);
+        }
+
+        sendCommand(I2C_MASTER_CMD_READ, false);
+    }
+
+    return false;
+}
+
+/****************************************************************************************
+ * 
+ *     *****    *****      ***     *       *     *****      *******     ******   
+ *     *    *   *    *      *       *     *     *     *        *        *
+ *     * * *    * * *       *        *   *      * *** *        *        ******
+ *     *        *    *      *         * *       *     *        *        *
+ *     *        *     *    ***         *        *     *        *        ******
+ *   
+ * **************************************************************************************/
+
+/**
+*   Start a transaction and sleep until it is over
+*   params: 
+*       p_byDeviceAddr:     I2C address of the device
+*       p_pbyDataArray:     bytes to write or read
+*       p_byLength:         length
+*       p_bRead:            read transaction
+*       p_uiTimeoutMs:      transaction timeout
+*   return:
+*       transaction status
+*/
+CI2CMaster::ENM_STATUS CI2CMaster::transfer(byte p_byDeviceAddr, byte *p_pbyDataArray, byte p_byLength, boolean p_bRead, uint16_t p_uiTimeoutMs) {
+    Sercom *l_pSercom = I2C_MASTER_SERCOM;
+    TickType_t l_xStartTick;
+    TickType_t l_xElapsedTicks;
+
+    m_pbyDataArray = p_pbyDataArray;
+    m_byLength = p_byLength;
+    m_byIndex = 0;
+    m_bRead = p_bRead;
+    m_enmStatus = ENM_STATUS::SUCCEEDED;
+    m_bCompleted = false;
+
+    //drop a notification left by a former transaction
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    l_pSercom->I2CM.INTFLAG.reg = SERCOM_I2CM_INTFLAG_MB | SERCOM_I2CM_INTFLAG_SB | SERCOM_I2CM_INTFLAG_ERROR;
+    l_pSercom->I2CM.INTENSET.reg = SERCOM_I2CM_INTENSET_MB | SERCOM_I2CM_INTENSET_SB | SERCOM_I2CM_INTENSET_ERROR;
+
+    //start condition, address and direction
+    l_pSercom->I2CM.CTRLB.bit.ACKACT = 0;
+    l_pSercom->I2CM.ADDR.bit.ADDR = (p_byDeviceAddr << 1) | (p_bRead ? 1 : 0);
+    while (l_pSercom->I2CM.SYNCBUSY.bit.SYSOP);
+
+    //sleep during bus activity
+    l_xStartTick = xTaskGetTickCount();
+    while (!m_bCompleted) {
+        l_xElapsedTicks = xTaskGetTickCount() - l_xStartTick;
+        if (l_xElapsedTicks >= pdMS_TO_TICKS(p_uiTimeoutMs)) {
+            break;
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(p_uiTimeoutMs) - l_xElapsedTicks);
+    }
+
+    if (!m_bCompleted) {
+        //device holding the bus, or interrupt lost: release the bus and force the idle state
+        l_pSercom->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MB | SERCOM_I2CM_INTENCLR_SB | SERCOM_I2CM_INTENCLR_ERROR;
+        m_bCompleted = true;
+
+        sendCommand(I2C_MASTER_CMD_STOP, true);
+        l_pSercom->I2CM.STATUS.bit.BUSSTATE = I2C_MASTER_BUS_STATE_IDLE;
+        while (l_pSercom->I2CM.SYNCBUSY.bit.SYSOP);
+
+        return ENM_STATUS::TIMEOUT;
+    }
+
+    return m_enmStatus;
+}
+
+/**
+*   Issue a bus command
+*   params: 
+*       p_byCommand:        I2C_MASTER_CMD_READ or I2C_MASTER_CMD_STOP
+*       p_bNack:            not acknowledge the last byte read
+*   return:
+*       NONE
+*/
+void CI2CMaster::sendCommand(byte p_byCommand, boolean p_bNack) {
+    Sercom *l_pSercom = I2C_MASTER_SERCOM;
+
+    l_pSercom->I2CM.CTRLB.bit.ACKACT = p_bNack ? 1 : 0;
+    l_pSercom->I2CM.CTRLB.bit.CMD = p_byCommand;
+    while (l_pSercom->I2CM.SYNCBUSY.bit.SYSOP);
+}
+
+/**
+*   End the transaction, from the interrupt
+*   params: 
+*       p_enmStatus:        transaction status
+*   return:
+*       true
+*/
+boolean CI2CMaster::complete(ENM_STATUS p_enmStatus) {
+    I2C_MASTER_SERCOM->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MB | SERCOM_I2CM_INTENCLR_SB | SERCOM_I2CM_INTENCLR_ERROR;
+
+    m_enmStatus = p_enmStatus;
+    m_bCompleted = true;
+
+    return true;
+}
@@ -0,0 +1,59 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#ifndef __CI2CMASTER_H__
+#define __CI2CMASTER_H__
+
+#include <Arduino.h>
+#include <FreeRTOS_SAMD21.h>
+
+//Seeed XIAO: SDA (PA08) and SCL (PA09) on SERCOM2, cf variant PERIPH_WIRE and WIRE_IT_HANDLER
+#define I2C_MASTER_SERCOM               SERCOM2
+#define I2C_MASTER_BUS_STATE_IDLE       1
+#define I2C_MASTER_CMD_READ             2       //acknowledge action, then read a byte
+#define I2C_MASTER_CMD_STOP             3       //acknowledge action, then stop condition
+
+/**
+ *  Interrupt driven I2C master transactions on the Wire SERCOM, in place of the busy-waiting Wire library.
+ *  The calling task sleeps until the transaction is over: interruptHandler() has to be called from the 
+ *  SERCOM interrupt (WIRE_IT_HANDLER), and the calling task notified when it returns true.
+ *  One transaction at a time, from a single task.
+ */
+class CI2CMaster {
+public:
+    enum ENM_STATUS {SUCCEEDED = 0, NACK, BUS_ERROR, TIMEOUT};
+
+    void        init(uint32_t p_ulFrequency);
+    ENM_STATUS  write(byte p_byDeviceAddr, const byte *p_pbyDataArray, byte p_byLength, uint16_t p_uiTimeoutMs);
+    ENM_STATUS  read(byte p_byDeviceAddr, byte *p_pbyDataArray, byte p_byLength, uint16_t p_uiTimeoutMs);
+    boolean     interruptHandler();
+
+private:
+    byte                    *m_pbyDataArray;
+    byte                    m_byLength;
+    byte                    m_byIndex;
+    boolean                 m_bRead;
+    volatile ENM_STATUS     m_enmStatus;
+    volatile boolean        m_bCompleted = true;
+
+    ENM_STATUS  transfer(byte p_byDeviceAddr, byte *p_pbyDataArray, byte p_byLength, boolean p_bRead, uint16_t p_uiTimeoutMs);
+    void        sendCommand(byte p_byCommand, boolean p_bNack);
+    boolean     complete(ENM_STATUS p_enmStatus);
+};
+
+#endif
@@ -14,6 +14,10 @@
 //#define _DEVELOP_
 #undef _DEVELOP_
 
+//toogle directive below to enable or disable benchmarks reported into the logs at startup
+//#define _BENCHMARK_
+#undef _BENCHMARK_
+
 //toogle directive below to enable or disable bridge mode=server mode
 #define BRIDGE_MODE
 //#undef BRIDGE_MODE
@@ -30,6 +34,8 @@
         //default settings to use during development 
         #define _RADIO_DEVELOP_DEVICE_ADDR_                 1
         #define _RADIO_DEVELOP_KEEPALIVE_TIMEOUT            1      //minutes
+        #define _RADIO_DEVELOP_HOPPING_DWELL_TIME_          0      //seconds, 0: no hopping
+        #define _RADIO_DEVELOP_FEC_MODE_                    0      //0: off, 1: on, 2: on request
         #define _BRIDGE_DEVELOP_HOSTNAME_                   "<API_URI_WITHOUT_HTTPS>"   
         #define _BRIDGE_DEVELOP_PORT_                       443    
         #define _BRIDGE_DEVELOP_URI_                        "/device"  
@@ -38,6 +44,7 @@
         #define _BRIDGE_DEVELOP_AP_SSID_                    "ACCESS_POINT_SSID"        
         #define _BRIDGE_DEVELOP_AP_KEY_                     "ACCESS_POINT_KEY"     
         #define _BRIDGE_DEVELOP_KEEPALIVE_TIMEOUT_          10       //minutes    
+        #define _BRIDGE_DEVELOP_OUTBOX_RETENTION_           24       //hours, 0: readings kept until overwritten
         #define _MISCELLANEOUS_READ_SENSOR_VALUES_TIMEOUT_  10      //minutes
     #else
         #define RADIO_SERVER_ID                         1
@@ -53,7 +60,6 @@
     #define MAX_MAC_ADDR_LENGTH                         20    
 
     #define API_URI_POST_SENSOR_VALUES                  "/sensor-values" 
-    #define API_URI_POST_KEEP_ALIVE_DEVICE              "/keep-alive-device" 
     #define API_URI_POST_KEEP_ALIVE_SERVER              "/keep-alive-server" 
 #else
     #undef BRIDGE_SERVER
@@ -66,12 +72,21 @@
         #define _RADIO_DEVELOP_SERVER_ADDR_                 1
         #define _RADIO_DEVELOP_KEEPALIVE_TIMEOUT            1       //minutes
         #define _MISCELLANEOUS_READ_SENSOR_VALUES_TIMEOUT_  1       //minutes
+        #define _RADIO_DEVELOP_AGGREGATED_SAMPLES_          1       //1: each reading is sent on its own
     #endif
 #endif
 
 #ifdef _DEVELOP_
     #define _RADIO_MSG_SIGNATURE                            0x52E3  
     #define _MAX_RADIO_RETRIES_                             3
+    #define _RADIO_DEVELOP_CHANNEL_                         1
+    #define _MISCELLANEOUS_TEMPERATURE_DEAD_BAND_           0       //hundredths of degree, 0: every reading is sent
+    #define _MISCELLANEOUS_HUMIDITY_DEAD_BAND_              0       //hundredths of %RH, 0: every reading is sent
+    #define _MISCELLANEOUS_MAX_SILENCE_INTERVAL_            0       //minutes, 0: no maximum
+    #define _MISCELLANEOUS_MIN_MEASUREMENT_INTERVAL_        0       //seconds, 0: fixed measurement timeout
+    #define _MISCELLANEOUS_MAX_MEASUREMENT_INTERVAL_        0       //seconds, 0: fixed measurement timeout
+    #define _MISCELLANEOUS_SENSOR_RESOLUTION_               0       //cf CHTU21::ENM_RESOLUTION
+    #define _MISCELLANEOUS_SENSOR_OVERSAMPLING_             1       //1: one sample per measurement
 #endif
 
 #define _WEB_USB_LANDING_PAGE                           "device-settings.gepeo.fr/index.html"
@@ -84,10 +99,22 @@
 #define BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_SAVE_SETTINGS                    (1 << 1)
 #define BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_BRIDGE_ERASE_WIFI_PARAMS         (1 << 2)
 #define BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_SENSOR_VALUES_MEASUREMENT        (1 << 3)            //measure but does not send to API server
+#define BIT_EVENT_GROUP_MISCELLANEOUS__RELOAD_SENSOR_SETTINGS                   (1 << 4)            //sensor settings changed by a downlink command
 
 //FLASH settings saving signature
-#define FLASH_STORAGE_SIGNATURE_ID                      0xB5E3
+#define FLASH_STORAGE_SIGNATURE_ID                      0xB5EB
 #define MAX_RADIO_DEVICES                               127
+#define MAX_RADIO_CHANNEL                               247         //home channel + the 7 following ones used by hopping fit into CHANNR
+#define RADIO_SENSOR_VALUES_LENGTH                      8           //temperature, humidity, partial pressure and dew point, quotient and remainder each
+#define MAX_RADIO_AGGREGATED_SAMPLES                    24          //delta coded readings take about 5 bytes, cf CSamplesCodec
+#define RADIO_RETRY_MIN_DELAY                           2           //sec, first retry of undelivered readings, doubled at each failure
+#define RADIO_RETRY_MAX_DELAY                           300         //sec
+#define RADIO_CONGESTION_THRESHOLD                      25          //percent of the bridge upload pipeline from which devices are asked to hold off
+#define RADIO_CONGESTION_MAX_HOLD_OFF                   60          //sec, hold-off requested with a full pipeline
+#define RADIO_DOWNLINK_QUEUE_LENGTH                     16          //downlink commands pending on the bridge, all devices together
+#define RADIO_DOWNLINK_MAX_COMMANDS                     2           //commands carried by an acknowledge, fits into the FEC profile packet
+#define MAX_SENSOR_OVERSAMPLING                         9           //samples of a measurement burst
+#define FLASH_LOG_ROWS                                  32          //node data logger, readings the outbox cannot hold: NVM rows of 256 bytes, 16 readings each
 
 enum ENM_AT_CALLBACK {
     SAVE_SETTINGS,
@@ -96,9 +123,48 @@ enum ENM_AT_CALLBACK {
 
 enum ENM_RADIO_MSG_TYPE {
     POST_SENSOR_VALUES = 0,
-    KEEP_ALIVE
+    KEEP_ALIVE,
+    POST_SENSOR_VALUES_AGGREGATED,          //delta coded readings, cf CSamplesCodec
+    POST_SENSOR_VALUES_STATISTICS           //POST_SENSOR_VALUES data followed by STRUCT_SENSOR_STATISTICS
+};
+
+//settings changed remotely, cf STRUCT_RADIO_DOWNLINK_COMMAND
+enum ENM_RADIO_DOWNLINK_COMMAND {
+    SET_MEASUREMENT_TIMEOUT = 1,            //min, cf STRUCT_MISCELLANEOUS_SETTINGS::uiReadSensorValuesMeasurementTimeout
+    SET_OUTPUT_POWER,                       //cf CCC1100::ENM_OUTPUT_POWER_DBM
+    SET_TEMPERATURE_DEAD_BAND,              //hundredths of degree
+    SET_HUMIDITY_DEAD_BAND,                 //hundredths of %RH
+    SET_MAX_SILENCE_INTERVAL                //min
 };
 
+//spread of one quantity over a measurement burst, hundredths
+struct STRUCT_SENSOR_VALUE_STATISTICS {
+    int16_t     iMinValue;
+    int16_t     iMaxValue;
+    int16_t     iMeanValue;
+    uint16_t    uiStdDevValue;
+} __attribute__ ((packed));     //non aligment pragma
+
+struct STRUCT_SENSOR_STATISTICS {
+    uint8_t                             uiSamplesCount;         //valid samples of the burst, 0: no statistics
+    uint8_t                             uiRejectedCount;        //outliers left out of the reported temperature and humidity
+    STRUCT_SENSOR_VALUE_STATISTICS      strctTemperature;
+    STRUCT_SENSOR_VALUE_STATISTICS      strctHumidity;
+} __attribute__ ((packed));     //non aligment pragma
+
+//command queued by the bridge for a device, carried by the acknowledge of the device next message
+struct STRUCT_RADIO_DOWNLINK_COMMAND {
+    uint8_t     uiSequence;                 //given by the bridge, never 0. Sent back by the device once applied
+    uint8_t     uiCommand;                  //cf ENM_RADIO_DOWNLINK_COMMAND
+    uint16_t    uiValue;
+} __attribute__ ((packed));     //non aligment pragma
+
+//one reading of an aggregated frame
+struct STRUCT_RADIO_AGGREGATED_SAMPLE {
+    byte        abySensorValues[RADIO_SENSOR_VALUES_LENGTH];    //same layout as POST_SENSOR_VALUES data
+    uint16_t    uiTimeOffset;                                   //seconds elapsed between the reading and the frame sending
+} __attribute__ ((packed));     //non aligment pragma
+
 #ifdef BRIDGE_MODE
     struct STRUCT_WIFI_STATUS {
         char        cIP[MAX_IP_ADDR_LENGTH];
@@ -119,6 +185,7 @@ enum ENM_RADIO_MSG_TYPE {
         char        cClientID[MAX_CLIENT_ID_LENGTH];
         char        cAuthorizationToken[MAX_AUTHORIZATION_LENGTH];
         uint8_t     uiKeepAliveTimeout;     //minutes
+        uint16_t    uiOutboxRetention;      //hours, older readings of the outbox are dropped. 0: kept until overwritten
     } __attribute__ ((packed));     //non aligment pragma
 
     struct STRUCT_BRIDGE_SETTINGS {
@@ -129,6 +196,29 @@ enum ENM_RADIO_MSG_TYPE {
 
 struct STRUCT_MISCELLANEOUS_SETTINGS {
     uint16_t    uiReadSensorValuesMeasurementTimeout;       //min
+    uint16_t    uiTemperatureDeadBand;                      //hundredths of degree, 0: every change is sent. Both dead-bands at 0: every reading is sent
+    uint16_t    uiHumidityDeadBand;                         //hundredths of %RH, 0: every change is sent
+    uint16_t    uiMaxSilenceInterval;                       //min, reading sent even within dead-bands. 0: no maximum
+    uint16_t    uiMinMeasurementInterval;                   //sec, adaptive measurement interval bounds. 0: fixed measurement timeout
+    uint16_t    uiMaxMeasurementInterval;                   //sec
+    uint8_t     uiSensorResolution;                         //cf CHTU21::ENM_RESOLUTION
+    uint8_t     uiOversamplingCount;                        //samples per measurement, filtered. 1: no oversampling
+} __attribute__ ((packed));     //non aligment pragma
+
+#define ADAPTIVE_INTERVAL_TEMPERATURE_STEP                  10          //hundredths of degree, used when no temperature dead-band is set
+#define ADAPTIVE_INTERVAL_HUMIDITY_STEP                     50          //hundredths of %RH, used when no humidity dead-band is set
+
+struct STRUCT_MISCELLANEOUS_STATUS {
+    uint32_t    ulSuppressedReadings;                       //readings not sent, within dead-bands
+    uint16_t    uiMeasurementInterval;                      //sec, current measurement interval
+    uint16_t    uiLoggedReadings;                           //readings logged into flash, not delivered yet
+#ifdef BRIDGE_MODE
+    uint16_t    uiOutboxDepth;                              //readings waiting in the bridge outbox
+    uint32_t    ulOutboxAge;                                //sec, age of the oldest reading waiting in the outbox
+    uint8_t     uiDownlinkPending;                          //downlink commands not confirmed by their device yet
+    uint8_t     uiAliveDevices;                             //devices heard during the last keep-alive period
+    uint8_t     uiLostDevices;                              //devices silent for DEVICE_LIVENESS_LOST_PERIODS keep-alive periods
+#endif
 } __attribute__ ((packed));     //non aligment pragma
     
 struct STRUCT_RADIO_SETTINGS {
@@ -140,6 +230,28 @@ struct STRUCT_RADIO_SETTINGS {
     uint8_t     uiOutputPower;              //cf CCC1100::ENM_OUTPUT_POWER_DBM
     uint8_t     uiKeepAliveTimeout;         //minutes
     uint16_t    uiMessageSignature;
+    uint8_t     uiChannel;                  //home channel
+#ifdef BRIDGE_MODE
+    uint8_t     uiHoppingDwellTime;         //seconds, 0: no hopping. Devices learn it from the bridge
+    uint8_t     uiFECMode;                  //cf CCC1100::ENM_FEC_MODE. Devices learn the profile from the bridge
+#else
+    uint8_t     uiAggregatedSamples;        //readings sent together, 1: each reading is sent on its own
+#endif
+} __attribute__ ((packed));     //non aligment pragma
+
+#define RADIO_LINK_PROFILES_COUNT       2           //cf CCC1100::ENM_LINK_PROFILE
+
+struct STRUCT_RADIO_LINK_STATS {
+    uint16_t    uiPosted;                   //messages handed to the radio, once per profile tried. Always 0 on the bridge
+    uint16_t    uiDelivered;                //messages acknowledged, or received on the bridge
+    uint32_t    ulRetries;                  //transmissions following the first one of a message, hopping scan included
+} __attribute__ ((packed));     //non aligment pragma
+
+struct STRUCT_RADIO_STATUS {
+    uint8_t                     uiCurrentChannel;
+    uint8_t                     uiChannelBlacklist;         //bit n set if index n of the hopping sequence is blacklisted
+    uint8_t                     uiLinkProfile;              //cf CCC1100::ENM_LINK_PROFILE
+    STRUCT_RADIO_LINK_STATS     astrctLinkStats[RADIO_LINK_PROFILES_COUNT];
 } __attribute__ ((packed));     //non aligment pragma
 
 struct STRUCT_GLOBAL_SETTINGS_AND_STATUS {
@@ -150,6 +262,8 @@ struct STRUCT_GLOBAL_SETTINGS_AND_STATUS {
 #endif
     STRUCT_RADIO_SETTINGS           strctRadioSettings;
     STRUCT_MISCELLANEOUS_SETTINGS   strctMiscellaneousSettings;
+    STRUCT_RADIO_STATUS             strctRadioStatus;
+    STRUCT_MISCELLANEOUS_STATUS     strctMiscellaneousStatus;
 } __attribute__ ((packed));     //non aligment pragma
 
 struct STRUCT_FLASH_SETTINGS {
@@ -162,8 +276,7 @@ struct STRUCT_FLASH_SETTINGS {
 
 enum ENM_X_QUEUE_POST_MSG_TYPE {
     POST_DEVICE_SENSOR_VALUES = 0,
-    POST_BRIDGE_KEEP_ALIVE,
-    POST_DEVICE_KEEP_ALIVE
+    POST_BRIDGE_KEEP_ALIVE
 };
 
 struct STRUCT_X_QUEUE_SENSOR_VALUES {
@@ -176,15 +289,10 @@ struct STRUCT_X_QUEUE_SENSOR_VALUES {
     byte        byPartialPressureRemaindertValue;   
     byte        byDewPointeQuotientValue;
     byte        byDewPointRemaindertValue;  
-       
+    uint32_t    ulSampleAge;                //seconds elapsed since the reading, readings aggregated by devices or replayed from the outbox
+    STRUCT_SENSOR_STATISTICS    strctStatistics;    //measurement burst, cf CHTU21::getSensorValues
 } __attribute__ ((packed));     //non aligment pragma
 
-struct STRUCT_X_QUEUE_DEVICE_KEEP_ALIVE {
-    uint8_t     uiDeviceId;
-    //aligment with STRUCT_X_QUEUE_SENSOR_VALUES Size
-    uint8_t     uiDummy[sizeof(STRUCT_X_QUEUE_SENSOR_VALUES) - sizeof(uint8_t)];       
-};
-
 struct STRUCT_X_QUEUE_DUMMY {
     //aligment with STRUCT_X_QUEUE_SENSOR_VALUES Size
     uint8_t     uiDummy[sizeof(STRUCT_X_QUEUE_SENSOR_VALUES)];       
@@ -194,7 +302,6 @@ struct STRUCT_X_QUEUE_POST_MSG {
     ENM_X_QUEUE_POST_MSG_TYPE                   enmMsgType;
     union {
         STRUCT_X_QUEUE_SENSOR_VALUES            strctSensorValues;
-        STRUCT_X_QUEUE_DEVICE_KEEP_ALIVE        strctDeviceKeepAlive;
         STRUCT_X_QUEUE_DUMMY                    strctDummy;
         uint8_t                                 uiData[sizeof(STRUCT_X_QUEUE_SENSOR_VALUES)];
     };          
@@ -83,64 +83,56 @@ boolean CBridge::poll() {
         return false;
     }
 
-#ifdef BRIGE_SERVER
-    //example only
-    if (m_C8266Drv.getServerMode() == CESP8266::ENM_SERVER_MODE::SERVER_MODE_ENABLED_PASSIVE) {
+#ifdef BRIDGE_SERVER
+    //local query API on the latest readings of the devices, cf CDeviceCache:
+    //  GET /devices                    devices with a reading, e.g. {"devices":"3,5,12"}
+    //  GET /devices?device_addr=12     latest reading of a device, with its age and link quality
+    if ((m_pDeviceCache != NULL) && (m_C8266Drv.getServerMode() == CESP8266::ENM_SERVER_MODE::SERVER_MODE_ENABLED_PASSIVE)) {
 
         if ((m_pstrctRequest = m_C8266Drv.available()) != NULL) {
 
           CESP8266::STRCT_RESPONSE_HEADER l_strctHeader;
+          CDeviceCache::STRUCT_DEVICE_CACHE_ENTRY l_strctEntry;
+          uint8_t l_uiDeviceId;
+          boolean l_bListEmpty = true;
+
           l_strctHeader.enmStatusCode = CESP8266::ENM_REST_STATUS_CODE::NOT_FOUND;
-          strcpy(l_strctHeader.pcContentType, "");
-
-          LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "Verb", m_pstrctRequest->header.enmMethod);
-          LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "URI", m_pstrctRequest->header.pcUri);
-          LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "Authorization", m_pstrctRequest->header.pcAuthorization);
-          LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "Content-Type", m_pstrctRequest->header.pcContentType);
-          LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "Host", m_pstrctRequest->header.pcHost);
-
-          LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "Json ", m_pstrctRequest->pData);
-          
-          /////to be removed
-          char l_value[128];
-
-          switch (m_pstrctRequest->header.enmMethod) {
-            case CESP8266::ENM_REST_METHOD::POST:
-              if (strncmp(m_pstrctRequest->header.pcUri, "/test", MAX_URI_LENGTH) == 0) {
-                l_strctHeader.enmStatusCode = CESP8266::ENM_REST_STATUS_CODE::OK;
-                strcpy(l_strctHeader.pcContentType , "application/json; charset=utf-8");
+          strcpy(l_strctHeader.pcContentType, "application/json; charset=utf-8");
+          m_toolBufferLargeMiscellaneous.start("{}");
 
-                m_C8266Drv.getJSONValue(m_pstrctRequest->pData, "name", &l_value[0]);
-                LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "name", l_value);
+          LOG_DEBUG_PRINTLN(LOG_PREFIX_BRIDGE, "URI", m_pstrctRequest->header.pcUri);
 
-                m_C8266Drv.sendResponse(l_strctHeader, "{\"value\":\"response2\"}");
-                break;
-              }
-            break;
+          if (m_pstrctRequest->header.enmMethod != CESP8266::ENM_REST_METHOD::GET) {
+            l_strctHeader.enmStatusCode = CESP8266::ENM_REST_STATUS_CODE::METHOD_NOT_ALLOWED;
+          } else if (m_C8266Drv.indexOf(m_pstrctRequest->header.pcUri, "/devices?", 0, MAX_URI_LENGTH) == 0) {
+            if (m_C8266Drv.getUriParam(m_pstrctRequest->header.pcUri, "device_addr", m_toolBufferTinyMiscellaneous.getBuffer())) {
+              l_uiDeviceId = constrain(atoi(m_toolBufferTinyMiscellaneous.getBuffer()), 0, MAX_RADIO_DEVICES);
 
-            case CESP8266::ENM_REST_METHOD::GET:
-              if (m_C8266Drv.indexOf(m_pstrctRequest->header.pcUri, "/test?", 0, MAX_URI_LENGTH) != -1) {
-              //if (strncmp(m_pstrctRequest->header.pcUri, "/test?", MAX_URI_LENGTH) == 0) {
+              if (m_pDeviceCache->get(l_uiDeviceId, &l_strctEntry)) {
                 l_strctHeader.enmStatusCode = CESP8266::ENM_REST_STATUS_CODE::OK;
-                strcpy(l_strctHeader.pcContentType, "application/json; charset=utf-8");
-               
-                m_C8266Drv.getUriParam(m_pstrctRequest->header.pcUri, "value", &l_value[0]);
-                LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "value", l_value);
-
-                m_C8266Drv.getUriParam(m_pstrctRequest->header.pcUri, "name", &l_value[0]);
-                LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "name", l_value);
-
-                m_C8266Drv.sendResponse(l_strctHeader, "{\"value\":\"response2\"}");
+                concatDeviceReading(l_uiDeviceId, &l_strctEntry);
               }
-            break;
-
-            default:
-              l_strctHeader.enmStatusCode = CESP8266::ENM_REST_STATUS_CODE::NOT_FOUND;
-            break;
+            } else {
+              l_strctHeader.enmStatusCode = CESP8266::ENM_REST_STATUS_CODE::BAD_REQUEST;
+            }
+          } else if (strncmp(m_pstrctRequest->header.pcUri, "/devices", MAX_URI_LENGTH) == 0) {
+            l_strctHeader.enmStatusCode = CESP8266::ENM_REST_STATUS_CODE::OK;
+            m_toolBufferLargeMiscellaneous.start("{\"devices\":\"");
+
+            for (l_uiDeviceId = 0; l_uiDeviceId < MAX_RADIO_DEVICES; l_uiDeviceId++) {
+              if (m_pDeviceCache->get(l_uiDeviceId, &l_strctEntry)) {
+                if (!l_bListEmpty) {
+                  m_toolBufferLargeMiscellaneous.concat(",");
+                }
+                l_bListEmpty = false;
+                itoa(l_uiDeviceId, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+                m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+              }
+            }
+            m_toolBufferLargeMiscellaneous.concat("\"}");
           }
 
-          
-
+          m_C8266Drv.sendResponse(l_strctHeader, m_toolBufferLargeMiscellaneous.getBuffer());
           return true;
         }
     }
@@ -150,7 +142,8 @@ boolean CBridge::poll() {
 }
 
 /**
-*   post a keep-alive message to the API server 
+*   post a keep-alive message to the API server, along with the devices heard during the last keep-alive 
+*   period and the devices lost, cf concatLiveness()
 *   params: 
 *       NONE
 *   return:
@@ -159,9 +152,14 @@ boolean CBridge::poll() {
 boolean CBridge::postKeepaliveServer() {
   CESP8266::STRCT_RESPONSE *l_pstrctResponse;
   uint8_t l_uiRetriesCounter = 0;
+  uint8_t l_auiLostDevices[MAX_RADIO_DEVICES];
+  byte l_byLostCount = 0;
 
   m_toolBufferLargeMiscellaneous.start("{\"api_client_id\":\"");
   m_toolBufferLargeMiscellaneous.concat(m_pstrctBridgeSettings->strctAPIServerSettings.cClientID);
+  if (m_pDeviceLiveness != NULL) {
+    concatLiveness(l_auiLostDevices, &l_byLostCount);
+  }
   m_toolBufferLargeMiscellaneous.concat("\"}");
 
   m_toolBufferTinyMiscellaneous.start(m_pstrctBridgeSettings->strctAPIServerSettings.cUri);
@@ -173,6 +171,11 @@ boolean CBridge::postKeepaliveServer() {
                                                       m_toolBufferTinyMiscellaneous.getBuffer(),
                                                       true, m_toolBufferLargeMiscellaneous.getBuffer(),
                                                       m_pstrctBridgeSettings->strctAPIServerSettings.cAuthorizationToken)) != NULL) {
+        //lost devices are reported until a heartbeat gets through
+        if (l_byLostCount != 0) {
+          m_pDeviceLiveness->confirmLostDevices(l_auiLostDevices, l_byLostCount);
+          LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "Devices lost reported", l_byLostCount);
+        }
         return true;
       }
   } while (l_uiRetriesCounter++ < MAX_BRIDGE_SEND_RETRIES);
@@ -180,42 +183,6 @@ boolean CBridge::postKeepaliveServer() {
   return false;
 }
 
-/**
-*   post a keep-alive message to the API server concerning a device
-*   params: 
-*       p_uiDeviceAddr:         device address
-*   return:
-*       TRUE if succeeded to post  
-*/
-boolean CBridge::postKeepaliveDevice(uint8_t p_uiDeviceAddr) {
-  CESP8266::STRCT_RESPONSE *l_pstrctResponse;
-  uint8_t l_uiRetriesCounter = 0;
-
-  m_toolBufferLargeMiscellaneous.start("{\"api_client_id\":\"");
-  m_toolBufferLargeMiscellaneous.concat(m_pstrctBridgeSettings->strctAPIServerSettings.cClientID);
-  m_toolBufferLargeMiscellaneous.concat("\",\"device_addr\":\"");
-
-  itoa(p_uiDeviceAddr, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
-  m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
-  m_toolBufferLargeMiscellaneous.concat("\"}");
-
-  m_toolBufferTinyMiscellaneous.start(m_pstrctBridgeSettings->strctAPIServerSettings.cUri);
-  m_toolBufferTinyMiscellaneous.concat(API_URI_POST_KEEP_ALIVE_DEVICE);
-
-  do {
-      if ((l_pstrctResponse = m_C8266Drv.postJsonToHost(m_pstrctBridgeSettings->strctAPIServerSettings.cHostname, 
-                                                      m_pstrctBridgeSettings->strctAPIServerSettings.uiPort, 
-                                                      m_toolBufferTinyMiscellaneous.getBuffer(),
-                                                      true, m_toolBufferLargeMiscellaneous.getBuffer(),
-                                                      m_pstrctBridgeSettings->strctAPIServerSettings.cAuthorizationToken)) != NULL) {
-        return true;
-      }
-  } while (l_uiRetriesCounter++ < MAX_BRIDGE_SEND_RETRIES);
-
-  return false;
-}
-
-
 /**
 *   post sensor values to the API server
 *   params: 
@@ -255,6 +222,23 @@ boolean CBridge::postSensorValues(STRUCT_X_QUEUE_SENSOR_VALUES pstrctQueuePostMe
     itoa(pstrctQueuePostMessageSensorValues.byDewPointRemaindertValue, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
     m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
 
+    m_toolBufferLargeMiscellaneous.concat("\",\"sample_age\":\"");
+    ultoa(pstrctQueuePostMessageSensorValues.ulSampleAge, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+    m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+
+    //oversampled measurement: spread over the burst
+    if (pstrctQueuePostMessageSensorValues.strctStatistics.uiSamplesCount > 1) {
+        concatStatistics("temperature", &pstrctQueuePostMessageSensorValues.strctStatistics.strctTemperature);
+        concatStatistics("humidity", &pstrctQueuePostMessageSensorValues.strctStatistics.strctHumidity);
+
+        m_toolBufferLargeMiscellaneous.concat("\",\"samples_count\":\"");
+        itoa(pstrctQueuePostMessageSensorValues.strctStatistics.uiSamplesCount, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+        m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+        m_toolBufferLargeMiscellaneous.concat("\",\"rejected_samples\":\"");
+        itoa(pstrctQueuePostMessageSensorValues.strctStatistics.uiRejectedCount, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+        m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+    }
+
     m_toolBufferLargeMiscellaneous.concat("\",\"api_client_id\":\"");
     m_toolBufferLargeMiscellaneous.concat(m_pstrctBridgeSettings->strctAPIServerSettings.cClientID);
     m_toolBufferLargeMiscellaneous.concat("\",\"device_addr\":\"");
@@ -296,6 +280,9 @@ boolean CBridge::postSensorValues(STRUCT_X_QUEUE_SENSOR_VALUES pstrctQueuePostMe
         m_C8266Drv.getJSONArrayObject(l_pstrctResponse->pData, "array", m_toolBufferTinyMiscellaneous.getBuffer());
         LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "array", m_toolBufferTinyMiscellaneous.getBuffer());
         */
+
+        //the API may answer with a command for the device
+        queueDownlinkCommand(pstrctQueuePostMessageSensorValues.uiDeviceId, l_pstrctResponse->pData);
         return true;
       } 
   } while (l_uiRetriesCounter++ < MAX_BRIDGE_SEND_RETRIES);
@@ -303,4 +290,307 @@ boolean CBridge::postSensorValues(STRUCT_X_QUEUE_SENSOR_VALUES pstrctQueuePostMe
   return false;
 }
 
+/**
+*   init the outbox: readings not uploaded are kept in flash, and replayed oldest first
+*   params: 
+*       p_pvFlashArea:          flash area, aligned on a NVM row
+*       p_uiRowsCount:          flash area size in NVM rows
+*   return:
+*       false if the flash area does not fit
+*/
+boolean CBridge::initOutbox(const volatile void *p_pvFlashArea, uint16_t p_uiRowsCount) {
+    if (!m_outbox.init(p_pvFlashArea, p_uiRowsCount)) {
+        return false;
+    }
+
+    //the outbox clock goes on from the newest reading stored: ages of readings stored before a restart 
+    //do not include the time the bridge was off
+    m_ulOutboxTimeBase = m_outbox.getNewestTimestamp();
+
+    LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "Outbox readings", m_outbox.getPendingCount());
+    return true;
+}
+
+/**
+*   store a reading into the outbox, to be replayed by drainOutbox()
+*   params: 
+*       p_strctSensorValues:    reading not uploaded
+*   return:
+*       false if the outbox is not initialized
+*/
+boolean CBridge::storeSensorValues(STRUCT_X_QUEUE_SENSOR_VALUES p_strctSensorValues) {
+    uint32_t l_ulTime = getOutboxTime();
+
+    return m_outbox.append(p_strctSensorValues.uiDeviceId, 
+                            (p_strctSensorValues.ulSampleAge < l_ulTime) ? l_ulTime - p_strctSensorValues.ulSampleAge : 0, 
+                            &p_strctSensorValues.byTemperatureQuotientValue);
+}
+
+/**
+*   replay a batch of readings from the outbox, oldest first. Readings older than the retention are dropped.
+*   The replay cursor is committed once per batch, or up to the reading that failed
+*   params: 
+*       NONE
+*   return:
+*       false if a reading could not be uploaded
+*/
+boolean CBridge::drainOutbox() {
+    STRUCT_FLASH_LOG_RECORD l_strctRecord;
+    STRUCT_X_QUEUE_SENSOR_VALUES l_strctSensorValues;
+    uint32_t l_ulRetention = (uint32_t)m_pstrctBridgeSettings->strctAPIServerSettings.uiOutboxRetention * 3600;
+    uint16_t l_uiCursor = m_outbox.getReplayCursor();
+    uint16_t l_uiNextCursor = l_uiCursor;
+    uint8_t l_uiBatchCount = 0;
+    boolean l_bStatus = true;
+
+    memset(&l_strctSensorValues, 0, sizeof(STRUCT_X_QUEUE_SENSOR_VALUES));
+
+    while ((l_uiBatchCount < BRIDGE_OUTBOX_DRAIN_BATCH) && m_outbox.readNext(&l_uiNextCursor, &l_strctRecord)) {
+        l_strctSensorValues.ulSampleAge = getOutboxTime() - l_strctRecord.ulTimestamp;
+
+        //retention policy
+        if ((l_ulRetention != 0) && (l_strctSensorValues.ulSampleAge > l_ulRetention)) {
+            LOG_INFO_PRINTLN(LOG_PREFIX_BRIDGE, "Outbox reading dropped, age (s)", l_strctSensorValues.ulSampleAge);
+        } else {
+            l_strctSensorValues.uiDeviceId = l_strctRecord.uiDeviceId;
+            memcpy(&l_strctSensorValues.byTemperatureQuotientValue, l_strctRecord.abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+
+            if (!postSensorValues(l_strctSensorValues)) {
+                l_bStatus = false;
+                break;
+            }
+            l_uiBatchCount++;
+        }
+
+        l_uiCursor = l_uiNextCursor;
+    }
+
+    m_outbox.commitReplayCursor(l_uiCursor);
+
+    return l_bStatus;
+}
+
+/**
+*   retreive the number of readings waiting in the outbox
+*   params: 
+*       NONE
+*   return:
+*       readings count
+*/
+uint16_t CBridge::getOutboxDepth() {
+    return m_outbox.getPendingCount();
+}
+
+/**
+*   retreive the age of the oldest reading waiting in the outbox
+*   params: 
+*       NONE
+*   return:
+*       seconds, 0 if the outbox is empty
+*/
+uint32_t CBridge::getOutboxAge() {
+    if (m_outbox.getPendingCount() == 0) {
+        return 0;
+    }
+
+    return getOutboxTime() - m_outbox.getOldestPendingTimestamp();
+}
+
+/**
+*   set the queue receiving the commands sent by the API to devices, cf queueDownlinkCommand()
+*   params: 
+*       p_pDownlinkQueue:       commands queue, shared with the radio
+*       p_uiBridgeDeviceId:     radio address of the bridge, whose own readings never get a command
+*   return:
+*       NONE
+*/
+void CBridge::initDownlink(CDownlinkQueue *p_pDownlinkQueue, uint8_t p_uiBridgeDeviceId) {
+    m_pDownlinkQueue = p_pDownlinkQueue;
+    m_uiBridgeDeviceId = p_uiBridgeDeviceId;
+}
+
+/**
+*   set the cache of the latest readings, answered to local queries when the bridge server is enabled, cf poll()
+*   params: 
+*       p_pDeviceCache:         latest readings, updated by the radio
+*   return:
+*       NONE
+*/
+void CBridge::initDeviceCache(CDeviceCache *p_pDeviceCache) {
+    m_pDeviceCache = p_pDeviceCache;
+}
+
+/**
+*   set the liveness table reported with the bridge keep-alive, cf postKeepaliveServer()
+*   params: 
+*       p_pDeviceLiveness:      liveness table, updated by the radio
+*   return:
+*       NONE
+*/
+void CBridge::initLiveness(CDeviceLiveness *p_pDeviceLiveness) {
+    m_pDeviceLiveness = p_pDeviceLiveness;
+}
+
+/**
+*   append the liveness JSON pairs: "alive_devices" is the bitmap of the devices heard during the last keep-alive 
+*   period as hex, byte n / 8 first, bit n set for device n. "lost_devices" lists the devices lost not reported yet
+*   params: 
+*       p_puiLostDevices:       lost devices appended, MAX_RADIO_DEVICES addresses
+*       p_pbyLostCount:         lost devices count
+*   return:
+*       NONE
+*/
+void CBridge::concatLiveness(uint8_t *p_puiLostDevices, byte *p_pbyLostCount) {
+    const char l_ccHexDigits[] = "0123456789abcdef";
+    byte l_abyAliveBitmap[DEVICE_LIVENESS_BITMAP_LENGTH];
+    char *l_pcHex = m_toolBufferTinyMiscellaneous.getBuffer();
+    byte l_byIndex;
+
+    m_pDeviceLiveness->getAliveBitmap(l_abyAliveBitmap);
+    for (l_byIndex = 0; l_byIndex < DEVICE_LIVENESS_BITMAP_LENGTH; l_byIndex++) {
+        l_pcHex[l_byIndex * 2] = l_ccHexDigits[l_abyAliveBitmap[l_byIndex] >> 4];
+        l_pcHex[l_byIndex * 2 + 1] = l_ccHexDigits[l_abyAliveBitmap[l_byIndex] & 0x0F];
+    }
+    l_pcHex[DEVICE_LIVENESS_BITMAP_LENGTH * 2] = '\0';
+
+    m_toolBufferLargeMiscellaneous.concat("\",\"alive_devices\":\"");
+    m_toolBufferLargeMiscellaneous.concat(l_pcHex);
+
+    *p_pbyLostCount = m_pDeviceLiveness->getLostDevices(p_puiLostDevices, MAX_RADIO_DEVICES);
+    if (*p_pbyLostCount != 0) {
+        m_toolBufferLargeMiscellaneous.concat("\",\"lost_devices\":\"");
+        for (l_byIndex = 0; l_byIndex < *p_pbyLostCount; l_byIndex++) {
+            if (l_byIndex != 0) {
+                m_toolBufferLargeMiscellaneous.concat(",");
+            }
+            itoa(p_puiLostDevices[l_byIndex], m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+            m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+        }
+    }
+}
+
+/**
+*   write the latest reading of a device as a JSON object, using the keys of postSensorValues(). 
+*   "rssi" is in dBm, "lqi" the lower the better
+*   params: 
+*       p_uiDeviceId:           device address
+*       p_pstrctEntry:          cached reading
+*   return:
+*       NONE
+*/
+void CBridge::concatDeviceReading(uint8_t p_uiDeviceId, CDeviceCache::STRUCT_DEVICE_CACHE_ENTRY *p_pstrctEntry) {
+    m_toolBufferLargeMiscellaneous.start("{\"device_addr\":\"");
+    itoa(p_uiDeviceId, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+    m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+
+    m_toolBufferLargeMiscellaneous.concat("\",\"temperature_value\":\"");
+    concatHundredths(p_pstrctEntry->abySensorValues[0] * 100 + p_pstrctEntry->abySensorValues[1]);
+    m_toolBufferLargeMiscellaneous.concat("\",\"humidity_value\":\"");
+    concatHundredths(p_pstrctEntry->abySensorValues[2] * 100 + p_pstrctEntry->abySensorValues[3]);
+    m_toolBufferLargeMiscellaneous.concat("\",\"partial_pressure_value\":\"");
+    concatHundredths(p_pstrctEntry->abySensorValues[4] * 100 + p_pstrctEntry->abySensorValues[5]);
+    m_toolBufferLargeMiscellaneous.concat("\",\"dew_point_value\":\"");
+    concatHundredths(p_pstrctEntry->abySensorValues[6] * 100 + p_pstrctEntry->abySensorValues[7]);
+
+    m_toolBufferLargeMiscellaneous.concat("\",\"sample_age\":\"");
+    ultoa(m_pDeviceCache->getReadingAge(p_pstrctEntry), m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+    m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+    m_toolBufferLargeMiscellaneous.concat("\",\"rssi\":\"");
+    itoa(p_pstrctEntry->iRSSI, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+    m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+    m_toolBufferLargeMiscellaneous.concat("\",\"lqi\":\"");
+    itoa(p_pstrctEntry->uiLQI, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+    m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+    m_toolBufferLargeMiscellaneous.concat("\"}");
+}
+
+/**
+*   append min, max, mean and standard deviation JSON pairs of a quantity, e.g. "temperature_min":"21.05"
+*   params: 
+*       p_pccKeyPrefix:         quantity name
+*       p_pstrctStatistics:     burst statistics
+*   return:
+*       NONE
+*/
+void CBridge::concatStatistics(const char *p_pccKeyPrefix, STRUCT_SENSOR_VALUE_STATISTICS *p_pstrctStatistics) {
+    m_toolBufferLargeMiscellaneous.concat("\",\"");
+    m_toolBufferLargeMiscellaneous.concat(p_pccKeyPrefix);
+    m_toolBufferLargeMiscellaneous.concat("_min\":\"");
+    concatHundredths(p_pstrctStatistics->iMinValue);
+
+    m_toolBufferLargeMiscellaneous.concat("\",\"");
+    m_toolBufferLargeMiscellaneous.concat(p_pccKeyPrefix);
+    m_toolBufferLargeMiscellaneous.concat("_max\":\"");
+    concatHundredths(p_pstrctStatistics->iMaxValue);
+
+    m_toolBufferLargeMiscellaneous.concat("\",\"");
+    m_toolBufferLargeMiscellaneous.concat(p_pccKeyPrefix);
+    m_toolBufferLargeMiscellaneous.concat("_mean\":\"");
+    concatHundredths(p_pstrctStatistics->iMeanValue);
+
+    m_toolBufferLargeMiscellaneous.concat("\",\"");
+    m_toolBufferLargeMiscellaneous.concat(p_pccKeyPrefix);
+    m_toolBufferLargeMiscellaneous.concat("_stddev\":\"");
+    concatHundredths(p_pstrctStatistics->uiStdDevValue);
+}
+
+/**
+*   append a hundredths value as a decimal number, e.g. -105 => "-1.05"
+*   params: 
+*       p_lValue:               value, hundredths
+*   return:
+*       NONE
+*/
+void CBridge::concatHundredths(int32_t p_lValue) {
+    if (p_lValue < 0) {
+        m_toolBufferLargeMiscellaneous.concat("-");
+        p_lValue = -p_lValue;
+    }
+
+    itoa(p_lValue / 100, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+    m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+    m_toolBufferLargeMiscellaneous.concat((p_lValue % 100 < 10) ? ".0" : ".");
+    itoa(p_lValue % 100, m_toolBufferTinyMiscellaneous.getBuffer(), 10);
+    m_toolBufferLargeMiscellaneous.concat(m_toolBufferTinyMiscellaneous.getBuffer());
+}
+
+/**
+*   outbox clock: seconds since boot, carried on from the newest reading stored before the restart
+*   params: 
+*       NONE
+*   return:
+*       seconds
+*/
+uint32_t CBridge::getOutboxTime() {
+    return m_ulOutboxTimeBase + xTaskGetTickCount() / configTICK_RATE_HZ;
+}
+
+/**
+*   queue the command the API answered to a reading, e.g. {"downlink_command":"1","downlink_value":"15"}. 
+*   The device receives it within the acknowledge of its next message, cf ENM_RADIO_DOWNLINK_COMMAND. The bridge 
+*   sends no acknowledge to itself: a command answered to its own reading would wait into the queue forever
+*   params: 
+*       p_uiDeviceId:           device which sent the reading
+*       p_pcResponseData:       API response body
+*   return:
+*       NONE
+*/
+void CBridge::queueDownlinkCommand(uint8_t p_uiDeviceId, char *p_pcResponseData) {
+    byte l_byCommand;
+
+    if ((m_pDownlinkQueue == NULL) || (p_pcResponseData == NULL) || (p_uiDeviceId == m_uiBridgeDeviceId) || 
+        !m_C8266Drv.getJSONValue(p_pcResponseData, "downlink_command", m_toolBufferTinyMiscellaneous.getBuffer())) {
+        return;
+    }
+    l_byCommand = atoi(m_toolBufferTinyMiscellaneous.getBuffer());
+
+    if (!m_C8266Drv.getJSONValue(p_pcResponseData, "downlink_value", m_toolBufferTinyMiscellaneous.getBuffer())) {
+        return;
+    }
+
+    if (!m_pDownlinkQueue->push(p_uiDeviceId, l_byCommand, atol(m_toolBufferTinyMiscellaneous.getBuffer()))) {
+        LOG_ERROR_PRINTLN(LOG_PREFIX_BRIDGE, "Downlink queue full, oldest command dropped", p_uiDeviceId);
+    }
+}
+
 #endif
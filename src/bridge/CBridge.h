@@ -20,27 +20,44 @@
 #ifndef __CSERVER_H__
 #define __CSERVER_H__
 
-#include "global.h"
+#include "Global.h"
 
 #ifdef BRIDGE_MODE
 
     #include "CESP8266.h"
-    #include "logging.h"
+    #include "Logging.h"
     #include "CCharBufferTool.h"
+    #include "logger/CFlashLog.h"
+    #include "radio/CDownlinkQueue.h"
+    #include "CDeviceLiveness.h"
+    #include "CDeviceCache.h"
 
     #define MAX_SERVER_TINY_MISCELLANEOUS_LENGTH    64
     #define MAX_SERVER_LARGE_MISCELLANEOUS_LENGTH   1024
 
     #define MAX_BRIDGE_SEND_RETRIES                 2
 
+    #define BRIDGE_OUTBOX_ROWS                      32          //NVM rows of 256 bytes, 16 readings each
+    #define BRIDGE_OUTBOX_DRAIN_BATCH               8           //readings replayed per drain pass, one cursor commit each
+    #define BRIDGE_OUTBOX_RETRY_PERIOD              60          //sec, drain retried after a failure
+
     class CBridge {
     public:
         CESP8266::ENM_STATUS                init(Uart *p_pSerialPort, unsigned long p_ulBaudeRate, STRUCT_BRIDGE_SETTINGS *p_pstrctBridgeSettings, STRUCT_WIFI_STATUS *p_pstrWiFiStatus);
         boolean                             poll();
         boolean                             postSensorValues(STRUCT_X_QUEUE_SENSOR_VALUES pstrctQueuePostMessageSensorValues);
         boolean                             postKeepaliveServer();
-        boolean                             postKeepaliveDevice(uint8_t p_uiDeviceAddr);
         uint8_t                             factoryReset();
+
+        boolean                             initOutbox(const volatile void *p_pvFlashArea, uint16_t p_uiRowsCount);
+        boolean                             storeSensorValues(STRUCT_X_QUEUE_SENSOR_VALUES p_strctSensorValues);
+        boolean                             drainOutbox();
+        uint16_t                            getOutboxDepth();
+        uint32_t                            getOutboxAge();
+
+        void                                initDownlink(CDownlinkQueue *p_pDownlinkQueue, uint8_t p_uiBridgeDeviceId);
+        void                                initLiveness(CDeviceLiveness *p_pDeviceLiveness);
+        void                                initDeviceCache(CDeviceCache *p_pDeviceCache);
     private:
         char                                m_cBufferTinyMiscellaneous[MAX_SERVER_TINY_MISCELLANEOUS_LENGTH];
         CCharBufferTool                     m_toolBufferTinyMiscellaneous;
@@ -50,6 +67,20 @@
         STRUCT_BRIDGE_SETTINGS              *m_pstrctBridgeSettings;
         CESP8266                            m_C8266Drv;
         boolean                             m_bServerInit = false;
+        CFlashLog                           m_outbox;
+        uint32_t                            m_ulOutboxTimeBase;
+        CDownlinkQueue                      *m_pDownlinkQueue = NULL;
+        uint8_t                             m_uiBridgeDeviceId = 0;
+        CDeviceLiveness                     *m_pDeviceLiveness = NULL;
+        CDeviceCache                        *m_pDeviceCache = NULL;
+
+        uint32_t                            getOutboxTime();
+        void                                queueDownlinkCommand(uint8_t p_uiDeviceId, char *p_pcResponseData);
+        void                                concatLiveness(uint8_t *p_puiLostDevices, byte *p_pbyLostCount);
+        void                                concatDeviceReading(uint8_t p_uiDeviceId, CDeviceCache::STRUCT_DEVICE_CACHE_ENTRY *p_pstrctEntry);
+
+        void                                concatStatistics(const char *p_pccKeyPrefix, STRUCT_SENSOR_VALUE_STATISTICS *p_pstrctStatistics);
+        void                                concatHundredths(int32_t p_lValue);
     };
 
     #endif
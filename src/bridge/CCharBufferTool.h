@@ -21,10 +21,10 @@
 #define __CCHAR_BUFFER_TOOL_H__
 
 #include <Arduino.h>
-#include "global.h"
+#include "Global.h"
 
 #ifdef BRIDGE_MODE
-    #include "logging.h"
+    #include "Logging.h"
 
     class CCharBufferTool {
     public:
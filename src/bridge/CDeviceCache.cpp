@@ -0,0 +1,99 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#include "CDeviceCache.h"
+
+#ifdef BRIDGE_MODE
+
+/****************************************************************************************
+ * 
+ *     *****    *     *     *****       *         *****       **** 
+ *     *    *   *     *     *    *      *           *       *     
+ *     * * *    *     *     *  *        *           *      *       
+ *     *        *     *     *    *      *           *       *        
+ *     *         * * *      ******      ******    *****       ****        
+ *    
+ * **************************************************************************************/
+
+/**
+*   Record a reading received from a device. A reading older than the one cached is ignored, e.g. 
+*   readings of an aggregated frame coming after a newer single reading
+*   params: 
+*       p_uiDeviceId:       sender address
+*       p_pbySensorValues:  RADIO_SENSOR_VALUES_LENGTH bytes
+*       p_ulSampleAge:      seconds elapsed since the measurement
+*       p_iRSSI:            RSSI of the message, dBm
+*       p_byLQI:            LQI of the message
+*   return:
+*       NONE       
+*/
+void CDeviceCache::update(uint8_t p_uiDeviceId, byte *p_pbySensorValues, uint32_t p_ulSampleAge, int16_t p_iRSSI, byte p_byLQI) {
+    STRUCT_DEVICE_CACHE_ENTRY *l_pstrctEntry;
+    TickType_t l_xReadingTick = xTaskGetTickCount() - p_ulSampleAge * configTICK_RATE_HZ;
+
+    if (p_uiDeviceId >= MAX_RADIO_DEVICES) {
+        return;
+    }
+
+    l_pstrctEntry = &m_astrctEntries[p_uiDeviceId];
+
+    vTaskSuspendAll();
+
+    if (!l_pstrctEntry->bValid || ((int32_t)(l_xReadingTick - l_pstrctEntry->xReadingTick) >= 0)) {
+        memcpy(l_pstrctEntry->abySensorValues, p_pbySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+        l_pstrctEntry->xReadingTick = l_xReadingTick;
+        l_pstrctEntry->iRSSI = constrain(p_iRSSI, -128, 127);
+        l_pstrctEntry->uiLQI = p_byLQI;
+        l_pstrctEntry->bValid = true;
+    }
+
+    xTaskResumeAll();
+}
+
+/**
+*   Retreive the latest reading of a device
+*   params: 
+*       p_uiDeviceId:       device address
+*       p_pstrctEntry:      reading and link quality
+*   return:
+*       false if no reading has been received from the device       
+*/
+boolean CDeviceCache::get(uint8_t p_uiDeviceId, STRUCT_DEVICE_CACHE_ENTRY *p_pstrctEntry) {
+    if (p_uiDeviceId >= MAX_RADIO_DEVICES) {
+        return false;
+    }
+
+    vTaskSuspendAll();
+    memcpy(p_pstrctEntry, &m_astrctEntries[p_uiDeviceId], sizeof(STRUCT_DEVICE_CACHE_ENTRY));
+    xTaskResumeAll();
+
+    return p_pstrctEntry->bValid;
+}
+
+/**
+*   Retreive the age of a cached reading
+*   params: 
+*       p_pstrctEntry:      reading, cf get()
+*   return:
+*       seconds elapsed since the measurement       
+*/
+uint32_t CDeviceCache::getReadingAge(STRUCT_DEVICE_CACHE_ENTRY *p_pstrctEntry) {
+    return (xTaskGetTickCount() - p_pstrctEntry->xReadingTick) / configTICK_RATE_HZ;
+}
+
+#endif
@@ -0,0 +1,51 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#ifndef _CDEVICE_CACHE_H_
+#define _CDEVICE_CACHE_H_
+
+#include <Arduino.h>
+#include "Global.h"
+
+#ifdef BRIDGE_MODE
+
+    /**
+     *  Latest reading of each device served by the bridge, indexed by device address, along with the link 
+     *  quality of the message which brought it. Local queries (AT command, bridge server) are answered 
+     *  without any API round trip. Updated by the radio thread.
+     */
+    class CDeviceCache {
+    public:
+        struct STRUCT_DEVICE_CACHE_ENTRY {
+            byte        abySensorValues[RADIO_SENSOR_VALUES_LENGTH];    //quotient and remainder of each value, cf STRUCT_X_QUEUE_SENSOR_VALUES
+            TickType_t  xReadingTick;           //tick of the measurement, sample age deducted
+            int8_t      iRSSI;                  //dBm
+            uint8_t     uiLQI;                  //link quality indicator, the lower the better
+            boolean     bValid;
+        };
+
+        void update(uint8_t p_uiDeviceId, byte *p_pbySensorValues, uint32_t p_ulSampleAge, int16_t p_iRSSI, byte p_byLQI);
+        boolean get(uint8_t p_uiDeviceId, STRUCT_DEVICE_CACHE_ENTRY *p_pstrctEntry);
+        uint32_t getReadingAge(STRUCT_DEVICE_CACHE_ENTRY *p_pstrctEntry);
+    private:
+        STRUCT_DEVICE_CACHE_ENTRY m_astrctEntries[MAX_RADIO_DEVICES];
+    };
+
+#endif
+
+#endif
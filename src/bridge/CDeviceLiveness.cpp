@@ -0,0 +1,193 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#include "CDeviceLiveness.h"
+
+#ifdef BRIDGE_MODE
+
+/****************************************************************************************
+ * 
+ *     *****    *     *     *****       *         *****       **** 
+ *     *    *   *     *     *    *      *           *       *     
+ *     * * *    *     *     *  *        *           *      *       
+ *     *        *     *     *    *      *           *       *        
+ *     *         * * *      ******      ******    *****       ****        
+ *    
+ * **************************************************************************************/
+
+/**
+*   Record a message received from a device. A lost device heard again is alive from now on
+*   params: 
+*       p_uiDeviceId:       sender address
+*       p_iRSSI:            RSSI of the message, dBm
+*   return:
+*       NONE       
+*/
+void CDeviceLiveness::update(uint8_t p_uiDeviceId, int16_t p_iRSSI) {
+    STRUCT_DEVICE_LIVENESS *l_pstrctDevice;
+
+    if (p_uiDeviceId >= MAX_RADIO_DEVICES) {
+        return;
+    }
+
+    l_pstrctDevice = &m_astrctDevices[p_uiDeviceId];
+
+    vTaskSuspendAll();
+
+    l_pstrctDevice->xLastSeenTick = xTaskGetTickCount();
+    l_pstrctDevice->iLastRSSI = constrain(p_iRSSI, -128, 127);
+    if (l_pstrctDevice->uiMessagesCount != 0xFFFF) {
+        l_pstrctDevice->uiMessagesCount++;
+    }
+    l_pstrctDevice->uiMissedPeriods = 0;
+    l_pstrctDevice->byFlags = DEVICE_LIVENESS_FLAG_KNOWN | DEVICE_LIVENESS_FLAG_SEEN;
+
+    xTaskResumeAll();
+}
+
+/**
+*   Close the current keep-alive period: devices heard make the alive bitmap, the others miss a period 
+*   and are lost after DEVICE_LIVENESS_LOST_PERIODS
+*   params: 
+*       NONE
+*   return:
+*       NONE       
+*/
+void CDeviceLiveness::closePeriod() {
+    STRUCT_DEVICE_LIVENESS *l_pstrctDevice;
+    uint8_t l_uiDeviceId;
+
+    vTaskSuspendAll();
+
+    memset(m_abyAliveBitmap, 0, sizeof(m_abyAliveBitmap));
+    m_byAliveCount = 0;
+
+    for (l_uiDeviceId = 0; l_uiDeviceId < MAX_RADIO_DEVICES; l_uiDeviceId++) {
+        l_pstrctDevice = &m_astrctDevices[l_uiDeviceId];
+
+        if (l_pstrctDevice->byFlags & DEVICE_LIVENESS_FLAG_SEEN) {
+            m_abyAliveBitmap[l_uiDeviceId / 8] |= (1 << (l_uiDeviceId % 8));
+            m_byAliveCount++;
+            l_pstrctDevice->byFlags &= ~DEVICE_LIVENESS_FLAG_SEEN;
+        } else if ((l_pstrctDevice->byFlags & DEVICE_LIVENESS_FLAG_KNOWN) && !(l_pstrctDevice->byFlags & DEVICE_LIVENESS_FLAG_LOST)) {
+            if (++l_pstrctDevice->uiMissedPeriods >= DEVICE_LIVENESS_LOST_PERIODS) {
+                l_pstrctDevice->byFlags |= DEVICE_LIVENESS_FLAG_LOST;
+            }
+        }
+    }
+
+    xTaskResumeAll();
+}
+
+/**
+*   Retreive the devices heard during the last closed period
+*   params: 
+*       p_pbyBitmap:        DEVICE_LIVENESS_BITMAP_LENGTH bytes, bit n of byte n / 8 set if device n is alive
+*   return:
+*       alive devices count       
+*/
+byte CDeviceLiveness::getAliveBitmap(byte *p_pbyBitmap) {
+    byte l_byAliveCount;
+
+    vTaskSuspendAll();
+    memcpy(p_pbyBitmap, m_abyAliveBitmap, sizeof(m_abyAliveBitmap));
+    l_byAliveCount = m_byAliveCount;
+    xTaskResumeAll();
+
+    return l_byAliveCount;
+}
+
+/**
+*   Retreive the count of devices heard during the last closed period
+*   params: 
+*       NONE
+*   return:
+*       devices count       
+*/
+byte CDeviceLiveness::getAliveCount() {
+    return m_byAliveCount;
+}
+
+/**
+*   Retreive the lost devices not reported yet
+*   params: 
+*       p_puiDevices:       devices addresses
+*       p_byMaxCount:       size of p_puiDevices
+*   return:
+*       devices count       
+*/
+byte CDeviceLiveness::getLostDevices(uint8_t *p_puiDevices, byte p_byMaxCount) {
+    byte l_byCount = 0;
+    uint8_t l_uiDeviceId;
+
+    vTaskSuspendAll();
+
+    for (l_uiDeviceId = 0; (l_uiDeviceId < MAX_RADIO_DEVICES) && (l_byCount < p_byMaxCount); l_uiDeviceId++) {
+        if ((m_astrctDevices[l_uiDeviceId].byFlags & (DEVICE_LIVENESS_FLAG_LOST | DEVICE_LIVENESS_FLAG_LOST_REPORTED)) == DEVICE_LIVENESS_FLAG_LOST) {
+            p_puiDevices[l_byCount++] = l_uiDeviceId;
+        }
+    }
+
+    xTaskResumeAll();
+
+    return l_byCount;
+}
+
+/**
+*   Mark lost devices as reported to the API server. Devices heard again in the meantime are left alive
+*   params: 
+*       p_puiDevices:       devices addresses, cf getLostDevices()
+*       p_byCount:          devices count
+*   return:
+*       NONE       
+*/
+void CDeviceLiveness::confirmLostDevices(uint8_t *p_puiDevices, byte p_byCount) {
+    byte l_byIndex;
+
+    vTaskSuspendAll();
+
+    for (l_byIndex = 0; l_byIndex < p_byCount; l_byIndex++) {
+        if (m_astrctDevices[p_puiDevices[l_byIndex]].byFlags & DEVICE_LIVENESS_FLAG_LOST) {
+            m_astrctDevices[p_puiDevices[l_byIndex]].byFlags |= DEVICE_LIVENESS_FLAG_LOST_REPORTED;
+        }
+    }
+
+    xTaskResumeAll();
+}
+
+/**
+*   Retreive the count of devices lost
+*   params: 
+*       NONE
+*   return:
+*       devices count, reported or not       
+*/
+byte CDeviceLiveness::getLostCount() {
+    byte l_byCount = 0;
+    uint8_t l_uiDeviceId;
+
+    for (l_uiDeviceId = 0; l_uiDeviceId < MAX_RADIO_DEVICES; l_uiDeviceId++) {
+        if (m_astrctDevices[l_uiDeviceId].byFlags & DEVICE_LIVENESS_FLAG_LOST) {
+            l_byCount++;
+        }
+    }
+
+    return l_byCount;
+}
+
+#endif
@@ -0,0 +1,70 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#ifndef _CDEVICE_LIVENESS_H_
+#define _CDEVICE_LIVENESS_H_
+
+#include <Arduino.h>
+#include "Global.h"
+
+#ifdef BRIDGE_MODE
+
+    #define DEVICE_LIVENESS_LOST_PERIODS            3           //keep-alive periods missed before a device is reported lost
+    #define DEVICE_LIVENESS_BITMAP_LENGTH           ((MAX_RADIO_DEVICES + 7) / 8)      //bit n set if device n is alive
+
+    #define DEVICE_LIVENESS_FLAG_KNOWN              (1 << 0)    //heard at least once
+    #define DEVICE_LIVENESS_FLAG_SEEN               (1 << 1)    //heard during the current period
+    #define DEVICE_LIVENESS_FLAG_LOST               (1 << 2)
+    #define DEVICE_LIVENESS_FLAG_LOST_REPORTED      (1 << 3)    //loss uploaded to the API server
+
+    /**
+     *  Liveness of the devices served by the bridge, indexed by device address. Every radio message proves 
+     *  its sender alive, so device keep-alives are not forwarded one by one: the devices heard during the last 
+     *  keep-alive period are uploaded as a bitmap with the bridge heartbeat, along with devices newly lost.
+     *  Updated by the radio thread, read by the bridge thread.
+     */
+    class CDeviceLiveness {
+    public:
+        struct STRUCT_DEVICE_LIVENESS {
+            TickType_t  xLastSeenTick;
+            int8_t      iLastRSSI;              //dBm
+            uint16_t    uiMessagesCount;        //messages heard since the bridge started
+            uint8_t     uiMissedPeriods;        //keep-alive periods elapsed without any message
+            byte        byFlags;                //cf DEVICE_LIVENESS_FLAG_*
+        };
+
+        void update(uint8_t p_uiDeviceId, int16_t p_iRSSI);
+        void closePeriod();
+        byte getAliveBitmap(byte *p_pbyBitmap);
+        byte getAliveCount();
+        byte getLostDevices(uint8_t *p_puiDevices, byte p_byMaxCount);
+        void confirmLostDevices(uint8_t *p_puiDevices, byte p_byCount);
+        byte getLostCount();
+    private:
+    #ifdef PIO_UNIT_TESTING
+        friend class CDeviceLivenessTest;       //host tests, cf test/test_device_liveness
+    #endif
+
+        STRUCT_DEVICE_LIVENESS m_astrctDevices[MAX_RADIO_DEVICES];
+        byte m_abyAliveBitmap[DEVICE_LIVENESS_BITMAP_LENGTH];
+        byte m_byAliveCount = 0;
+    };
+
+#endif
+
+#endif
@@ -25,11 +25,11 @@
 #ifndef __CESP8266_H__
 #define __CESP8266_H__
 
-#include "global.h"
+#include "Global.h"
 
 #ifdef BRIDGE_MODE
 
-    #include "logging.h"
+    #include "Logging.h"
     #include "CCharBufferTool.h"
 
     //buffer dedicated to AT communication with ESP8266 module
@@ -0,0 +1,547 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#include "CFlashLog.h"
+
+/****************************************************************************************
+ * 
+ *     *****    *     *     *****       *         *****       **** 
+ *     *    *   *     *     *    *      *           *       *     
+ *     * * *    *     *     *  *        *           *      *       
+ *     *        *     *     *    *      *           *       *        
+ *     *         * * *      ******      ******    *****       ****        
+ *    
+ * **************************************************************************************/
+
+/**
+*   Rebuild the log from the flash content: newest record, replay cursor and readings count
+*   params: 
+*       p_pvFlashArea:      flash area, aligned on a NVM row
+*       p_uiRowsCount:      flash area size in NVM rows, 2 at least
+*   return:
+*       false if the flash area does not fit       
+*/
+boolean CFlashLog::init(const volatile void *p_pvFlashArea, uint16_t p_uiRowsCount) {
+    const STRUCT_FLASH_LOG_RECORD *l_pstrctRecord;
+    boolean l_bRecordFound = false;
+    boolean l_bCursorFound = false;
+    uint16_t l_uiNewestSequence = 0;
+    uint16_t l_uiCursorSequence = 0;
+    uint16_t l_uiReadingSequence = 0;
+    uint16_t l_uiSlot;
+
+    if ((((uintptr_t)p_pvFlashArea % FLASH_LOG_ROW_SIZE) != 0) || (p_uiRowsCount < 2) || (p_uiRowsCount > FLASH_LOG_MAX_ROWS)) {
+        m_uiSlotsCount = 0;
+        return false;
+    }
+
+    m_pstrctRecords = (const STRUCT_FLASH_LOG_RECORD *)p_pvFlashArea;
+    m_uiSlotsCount = p_uiRowsCount * FLASH_LOG_RECORDS_PER_ROW;
+    m_uiHeadSlot = 0;
+    m_uiRecordsCount = 0;
+    m_uiPendingCount = 0;
+    m_ulNewestTimestamp = 0;
+    m_bCursorRecorded = false;
+
+    for (l_uiSlot = 0; l_uiSlot < m_uiSlotsCount; l_uiSlot++) {
+        l_pstrctRecord = &m_pstrctRecords[l_uiSlot];
+        if (!isValid(l_pstrctRecord)) {
+            continue;
+        }
+
+        if (!l_bRecordFound || isOlder(l_uiNewestSequence, l_pstrctRecord->uiSequence)) {
+            l_uiNewestSequence = l_pstrctRecord->uiSequence;
+            m_uiHeadSlot = nextSlot(l_uiSlot);
+            l_bRecordFound = true;
+        }
+
+        if (l_pstrctRecord->uiDeviceId == FLASH_LOG_CURSOR_DEVICE_ID) {
+            if (!l_bCursorFound || isOlder(l_uiCursorSequence, l_pstrctRecord->uiSequence)) {
+                l_uiCursorSequence = l_pstrctRecord->uiSequence;
+                m_uiReplayCursor = (l_pstrctRecord->abySensorValues[0] << 8) | l_pstrctRecord->abySensorValues[1];
+                m_uiCursorSlot = l_uiSlot;
+                l_bCursorFound = true;
+            }
+        } else {
+            if ((m_uiRecordsCount == 0) || isOlder(l_uiReadingSequence, l_pstrctRecord->uiSequence)) {
+                l_uiReadingSequence = l_pstrctRecord->uiSequence;
+                m_ulNewestTimestamp = l_pstrctRecord->ulTimestamp;
+            }
+            m_uiRecordsCount++;
+        }
+    }
+
+    m_uiNextSequence = l_bRecordFound ? nextSequence(l_uiNewestSequence) : 0;
+
+    //no cursor record (or dropped with its row): every reading left is pending. An older cursor record may point to 
+    //readings dropped since: the cursor follows the oldest reading left
+    if (!l_bCursorFound || isOlder(m_uiReplayCursor, getOldestSequence())) {
+        m_uiReplayCursor = getOldestSequence();
+    }
+    m_bCursorRecorded = l_bCursorFound;
+
+    m_uiReadSlot = getTailSlot();
+    m_uiReadSequence = getOldestSequence();
+
+    //the head row has to be blank from the head on. A power loss may have left an uncommitted slot, or interrupted 
+    //the erase of the row: the row is erased again, or the head moves to the next row if it holds records
+    for (l_uiSlot = m_uiHeadSlot; (l_uiSlot == m_uiHeadSlot) || ((l_uiSlot % FLASH_LOG_RECORDS_PER_ROW) != 0); l_uiSlot++) {
+        if (!isBlank(&m_pstrctRecords[l_uiSlot])) {
+            if ((m_uiHeadSlot % FLASH_LOG_RECORDS_PER_ROW) != 0) {
+                m_uiHeadSlot = l_uiSlot - (l_uiSlot % FLASH_LOG_RECORDS_PER_ROW) + FLASH_LOG_RECORDS_PER_ROW;
+                m_uiHeadSlot %= m_uiSlotsCount;
+            }
+            eraseHeadRow();
+            break;
+        }
+    }
+
+    //pending readings are counted once, then followed by append(), commitReplayCursor() and row erases
+    m_uiPendingCount = countReadings(getTailSlot(), m_uiHeadSlot, m_uiReplayCursor);
+    updateOldestPending();
+
+    return true;
+}
+
+/**
+*   Append a reading to the log, the oldest row of readings is dropped when the log is full
+*   params: 
+*       p_uiDeviceId:       device the reading comes from
+*       p_ulTimestamp:      seconds, clock carried on across restarts by the owner
+*       p_pbySensorValues:  RADIO_SENSOR_VALUES_LENGTH bytes, POST_SENSOR_VALUES data layout
+*   return:
+*       false if the log is not initialized       
+*/
+boolean CFlashLog::append(uint8_t p_uiDeviceId, uint32_t p_ulTimestamp, const byte *p_pbySensorValues) {
+    if (p_uiDeviceId == FLASH_LOG_CURSOR_DEVICE_ID) {
+        return false;
+    }
+
+    if (!write(p_uiDeviceId, p_ulTimestamp, p_pbySensorValues)) {
+        return false;
+    }
+
+    m_uiRecordsCount++;
+    m_ulNewestTimestamp = p_ulTimestamp;
+
+    if (m_uiPendingCount++ == 0) {
+        m_ulOldestPendingTimestamp = p_ulTimestamp;
+    }
+    return true;
+}
+
+/**
+*   Sequential scan: read the first reading at or after the cursor, oldest first
+*   params: 
+*       p_puiCursor:        sequence to read from, moved after the reading read. A cursor older than 
+*                           the log starts from its oldest reading
+*       p_pstrctRecord:     reading read
+*   return:
+*       false if there is no more reading       
+*/
+boolean CFlashLog::readNext(uint16_t *p_puiCursor, STRUCT_FLASH_LOG_RECORD *p_pstrctRecord) {
+    const STRUCT_FLASH_LOG_RECORD *l_pstrctRecord;
+    uint16_t l_uiSlot;
+
+    if (m_uiSlotsCount == 0) {
+        return false;
+    }
+
+    //resume from the last reading read when possible, otherwise start again from the oldest one. Slots 
+    //are walked up to the head: the sequence check skips what has been read, or rewritten meanwhile
+    l_uiSlot = (*p_puiCursor == m_uiReadSequence) ? m_uiReadSlot : getTailSlot();
+
+    for (; l_uiSlot != m_uiHeadSlot; l_uiSlot = nextSlot(l_uiSlot)) {
+        l_pstrctRecord = &m_pstrctRecords[l_uiSlot];
+        if (!isReading(l_pstrctRecord) || isOlder(l_pstrctRecord->uiSequence, *p_puiCursor)) {
+            continue;
+        }
+
+        memcpy(p_pstrctRecord, l_pstrctRecord, sizeof(STRUCT_FLASH_LOG_RECORD));
+        *p_puiCursor = nextSequence(l_pstrctRecord->uiSequence);
+
+        m_uiReadSlot = nextSlot(l_uiSlot);
+        m_uiReadSequence = *p_puiCursor;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+*   Retreive the sequence of the oldest record of the log
+*   params: 
+*       NONE
+*   return:
+*       sequence, the next one written if the log is empty       
+*/
+uint16_t CFlashLog::getOldestSequence() {
+    uint16_t l_uiSlot;
+
+    for (l_uiSlot = getTailSlot(); l_uiSlot != m_uiHeadSlot; l_uiSlot = nextSlot(l_uiSlot)) {
+        if (isValid(&m_pstrctRecords[l_uiSlot])) {
+            return m_pstrctRecords[l_uiSlot].uiSequence;
+        }
+    }
+
+    return m_uiNextSequence;
+}
+
+/**
+*   Retreive the timestamp of the newest reading, e.g. to carry a clock on across restarts
+*   params: 
+*       NONE
+*   return:
+*       timestamp, 0 if the log has never held a reading       
+*/
+uint32_t CFlashLog::getNewestTimestamp() {
+    return m_ulNewestTimestamp;
+}
+
+/**
+*   Retreive the replay cursor: readings before it have been replayed
+*   params: 
+*       NONE
+*   return:
+*       sequence of the next reading to replay       
+*/
+uint16_t CFlashLog::getReplayCursor() {
+    return m_uiReplayCursor;
+}
+
+/**
+*   Persist the replay cursor, once readings read from the previous one have been handled
+*   params: 
+*       p_uiCursor:         cursor returned by readNext()
+*   return:
+*       false if the log is not initialized       
+*/
+boolean CFlashLog::commitReplayCursor(uint16_t p_uiCursor) {
+    if (p_uiCursor == m_uiReplayCursor) {
+        return true;
+    }
+
+    if (!writeCursor(p_uiCursor)) {
+        return false;
+    }
+
+    m_uiReplayCursor = p_uiCursor;
+
+    //once per replayed batch: readings skipped by the cursor are counted out
+    m_uiPendingCount = countReadings(getTailSlot(), m_uiHeadSlot, m_uiReplayCursor);
+    updateOldestPending();
+    return true;
+}
+
+/**
+*   Retreive the number of readings held by the log
+*   params: 
+*       NONE
+*   return:
+*       readings count       
+*/
+uint16_t CFlashLog::getRecordsCount() {
+    return m_uiRecordsCount;
+}
+
+/**
+*   Retreive the number of readings after the replay cursor
+*   params: 
+*       NONE
+*   return:
+*       readings count       
+*/
+uint16_t CFlashLog::getPendingCount() {
+    if (m_uiSlotsCount == 0) {
+        return 0;
+    }
+
+    return m_uiPendingCount;
+}
+
+/**
+*   Retreive the timestamp of the oldest reading after the replay cursor
+*   params: 
+*       NONE
+*   return:
+*       timestamp, meaningless if no reading is pending       
+*/
+uint32_t CFlashLog::getOldestPendingTimestamp() {
+    return m_ulOldestPendingTimestamp;
+}
+
+/****************************************************************************************
+ * 
+ *     *****    *****      ***     *       *     *****      *******     ******   
+ *     *    *   *    *      *       *     *     *     *        *        *
+ *     * * *    * * *       *        *   *      * *** *        *        ******
+ *     *        *    *      *         * *       *     *        *        *
+ *     *        *     *    ***         *        *     *        *        ******
+ *   
+ * **************************************************************************************/
+
+/**
+*   Write a record at the head of the log. Entering a row erases it first: the readings it held are dropped
+*   params: 
+*       p_uiDeviceId:       device the reading comes from, FLASH_LOG_CURSOR_DEVICE_ID for a cursor record
+*       p_ulTimestamp:      seconds, clock carried on across restarts by the owner
+*       p_pbySensorValues:  RADIO_SENSOR_VALUES_LENGTH bytes
+*   return:
+*       false if the log is not initialized       
+*/
+boolean CFlashLog::write(uint8_t p_uiDeviceId, uint32_t p_ulTimestamp, const byte *p_pbySensorValues) {
+    STRUCT_FLASH_LOG_RECORD l_strctRecord;
+
+    if (m_uiSlotsCount == 0) {
+        return false;
+    }
+
+    l_strctRecord.uiSequence = m_uiNextSequence;
+    l_strctRecord.uiDeviceId = p_uiDeviceId;
+    l_strctRecord.ulTimestamp = p_ulTimestamp;
+    memcpy(l_strctRecord.abySensorValues, p_pbySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+    l_strctRecord.uiCRC = computeCRC(&l_strctRecord);
+
+    //two steps commit: timestamp and values first, then the word holding sequence and CRC. Until then, the 
+    //slot sequence reads erased and the slot is not a record
+    //NVM controller and page buffer are shared by every log and the settings storage: no other thread may write between the two steps
+    vTaskSuspendAll();
+    m_flash.write((const byte *)&m_pstrctRecords[m_uiHeadSlot] + FLASH_LOG_COMMIT_LENGTH, (const byte *)&l_strctRecord + FLASH_LOG_COMMIT_LENGTH, 
+                    sizeof(STRUCT_FLASH_LOG_RECORD) - FLASH_LOG_COMMIT_LENGTH);
+    m_flash.write(&m_pstrctRecords[m_uiHeadSlot], &l_strctRecord, FLASH_LOG_COMMIT_LENGTH);
+    xTaskResumeAll();
+
+    m_uiHeadSlot = nextSlot(m_uiHeadSlot);
+    m_uiNextSequence = nextSequence(m_uiNextSequence);
+
+    if ((m_uiHeadSlot % FLASH_LOG_RECORDS_PER_ROW) == 0) {
+        eraseHeadRow();
+    }
+
+    return true;
+}
+
+/**
+*   Write a cursor record at the head of the log
+*   params: 
+*       p_uiCursor:         sequence of the next reading to replay
+*   return:
+*       false if the log is not initialized       
+*/
+boolean CFlashLog::writeCursor(uint16_t p_uiCursor) {
+    byte l_abyCursor[RADIO_SENSOR_VALUES_LENGTH];
+
+    if (m_uiSlotsCount == 0) {
+        return false;
+    }
+
+    memset(l_abyCursor, 0, RADIO_SENSOR_VALUES_LENGTH);
+    l_abyCursor[0] = p_uiCursor >> 8;
+    l_abyCursor[1] = p_uiCursor & 0xFF;
+
+    //before the write: the row erase it may trigger must not take the previous cursor record for the newest one
+    m_uiCursorSlot = m_uiHeadSlot;
+    m_bCursorRecorded = true;
+
+    return write(FLASH_LOG_CURSOR_DEVICE_ID, 0, l_abyCursor);
+}
+
+/**
+*   Erase the row the head has entered, one row ahead of the writes: the readings it held are dropped
+*   params: 
+*       NONE
+*   return:
+*       NONE       
+*/
+void CFlashLog::eraseHeadRow() {
+    //every record of the log is more recent than a full log ago
+    uint16_t l_uiDroppedPendingCount = countReadings(m_uiHeadSlot, m_uiHeadSlot + FLASH_LOG_RECORDS_PER_ROW, m_uiReplayCursor);
+
+    m_uiRecordsCount -= countReadings(m_uiHeadSlot, m_uiHeadSlot + FLASH_LOG_RECORDS_PER_ROW, 
+                                        m_uiNextSequence - FLASH_LOG_MAX_ROWS * FLASH_LOG_RECORDS_PER_ROW);
+    m_uiPendingCount -= min(l_uiDroppedPendingCount, m_uiPendingCount);
+    vTaskSuspendAll();
+    m_flash.erase(&m_pstrctRecords[m_uiHeadSlot], FLASH_LOG_ROW_SIZE);
+    xTaskResumeAll();
+
+    //readNext() must not resume from a slot the head has gone past: the walk would miss the readings written behind it
+    if ((m_uiReadSlot / FLASH_LOG_RECORDS_PER_ROW) == (m_uiHeadSlot / FLASH_LOG_RECORDS_PER_ROW)) {
+        m_uiReadSlot = getTailSlot();
+    }
+
+    //readings not replayed yet have been dropped: the cursor follows the oldest reading left
+    if (isOlder(m_uiReplayCursor, getOldestSequence())) {
+        m_uiReplayCursor = getOldestSequence();
+    }
+
+    if (l_uiDroppedPendingCount != 0) {
+        updateOldestPending();
+    }
+
+    //the newest cursor record has been dropped with the row, the older ones with the previous rows: it is written 
+    //again, unless the replay starts from the oldest reading left anyway. Otherwise, a restart would replay readings twice
+    if (m_bCursorRecorded && ((m_uiCursorSlot / FLASH_LOG_RECORDS_PER_ROW) == (m_uiHeadSlot / FLASH_LOG_RECORDS_PER_ROW))) {
+        m_bCursorRecorded = false;
+        if (m_uiReplayCursor != getOldestSequence()) {
+            writeCursor(m_uiReplayCursor);
+        }
+    }
+}
+
+/**
+*   Refresh the timestamp of the oldest pending reading, read at the replay cursor
+*   params: 
+*       NONE
+*   return:
+*       NONE       
+*/
+void CFlashLog::updateOldestPending() {
+    STRUCT_FLASH_LOG_RECORD l_strctRecord;
+    uint16_t l_uiCursor = m_uiReplayCursor;
+
+    m_ulOldestPendingTimestamp = readNext(&l_uiCursor, &l_strctRecord) ? l_strctRecord.ulTimestamp : 0;
+}
+
+/**
+*   Count the readings of a range of slots, from a given sequence
+*   params: 
+*       p_uiFirstSlot:      first slot of the range
+*       p_uiLastSlot:       slot following the range. The range wraps around the end of the area
+*       p_uiFromSequence:   older readings are not counted
+*   return:
+*       readings count       
+*/
+uint16_t CFlashLog::countReadings(uint16_t p_uiFirstSlot, uint16_t p_uiLastSlot, uint16_t p_uiFromSequence) {
+    uint16_t l_uiCount = 0;
+    uint16_t l_uiSlot;
+
+    p_uiLastSlot %= m_uiSlotsCount;
+    l_uiSlot = p_uiFirstSlot;
+    do {
+        if (isReading(&m_pstrctRecords[l_uiSlot]) && !isOlder(m_pstrctRecords[l_uiSlot].uiSequence, p_uiFromSequence)) {
+            l_uiCount++;
+        }
+        l_uiSlot = nextSlot(l_uiSlot);
+    } while (l_uiSlot != p_uiLastSlot);
+
+    return l_uiCount;
+}
+
+/**
+*   Retreive the slot of the oldest records: the row following the head one
+*   params: 
+*       NONE
+*   return:
+*       slot       
+*/
+uint16_t CFlashLog::getTailSlot() {
+    return ((m_uiHeadSlot / FLASH_LOG_RECORDS_PER_ROW + 1) * FLASH_LOG_RECORDS_PER_ROW) % m_uiSlotsCount;
+}
+
+/**
+*   Next slot of the ring
+*   params: 
+*       p_uiSlot:           slot
+*   return:
+*       following slot       
+*/
+uint16_t CFlashLog::nextSlot(uint16_t p_uiSlot) {
+    return (p_uiSlot + 1 < m_uiSlotsCount) ? p_uiSlot + 1 : 0;
+}
+
+/**
+*   Next sequence number, the erased flash value is skipped
+*   params: 
+*       p_uiSequence:       sequence
+*   return:
+*       following sequence       
+*/
+uint16_t CFlashLog::nextSequence(uint16_t p_uiSequence) {
+    p_uiSequence++;
+    return (p_uiSequence == FLASH_LOG_ERASED_SEQUENCE) ? 0 : p_uiSequence;
+}
+
+/**
+*   Check whether a slot is erased and may be written
+*   params: 
+*       p_pstrctRecord:     slot
+*   return:
+*       true if every byte reads 0xFF       
+*/
+boolean CFlashLog::isBlank(const STRUCT_FLASH_LOG_RECORD *p_pstrctRecord) {
+    const byte *l_pbyData = (const byte *)p_pstrctRecord;
+    uint8_t l_uiIndex;
+
+    for (l_uiIndex = 0; l_uiIndex < sizeof(STRUCT_FLASH_LOG_RECORD); l_uiIndex++) {
+        if (l_pbyData[l_uiIndex] != 0xFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+*   Check whether a slot holds a committed record
+*   params: 
+*       p_pstrctRecord:     slot
+*   return:
+*       false if the slot is erased, torn or corrupted       
+*/
+boolean CFlashLog::isValid(const STRUCT_FLASH_LOG_RECORD *p_pstrctRecord) {
+    return (p_pstrctRecord->uiSequence != FLASH_LOG_ERASED_SEQUENCE) && (p_pstrctRecord->uiCRC == computeCRC(p_pstrctRecord));
+}
+
+/**
+*   Check whether a slot holds a committed reading
+*   params: 
+*       p_pstrctRecord:     slot
+*   return:
+*       false if the slot does not hold a record, or holds a cursor record       
+*/
+boolean CFlashLog::isReading(const STRUCT_FLASH_LOG_RECORD *p_pstrctRecord) {
+    return isValid(p_pstrctRecord) && (p_pstrctRecord->uiDeviceId != FLASH_LOG_CURSOR_DEVICE_ID);
+}
+
+/**
+*   Serial number comparison of sequences, valid as long as the log holds less than 32768 records
+*   params: 
+*       p_uiSequence:       sequence
+*       p_uiReference:      sequence compared to
+*   return:
+*       true if p_uiSequence comes before p_uiReference       
+*/
+boolean CFlashLog::isOlder(uint16_t p_uiSequence, uint16_t p_uiReference) {
+    return (int16_t)(p_uiSequence - p_uiReference) < 0;
+}
+
+/**
+*   CRC-8 of a record, CRC byte excluded
+*   params: 
+*       p_pstrctRecord:     record
+*   return:
+*       CRC       
+*/
+uint8_t CFlashLog::computeCRC(const STRUCT_FLASH_LOG_RECORD *p_pstrctRecord) {
+    const byte *l_pbyData = (const byte *)p_pstrctRecord;
+    uint8_t l_uiCRC;
+
+    l_uiCRC = CCRC8::update(FLASH_LOG_CRC_INIT, l_pbyData, offsetof(STRUCT_FLASH_LOG_RECORD, uiCRC));
+    return CCRC8::update(l_uiCRC, &l_pbyData[offsetof(STRUCT_FLASH_LOG_RECORD, uiCRC) + 1], 
+                            sizeof(STRUCT_FLASH_LOG_RECORD) - offsetof(STRUCT_FLASH_LOG_RECORD, uiCRC) - 1);
+}
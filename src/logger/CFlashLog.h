@@ -0,0 +1,96 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#ifndef _CFLASH_LOG_H_
+#define _CFLASH_LOG_H_
+
+#include <Arduino.h>
+#include <FlashStorage.h>
+#include "Global.h"
+#include "CCRC8.h"
+
+#define FLASH_LOG_ROW_SIZE                  256         //SAMD21 NVM erase unit: 4 pages of 64 bytes
+#define FLASH_LOG_RECORDS_PER_ROW           (FLASH_LOG_ROW_SIZE / sizeof(STRUCT_FLASH_LOG_RECORD))
+#define FLASH_LOG_MAX_ROWS                  2047        //sequence numbers are compared modulo 2^16: less than 32768 records
+#define FLASH_LOG_ERASED_SEQUENCE           0xFFFF      //erased flash, never given to a record
+#define FLASH_LOG_CURSOR_DEVICE_ID          0xFF        //replay cursor record, sensor values hold the next sequence to replay
+#define FLASH_LOG_CRC_INIT                  0xA5        //a zeroed slot (fresh firmware image) does not pass the CRC
+#define FLASH_LOG_COMMIT_LENGTH             4           //first flash word of a record: sequence, device and CRC, written last
+
+//one reading, 16 bytes: 4 records per flash page, written one at a time. The first word commits the record
+struct STRUCT_FLASH_LOG_RECORD {
+    uint16_t    uiSequence;                                     //increases by one at each record, FLASH_LOG_ERASED_SEQUENCE skipped
+    uint8_t     uiDeviceId;                                     //FLASH_LOG_CURSOR_DEVICE_ID: replay cursor record
+    uint8_t     uiCRC;                                          //CRC-8 of the other bytes of the record
+    uint32_t    ulTimestamp;                                    //seconds, clock carried on across restarts by the owner
+    byte        abySensorValues[RADIO_SENSOR_VALUES_LENGTH];    //same layout as POST_SENSOR_VALUES data
+} __attribute__ ((packed));     //non aligment pragma
+
+/**
+ *  Append-only circular log of readings, in a flash area of its own (outside of the FlashStorage settings page).
+ *  The area is made of NVM rows; a row is erased as soon as the head of the log enters it, so every row is erased
+ *  once per turn of the ring and the oldest row of readings is dropped when the log is full.
+ *  A record is committed by the last word written, holding its sequence and CRC: a record torn by a power loss
+ *  is skipped and the log is rebuilt from the flash content at init. Sequence numbers order the records; the replay cursor is the
+ *  sequence of the next record to replay, persisted as a cursor record of the log itself.
+ */
+class CFlashLog {
+public:
+    boolean     init(const volatile void *p_pvFlashArea, uint16_t p_uiRowsCount);
+    boolean     append(uint8_t p_uiDeviceId, uint32_t p_ulTimestamp, const byte *p_pbySensorValues);
+    boolean     readNext(uint16_t *p_puiCursor, STRUCT_FLASH_LOG_RECORD *p_pstrctRecord);
+    uint16_t    getOldestSequence();
+    uint32_t    getNewestTimestamp();
+    uint16_t    getReplayCursor();
+    boolean     commitReplayCursor(uint16_t p_uiCursor);
+    uint16_t    getRecordsCount();
+    uint16_t    getPendingCount();
+    uint32_t    getOldestPendingTimestamp();
+
+private:
+    FlashClass                      m_flash;
+    const STRUCT_FLASH_LOG_RECORD   *m_pstrctRecords = NULL;
+    uint16_t                        m_uiSlotsCount = 0;
+    uint16_t                        m_uiHeadSlot;               //next slot written
+    uint16_t                        m_uiNextSequence;
+    uint16_t                        m_uiReplayCursor;
+    uint16_t                        m_uiRecordsCount;           //readings, cursor records excluded
+    uint16_t                        m_uiPendingCount;           //readings from the replay cursor on
+    uint32_t                        m_ulOldestPendingTimestamp; //timestamp of the reading at the replay cursor
+    uint32_t                        m_ulNewestTimestamp;
+    uint16_t                        m_uiReadSlot;               //readNext() resumes from this slot...
+    uint16_t                        m_uiReadSequence;           //...when called with this cursor
+    uint16_t                        m_uiCursorSlot;             //slot of the newest cursor record...
+    boolean                         m_bCursorRecorded;          //...if the log holds one
+
+    boolean     write(uint8_t p_uiDeviceId, uint32_t p_ulTimestamp, const byte *p_pbySensorValues);
+    boolean     writeCursor(uint16_t p_uiCursor);
+    void        eraseHeadRow();
+    uint16_t    countReadings(uint16_t p_uiFirstSlot, uint16_t p_uiLastSlot, uint16_t p_uiFromSequence);
+    void        updateOldestPending();
+    uint16_t    getTailSlot();
+    uint16_t    nextSlot(uint16_t p_uiSlot);
+    uint16_t    nextSequence(uint16_t p_uiSequence);
+    boolean     isBlank(const STRUCT_FLASH_LOG_RECORD *p_pstrctRecord);
+    boolean     isValid(const STRUCT_FLASH_LOG_RECORD *p_pstrctRecord);
+    boolean     isReading(const STRUCT_FLASH_LOG_RECORD *p_pstrctRecord);
+    boolean     isOlder(uint16_t p_uiSequence, uint16_t p_uiReference);
+    uint8_t     computeCRC(const STRUCT_FLASH_LOG_RECORD *p_pstrctRecord);
+};
+
+#endif
@@ -2,11 +2,13 @@
 #include "Global.h"
 #include "Logging.h"
 #include "CHTU21.h"
-#include "radio\CCC1100.h"
+#include "radio/CCC1100.h"
+#include "radio/CSamplesCodec.h"
 #include "CATSettings.h"
+#include "logger/CFlashLog.h"
 
 #ifdef BRIDGE_MODE
-  #include "bridge\CBridge.h"
+  #include "bridge/CBridge.h"
 #endif
 
 #define TIMER_PERIOD                                     10       //TIMER5 PERIO => 10ms
@@ -15,12 +17,26 @@
 FlashStorage(_g_flashSettings, STRUCT_FLASH_SETTINGS);           //store global settings
 FlashStorage(_g_flashStorageSignatureID, uint16_t);              //store a 2 bytes signature (FLASH_SIGNATURE_ID) in order to ensure that settings above are relevant
 
+#ifdef BRIDGE_MODE
+  //FLASH bridge outbox: readings not uploaded yet
+  __attribute__((__aligned__(FLASH_LOG_ROW_SIZE))) static const uint8_t g_abyBridgeOutboxArea[BRIDGE_OUTBOX_ROWS * FLASH_LOG_ROW_SIZE] = { };
+#else
+  //FLASH data logger: readings the outbox could not hold, NVM rows of its own, outside of the settings pages
+  __attribute__((__aligned__(FLASH_LOG_ROW_SIZE))) static const uint8_t g_abyFlashLogArea[FLASH_LOG_ROWS * FLASH_LOG_ROW_SIZE] = { };
+#endif
+
 //objects instantiation
 static CHTU21 g_htu21Device;
 static CCC1100 g_cc1101Device;
+static CSamplesCodec g_samplesCodec;
 static CFlashLed g_statusFlashLed;
 #ifdef BRIDGE_MODE
   static CBridge g_bridgeDrv;
+  static CDownlinkQueue g_downlinkQueue;
+  static CDeviceLiveness g_deviceLiveness;
+  static CDeviceCache g_deviceCache;
+#else
+  static CFlashLog g_flashLog;
 #endif
 static CATSettings g_ATSettings;
 
@@ -31,14 +47,14 @@ StaticTask_t g_xTCBTaskSensorValues;
 StackType_t g_xBufferTaskSensorValues[X_BUFFER_TASK_SENSOR_VALUES_SIZE];
 
 //FreeRTOS TASK - RADIO MANAGEMENT
-#define X_BUFFER_TASK_RADIO                               256
+#define X_BUFFER_TASK_RADIO                               384         //122 bytes message buffers held along the transmit and receive paths
 TaskHandle_t g_xHandleTaskRadio;
 StaticTask_t g_xTCBTaskRadio;
 StackType_t g_xBufferTaskRadio[X_BUFFER_TASK_RADIO];
 
 //FreeRTOS TASK - WIFI INTERFACE MANAGEMENT
 #ifdef BRIDGE_MODE
-  #define X_BUFFER_TASK_BRIDGE                            256
+  #define X_BUFFER_TASK_BRIDGE                            320
   TaskHandle_t g_xHandleTaskBridge;
   StaticTask_t g_xTCBTaskBridge;
   StackType_t g_xBufferTaskBridge[X_BUFFER_TASK_BRIDGE];
@@ -69,8 +85,9 @@ QueueHandle_t g_xQueueSensorValuesHandle;
 
 //FreeRTOS QUEUE - devices messages dispatching
 #ifdef BRIDGE_MODE
-  #define X_QUEUE_BRIDGE_LENGTH                     10
+  #define X_QUEUE_BRIDGE_LENGTH                     (10 + MAX_RADIO_AGGREGATED_SAMPLES)      //room for an expanded aggregated frame
   #define X_QUEUE_BRIDGE_SIZE                       sizeof(STRUCT_X_QUEUE_POST_MSG)
+  #define X_QUEUE_BRIDGE_OWN_SLOTS                  1                                        //kept for the bridge own reading, never given to the radio
   uint8_t g_xQueueBridgeHandleBuffer[X_QUEUE_BRIDGE_LENGTH * X_QUEUE_BRIDGE_SIZE];
   static StaticQueue_t g_xQueueBridgeHandleStatic;
   QueueHandle_t g_xQueueBridgeHandle;
@@ -97,6 +114,7 @@ StaticEventGroup_t  g_xEventGroupTimersStatic;
 #define BIT_EVENT_GROUP_TIMERS__READ_SENSOR_VALUES_TIMER_EXPIRES      (1 << 0)
 #define BIT_EVENT_GROUP_TIMERS__SEND_DEVICE_KEEP_ALIVE_TIMER_EXPIRES  (1 << 1)
 #define BIT_EVENT_GROUP_TIMERS__SEND_API_KEEP_ALIVE_TIMER_EXPIRES     (1 << 2)
+#define BIT_EVENT_GROUP_TIMERS__FORCE_SENSOR_VALUES_SENDING           (1 << 3)      //next reading is sent even within dead-bands
 
 //FreeRTOS GROUP EVENT - MISCELLANEOUS FLAGS
 EventGroupHandle_t  g_xEventGroupMiscellaneousHandle;
@@ -116,11 +134,281 @@ StaticTimer_t g_xTimerReadSensrValuesStatic;
 
 STRUCT_GLOBAL_SETTINGS_AND_STATUS g_globalSettingsAndStatus;
 
+#ifndef BRIDGE_MODE
+  //outbox: readings waiting to be sent into an aggregated frame, or not delivered yet, oldest first
+  STRUCT_RADIO_AGGREGATED_SAMPLE g_astrctAggregatedSamples[MAX_RADIO_AGGREGATED_SAMPLES];
+  TickType_t g_axAggregatedSamplesTick[MAX_RADIO_AGGREGATED_SAMPLES];
+  byte g_byAggregatedSamplesCount = 0;
+  CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE g_strctAggregatedRadioBuffer;
+
+  //retry scheduler of undelivered readings
+  uint32_t g_ulRetryDelay = 0;              //sec, backoff delay. 0: last sending delivered
+  boolean g_bSendingDeferred = false;       //readings wait into the outbox until the retry
+  TickType_t g_xRetryTick;
+  TickType_t g_xRetryWait;                  //backoff delay with jitter, or hold-off requested by the bridge-server
+
+  uint32_t g_ulFlashLogTimeBase = 0;        //sec, flash log clock goes on from the newest reading logged before the restart
+#endif
+
 int g_iJumberRebounceLastISRTimeMillis = 0;
 
 Adafruit_USBD_WebUSB g_USBWeb;
 Adafruit_USBD_CDC g_USBSerial;
 
+/**
+*   radio GDO2 interrupt handling callback: RX FIFO reached its threshold or a packet ended
+*   params: 
+*     NONE
+*   return:
+*       NONE       
+*/
+void radioInterruptPinCallback(void) {
+  BaseType_t l_xHigherPriorityTaskWoken = pdFALSE;
+
+  g_cc1101Device.interruptHandler();
+
+  //wake radio thread up in order to drain the RX FIFO
+  vTaskNotifyGiveFromISR(g_xHandleTaskRadio, &l_xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR( l_xHigherPriorityTaskWoken );
+}
+
+/**
+*   I2C SERCOM interrupt handling: HTU21 transactions progress
+*   params: 
+*     NONE
+*   return:
+*       NONE       
+*/
+void WIRE_IT_HANDLER(void) {
+  BaseType_t l_xHigherPriorityTaskWoken = pdFALSE;
+
+  //wake sensor values thread up once the transaction is over
+  if (g_htu21Device.interruptHandler()) {
+    vTaskNotifyGiveFromISR(g_xHandleTaskSensorValues, &l_xHigherPriorityTaskWoken);
+  }
+  portYIELD_FROM_ISR( l_xHigherPriorityTaskWoken );
+}
+
+#ifndef BRIDGE_MODE
+/**
+*   Send the pending readings to the bridge-server within delta coded aggregated frames, as many readings per frame as
+*   the current link profile allows. Readings are removed once acknowledged
+*   params: 
+*     p_byRecipientAddr:    bridge-server address
+*     p_byTXRetryMax:       number of retries if no acknowledge is received
+*   return:
+*     true if all pending readings have been delivered       
+*/
+static boolean postAggregatedSamples(byte p_byRecipientAddr, byte p_byTXRetryMax) {
+  byte l_bySamplesCount;
+  byte l_bySampleIndex;
+  TickType_t l_xTickCount;
+
+  while (g_byAggregatedSamplesCount != 0) {
+    l_xTickCount = xTaskGetTickCount();
+
+    g_samplesCodec.startEncoding(g_strctAggregatedRadioBuffer.abyData, g_cc1101Device.getMaxMessageDataLength());
+
+    for (l_bySampleIndex = 0; l_bySampleIndex < g_byAggregatedSamplesCount; l_bySampleIndex++) {
+      g_astrctAggregatedSamples[l_bySampleIndex].uiTimeOffset = min((l_xTickCount - g_axAggregatedSamplesTick[l_bySampleIndex]) / configTICK_RATE_HZ, (TickType_t)0xFFFF);
+
+      if (!g_samplesCodec.addSample(&g_astrctAggregatedSamples[l_bySampleIndex])) {
+        break;
+      }
+    }
+
+    l_bySamplesCount = g_samplesCodec.getSamplesCount();
+    g_strctAggregatedRadioBuffer.byMessageType = ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES_AGGREGATED;
+    g_strctAggregatedRadioBuffer.byDataLength = g_samplesCodec.getEncodedLength();
+
+    LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "aggregated bytes per sample x10", (g_samplesCodec.getEncodedLength() * 10) / l_bySamplesCount);
+
+    if (!g_cc1101Device.postMessage(p_byRecipientAddr, &g_strctAggregatedRadioBuffer, p_byTXRetryMax)) {
+      return false;
+    }
+
+    //delivered data proves the device alive: no keep-alive within the next period
+    xTimerReset(g_xTimerDeviceKeepAliveHandle, 0);
+
+    g_byAggregatedSamplesCount -= l_bySamplesCount;
+    memmove(&g_astrctAggregatedSamples[0], &g_astrctAggregatedSamples[l_bySamplesCount], g_byAggregatedSamplesCount * sizeof(STRUCT_RADIO_AGGREGATED_SAMPLE));
+    memmove(&g_axAggregatedSamplesTick[0], &g_axAggregatedSamplesTick[l_bySamplesCount], g_byAggregatedSamplesCount * sizeof(TickType_t));
+  }
+
+  return true;
+}
+
+/**
+*   Flash log clock: seconds since boot, going on from the newest reading logged so that the ages of readings 
+*   logged before a restart stay right
+*   params: 
+*     NONE
+*   return:
+*     flash log time (sec)       
+*/
+static uint32_t getFlashLogTime() {
+  return g_ulFlashLogTimeBase + xTaskGetTickCount() / configTICK_RATE_HZ;
+}
+
+/**
+*   Add a reading to the outbox. When the outbox is full, the oldest reading is moved into the flash log, and 
+*   sent again once the link is back
+*   params: 
+*     p_pstrctSensorValues: reading
+*   return:
+*     NONE       
+*/
+static void addAggregatedSample(STRUCT_X_QUEUE_SENSOR_VALUES *p_pstrctSensorValues) {
+  uint32_t l_ulTime;
+  uint32_t l_ulAge;
+
+  if (g_byAggregatedSamplesCount == MAX_RADIO_AGGREGATED_SAMPLES) {
+    l_ulTime = getFlashLogTime();
+    l_ulAge = (xTaskGetTickCount() - g_axAggregatedSamplesTick[0]) / configTICK_RATE_HZ;
+    if (!g_flashLog.append(g_globalSettingsAndStatus.strctRadioSettings.uiDeviceID, (l_ulAge < l_ulTime) ? (l_ulTime - l_ulAge) : 0, 
+                           g_astrctAggregatedSamples[0].abySensorValues)) {
+      LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Flash log append", "FAILED");
+    }
+
+    g_byAggregatedSamplesCount--;
+    memmove(&g_astrctAggregatedSamples[0], &g_astrctAggregatedSamples[1], g_byAggregatedSamplesCount * sizeof(STRUCT_RADIO_AGGREGATED_SAMPLE));
+    memmove(&g_axAggregatedSamplesTick[0], &g_axAggregatedSamplesTick[1], g_byAggregatedSamplesCount * sizeof(TickType_t));
+  }
+
+  memcpy(g_astrctAggregatedSamples[g_byAggregatedSamplesCount].abySensorValues, &p_pstrctSensorValues->byTemperatureQuotientValue, RADIO_SENSOR_VALUES_LENGTH);
+  g_axAggregatedSamplesTick[g_byAggregatedSamplesCount] = xTaskGetTickCount();
+  g_byAggregatedSamplesCount++;
+}
+
+/**
+*   Move readings logged into flash back to the outbox, oldest first, as many as the outbox can take. The replay 
+*   cursor is committed right away: a reading is held either by the outbox or by the flash log, never by both
+*   params: 
+*     NONE
+*   return:
+*     NONE       
+*/
+static void replayFlashLog() {
+  STRUCT_FLASH_LOG_RECORD l_strctRecord;
+  uint16_t l_uiCursor = g_flashLog.getReplayCursor();
+  uint32_t l_ulTime = getFlashLogTime();
+  uint32_t l_ulAge;
+  TickType_t l_xTickCount = xTaskGetTickCount();
+
+  while ((g_byAggregatedSamplesCount < MAX_RADIO_AGGREGATED_SAMPLES) && g_flashLog.readNext(&l_uiCursor, &l_strctRecord)) {
+    //the aggregated frame time offset saturates anyway
+    l_ulAge = min((l_strctRecord.ulTimestamp < l_ulTime) ? (l_ulTime - l_strctRecord.ulTimestamp) : 0, (uint32_t)0xFFFF);
+
+    memcpy(g_astrctAggregatedSamples[g_byAggregatedSamplesCount].abySensorValues, l_strctRecord.abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+    g_axAggregatedSamplesTick[g_byAggregatedSamplesCount] = l_xTickCount - (TickType_t)l_ulAge * configTICK_RATE_HZ;
+    g_byAggregatedSamplesCount++;
+  }
+
+  if (!g_flashLog.commitReplayCursor(l_uiCursor)) {
+    LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Flash log replay cursor", "FAILED");
+  }
+}
+
+/**
+*   Schedule the next attempt after a sending: exponential backoff, half of the delay being random so that 
+*   devices sharing a bridge-server do not retry all together. A congested bridge-server may ask for a 
+*   longer hold-off, even when the reading has been delivered
+*   params: 
+*     p_bDelivered:         sending result, the backoff is reset once delivered
+*   return:
+*     NONE       
+*/
+static void scheduleRetry(boolean p_bDelivered) {
+  TickType_t l_xHoldOff = pdMS_TO_TICKS(g_cc1101Device.getHoldOff() * 1000);
+
+  if (p_bDelivered) {
+    g_ulRetryDelay = 0;
+    g_xRetryWait = 0;
+  } else {
+    g_ulRetryDelay = (g_ulRetryDelay == 0) ? RADIO_RETRY_MIN_DELAY : min(g_ulRetryDelay * 2, (uint32_t)RADIO_RETRY_MAX_DELAY);
+    g_xRetryWait = pdMS_TO_TICKS(random(g_ulRetryDelay * 500, g_ulRetryDelay * 1000 + 1));
+  }
+
+  g_xRetryWait = max(g_xRetryWait, l_xHoldOff);
+  g_xRetryTick = xTaskGetTickCount();
+  g_bSendingDeferred = (g_xRetryWait != 0);
+
+  if (g_bSendingDeferred) {
+    LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "Retry in (ms)", g_xRetryWait * portTICK_PERIOD_MS);
+  }
+}
+
+/**
+*   Apply the downlink commands received with the last acknowledge: settings are changed right away, and saved 
+*   only if a value actually changed. A command received twice, its confirmation being lost, changes nothing the 
+*   second time
+*   params: 
+*     NONE
+*   return:
+*     NONE       
+*/
+static void applyDownlinkCommands() {
+  STRUCT_RADIO_DOWNLINK_COMMAND l_astrctCommands[RADIO_DOWNLINK_MAX_COMMANDS];
+  byte l_byCommandsCount = g_cc1101Device.getDownlinkCommands(l_astrctCommands);
+  byte l_byCommandIndex;
+  boolean l_bChanged = false;
+
+  for (l_byCommandIndex = 0; l_byCommandIndex < l_byCommandsCount; l_byCommandIndex++) {
+    LOG_INFO_PRINTLN(LOG_PREFIX_MAIN, "Downlink command", l_astrctCommands[l_byCommandIndex].uiCommand);
+
+    switch (l_astrctCommands[l_byCommandIndex].uiCommand) {
+      case ENM_RADIO_DOWNLINK_COMMAND::SET_MEASUREMENT_TIMEOUT:
+        if ((l_astrctCommands[l_byCommandIndex].uiValue != 0) && 
+            (g_globalSettingsAndStatus.strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout != l_astrctCommands[l_byCommandIndex].uiValue)) {
+          g_globalSettingsAndStatus.strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout = l_astrctCommands[l_byCommandIndex].uiValue;
+          l_bChanged = true;
+        }
+      break;
+
+      case ENM_RADIO_DOWNLINK_COMMAND::SET_OUTPUT_POWER:
+        if ((l_astrctCommands[l_byCommandIndex].uiValue >= CCC1100::ENM_OUTPUT_POWER_DBM::MINUS_30) && 
+            (l_astrctCommands[l_byCommandIndex].uiValue <= CCC1100::ENM_OUTPUT_POWER_DBM::PLUS_10) &&
+            (g_globalSettingsAndStatus.strctRadioSettings.uiOutputPower != l_astrctCommands[l_byCommandIndex].uiValue)) {
+          g_globalSettingsAndStatus.strctRadioSettings.uiOutputPower = l_astrctCommands[l_byCommandIndex].uiValue;
+          g_cc1101Device.setOutputPowerLevel((CCC1100::ENM_OUTPUT_POWER_DBM)l_astrctCommands[l_byCommandIndex].uiValue);
+          l_bChanged = true;
+        }
+      break;
+
+      case ENM_RADIO_DOWNLINK_COMMAND::SET_TEMPERATURE_DEAD_BAND:
+        if (g_globalSettingsAndStatus.strctMiscellaneousSettings.uiTemperatureDeadBand != l_astrctCommands[l_byCommandIndex].uiValue) {
+          g_globalSettingsAndStatus.strctMiscellaneousSettings.uiTemperatureDeadBand = l_astrctCommands[l_byCommandIndex].uiValue;
+          l_bChanged = true;
+        }
+      break;
+
+      case ENM_RADIO_DOWNLINK_COMMAND::SET_HUMIDITY_DEAD_BAND:
+        if (g_globalSettingsAndStatus.strctMiscellaneousSettings.uiHumidityDeadBand != l_astrctCommands[l_byCommandIndex].uiValue) {
+          g_globalSettingsAndStatus.strctMiscellaneousSettings.uiHumidityDeadBand = l_astrctCommands[l_byCommandIndex].uiValue;
+          l_bChanged = true;
+        }
+      break;
+
+      case ENM_RADIO_DOWNLINK_COMMAND::SET_MAX_SILENCE_INTERVAL:
+        if (g_globalSettingsAndStatus.strctMiscellaneousSettings.uiMaxSilenceInterval != l_astrctCommands[l_byCommandIndex].uiValue) {
+          g_globalSettingsAndStatus.strctMiscellaneousSettings.uiMaxSilenceInterval = l_astrctCommands[l_byCommandIndex].uiValue;
+          l_bChanged = true;
+        }
+      break;
+
+      default:
+        LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Unknown downlink command", l_astrctCommands[l_byCommandIndex].uiCommand);
+      break;
+    }
+  }
+
+  //nothing changed: no reload and no flash wear
+  if (l_bChanged) {
+    xEventGroupSetBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__RELOAD_SENSOR_SETTINGS | BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_SAVE_SETTINGS);
+  }
+}
+#endif
+
 /**
 *   RADIO THREAD: manage RADIO incoming and outgoing message 
 *
@@ -134,8 +422,12 @@ static void thread_Radio( void *pvParameters ) {
   CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctRadioBuffer;
 #ifdef BRIDGE_MODE
   int16_t l_iSenderAddr;
+  STRUCT_RADIO_AGGREGATED_SAMPLE l_strctSample;
+  UBaseType_t l_uxQueueSpaces;
+  byte l_byOccupancy;
 #endif
   STRUCT_RADIO_SETTINGS l_readioSettings;
+  byte l_byLinkProfile;
 
 #ifndef BRIDGE_MODE
     boolean l_bStatus;
@@ -143,25 +435,55 @@ static void thread_Radio( void *pvParameters ) {
 
   memcpy(&l_readioSettings, pvParameters, sizeof(STRUCT_RADIO_SETTINGS));
 
+#ifndef BRIDGE_MODE
+  //retry jitter differs from a device to another
+  randomSeed(*(unsigned int *)0x0080A00C ^ *(unsigned int *)0x0080A040 ^ *(unsigned int *)0x0080A044 ^ *(unsigned int *)0x0080A048);
+#endif
+
   //delete current thread if initalization failed
   if (!g_cc1101Device.init(l_readioSettings.uiDeviceID, 
                           (CCC1100::ENM_OUTPUT_POWER_DBM)l_readioSettings.uiOutputPower, 
-                          l_readioSettings.uiMessageSignature)) {
+                          l_readioSettings.uiMessageSignature,
+                          l_readioSettings.uiChannel,
+#ifdef BRIDGE_MODE
+                          l_readioSettings.uiHoppingDwellTime,
+                          (CCC1100::ENM_FEC_MODE)l_readioSettings.uiFECMode)) {
+#else
+                          0,
+                          CCC1100::ENM_FEC_MODE::FEC_OFF)) {
+#endif
     vTaskDelete( NULL );
   }
 
+  attachInterrupt(digitalPinToInterrupt(PIN_CC1100_GD02), radioInterruptPinCallback, RISING);
+
+#ifdef BRIDGE_MODE
+  //pending commands are sent within the acknowledges of their device
+  g_cc1101Device.setDownlinkQueue(&g_downlinkQueue);
+#endif
+
   xTimerStart(g_xTimerDeviceKeepAliveHandle, 0);
 
   while (1) {
 #ifdef BRIDGE_MODE
+  //back-pressure: messages are acknowledged only while the upload pipeline can take each of their readings
+  l_uxQueueSpaces = uxQueueSpacesAvailable(g_xQueueBridgeHandle);
+  l_byOccupancy = ((X_QUEUE_BRIDGE_LENGTH - l_uxQueueSpaces) * 100) / X_QUEUE_BRIDGE_LENGTH;
+  g_cc1101Device.setBackPressure((l_uxQueueSpaces > X_QUEUE_BRIDGE_OWN_SLOTS) ? l_uxQueueSpaces - X_QUEUE_BRIDGE_OWN_SLOTS : 0, l_byOccupancy, 
+                                  (l_byOccupancy >= RADIO_CONGESTION_THRESHOLD) ? (RADIO_CONGESTION_MAX_HOLD_OFF * l_byOccupancy) / 100 : 0);
+
   //pool RADIO in order to check if an incoming payload is pending
   if (g_cc1101Device.poll()) {
     l_iSenderAddr = g_cc1101Device.getMessage(&l_strctRadioBuffer);
     LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "receive radio", l_iSenderAddr);
 
     if (l_iSenderAddr != -1) {
+      //any message proves its sender alive
+      g_deviceLiveness.update(l_iSenderAddr, g_cc1101Device.getMessageRSSI());
+
       switch(l_strctRadioBuffer.byMessageType) {
         case ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES:
+        case ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES_STATISTICS:
           l_strctPostMessage.enmMsgType = ENM_X_QUEUE_POST_MSG_TYPE::POST_DEVICE_SENSOR_VALUES;
           l_strctPostMessage.strctSensorValues.uiDeviceId = l_iSenderAddr;
           l_strctPostMessage.strctSensorValues.byTemperatureQuotientValue = l_strctRadioBuffer.abyData[0];
@@ -172,25 +494,51 @@ static void thread_Radio( void *pvParameters ) {
           l_strctPostMessage.strctSensorValues.byPartialPressureRemaindertValue = l_strctRadioBuffer.abyData[5];
           l_strctPostMessage.strctSensorValues.byDewPointeQuotientValue = l_strctRadioBuffer.abyData[6];
           l_strctPostMessage.strctSensorValues.byDewPointRemaindertValue = l_strctRadioBuffer.abyData[7];
+          l_strctPostMessage.strctSensorValues.ulSampleAge = 0;
+
+          memset(&l_strctPostMessage.strctSensorValues.strctStatistics, 0, sizeof(STRUCT_SENSOR_STATISTICS));
+          if ((l_strctRadioBuffer.byMessageType == ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES_STATISTICS) && 
+              (l_strctRadioBuffer.byDataLength >= RADIO_SENSOR_VALUES_LENGTH + sizeof(STRUCT_SENSOR_STATISTICS))) {
+            memcpy(&l_strctPostMessage.strctSensorValues.strctStatistics, &l_strctRadioBuffer.abyData[RADIO_SENSOR_VALUES_LENGTH], sizeof(STRUCT_SENSOR_STATISTICS));
+          }
+
+          g_deviceCache.update(l_iSenderAddr, l_strctRadioBuffer.abyData, 0, g_cc1101Device.getMessageRSSI(), g_cc1101Device.getMessageLQI());
+          if (xQueueSendToBack(g_xQueueBridgeHandle, ( void * )&l_strctPostMessage, 0/*portMAX_DELAY*/) != pdPASS) {
+            LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Bridge queue full, reading lost from device", l_iSenderAddr);
+          }
+        break;
 
-
-          xQueueSendToBack(g_xQueueBridgeHandle, ( void * )&l_strctPostMessage, 0/*portMAX_DELAY*/);
+        case ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES_AGGREGATED:
+          //decode and expand readings into the upload pipeline. A truncated frame stops at the last complete reading
+          g_samplesCodec.startDecoding(l_strctRadioBuffer.abyData, min(l_strctRadioBuffer.byDataLength, (byte)MAX_RADIO_MESSAGE_DATA_LENGTH));
+
+          while (g_samplesCodec.getNextSample(&l_strctSample)) {
+            l_strctPostMessage.enmMsgType = ENM_X_QUEUE_POST_MSG_TYPE::POST_DEVICE_SENSOR_VALUES;
+            l_strctPostMessage.strctSensorValues.uiDeviceId = l_iSenderAddr;
+            memcpy(&l_strctPostMessage.strctSensorValues.byTemperatureQuotientValue, l_strctSample.abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+            l_strctPostMessage.strctSensorValues.ulSampleAge = l_strctSample.uiTimeOffset;
+            memset(&l_strctPostMessage.strctSensorValues.strctStatistics, 0, sizeof(STRUCT_SENSOR_STATISTICS));
+
+            g_deviceCache.update(l_iSenderAddr, l_strctSample.abySensorValues, l_strctSample.uiTimeOffset, g_cc1101Device.getMessageRSSI(), g_cc1101Device.getMessageLQI());
+            if (xQueueSendToBack(g_xQueueBridgeHandle, ( void * )&l_strctPostMessage, 0/*portMAX_DELAY*/) != pdPASS) {
+              LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Bridge queue full, reading lost from device", l_iSenderAddr);
+            }
+          }
         break;
 
         case ENM_RADIO_MSG_TYPE::KEEP_ALIVE:
-          l_strctPostMessage.enmMsgType = ENM_X_QUEUE_POST_MSG_TYPE::POST_DEVICE_KEEP_ALIVE;
-          l_strctPostMessage.strctDeviceKeepAlive.uiDeviceId = l_iSenderAddr;
+          //reported with the bridge heartbeat, cf CDeviceLiveness
+        break;
 
-          xQueueSendToBack(g_xQueueBridgeHandle, ( void * )&l_strctPostMessage, 0/*portMAX_DELAY*/);
-      
         default:
         break;
       }
     }
   }
 #else
-  //send sensor values to device bridge-server
-  if (xQueueReceive(g_xQueueSensorValuesHandle, &l_strctPostMessage, 0)) {
+  //send sensor values to device bridge-server, right away when nothing is waiting in the outbox
+  if ((l_readioSettings.uiAggregatedSamples <= 1) && (g_byAggregatedSamplesCount == 0) && !g_bSendingDeferred && 
+      xQueueReceive(g_xQueueSensorValuesHandle, &l_strctPostMessage, 0)) {
     l_strctRadioBuffer.byMessageType = ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES;
     l_strctRadioBuffer.byDataLength = 8;
     l_strctRadioBuffer.abyData[0] = l_strctPostMessage.strctSensorValues.byTemperatureQuotientValue;
@@ -203,23 +551,64 @@ static void thread_Radio( void *pvParameters ) {
     l_strctRadioBuffer.abyData[6] = l_strctPostMessage.strctSensorValues.byDewPointeQuotientValue;
     l_strctRadioBuffer.abyData[7] = l_strctPostMessage.strctSensorValues.byDewPointRemaindertValue;
 
+    //oversampled measurement: burst statistics follow the values, unless the link profile cannot carry them (FEC).
+    //The plain values are sent then
+    if ((l_strctPostMessage.strctSensorValues.strctStatistics.uiSamplesCount > 1) && 
+        (RADIO_SENSOR_VALUES_LENGTH + sizeof(STRUCT_SENSOR_STATISTICS) <= g_cc1101Device.getMaxMessageDataLength())) {
+      l_strctRadioBuffer.byMessageType = ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES_STATISTICS;
+      memcpy(&l_strctRadioBuffer.abyData[8], &l_strctPostMessage.strctSensorValues.strctStatistics, sizeof(STRUCT_SENSOR_STATISTICS));
+      l_strctRadioBuffer.byDataLength += sizeof(STRUCT_SENSOR_STATISTICS);
+    }
+
     l_bStatus = g_cc1101Device.postMessage(l_readioSettings.uiServerID, &l_strctRadioBuffer, l_readioSettings.uiMaxRetries);
-    //if sending failed, restart immediatly by simulating a event timer expiration
+    //if sending failed or was refused, the reading is kept into the outbox and sent again by the retry scheduler.
+    //Delivered data proves the device alive: no keep-alive within the next period
     if (!l_bStatus) {
-      xEventGroupSetBits(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__READ_SENSOR_VALUES_TIMER_EXPIRES);
+      addAggregatedSample(&l_strctPostMessage.strctSensorValues);
+    } else {
+      xTimerReset(g_xTimerDeviceKeepAliveHandle, 0);
     }
+    scheduleRetry(l_bStatus);
 
     LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "POST SENSOR VALUES to SERVER", l_bStatus ? "OK" : "NOK");
   }
+
+  //aggregate readings, sent once enough of them are pending. Readings wait behind undelivered ones, or during 
+  //the bridge-server hold-off, until the next retry
+  if (((l_readioSettings.uiAggregatedSamples > 1) || (g_byAggregatedSamplesCount != 0) || g_bSendingDeferred) && 
+      xQueueReceive(g_xQueueSensorValuesHandle, &l_strctPostMessage, 0)) {
+    addAggregatedSample(&l_strctPostMessage.strctSensorValues);
+
+    if (!g_bSendingDeferred && (g_byAggregatedSamplesCount >= l_readioSettings.uiAggregatedSamples)) {
+      l_bStatus = postAggregatedSamples(l_readioSettings.uiServerID, l_readioSettings.uiMaxRetries);
+      scheduleRetry(l_bStatus);
+      LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "POST AGGREGATED SENSOR VALUES to SERVER", l_bStatus ? "OK" : "NOK");
+    }
+  }
+
+  //retry scheduler: undelivered readings are sent again in order, aggregated, once the backoff delay has elapsed
+  if (g_bSendingDeferred && ((xTaskGetTickCount() - g_xRetryTick) >= g_xRetryWait)) {
+    l_bStatus = postAggregatedSamples(l_readioSettings.uiServerID, l_readioSettings.uiMaxRetries);
+    scheduleRetry(l_bStatus);
+    LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "RETRY SENSOR VALUES to SERVER", l_bStatus ? "OK" : "NOK");
+  }
+
+  //link back and outbox drained: readings logged into flash are sent again, a batch at a time
+  if (!g_bSendingDeferred && (g_byAggregatedSamplesCount == 0) && (g_flashLog.getPendingCount() != 0)) {
+    replayFlashLog();
+    l_bStatus = postAggregatedSamples(l_readioSettings.uiServerID, l_readioSettings.uiMaxRetries);
+    scheduleRetry(l_bStatus);
+    LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "REPLAY LOGGED SENSOR VALUES to SERVER", l_bStatus ? "OK" : "NOK");
+  }
 #endif
 
  //wait for BIT_EVENT_GROUP_TIMERS__SEND_API_KEEP_ALIVE_TIMER_EXPIRES to bet set, meaning timer g_timerMinDeviceKeepAlive has expired
   if (xEventGroupWaitBits(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__SEND_DEVICE_KEEP_ALIVE_TIMER_EXPIRES, pdTRUE, pdFALSE, 0) & BIT_EVENT_GROUP_TIMERS__SEND_DEVICE_KEEP_ALIVE_TIMER_EXPIRES) {
 #ifdef BRIDGE_MODE
-    l_strctPostMessage.enmMsgType = ENM_X_QUEUE_POST_MSG_TYPE::POST_DEVICE_KEEP_ALIVE;
-    l_strctPostMessage.strctSensorValues.uiDeviceId = l_readioSettings.uiDeviceID;
-    
-    xQueueSendToBack(g_xQueueBridgeHandle, ( void * )&l_strctPostMessage, 0/*portMAX_DELAY*/);
+    //keep-alive period elapsed: devices heard, the bridge itself included, are reported with the bridge heartbeat
+    g_deviceLiveness.update(l_readioSettings.uiDeviceID, 0);
+    g_deviceLiveness.closePeriod();
+    xEventGroupSetBits(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__SEND_API_KEEP_ALIVE_TIMER_EXPIRES);
 #else
     l_strctRadioBuffer.byMessageType = ENM_RADIO_MSG_TYPE::KEEP_ALIVE;
     l_strctRadioBuffer.byDataLength = 0;
@@ -229,10 +618,59 @@ static void thread_Radio( void *pvParameters ) {
 #endif
   }
 
-    vTaskDelay(pdMS_TO_TICKS(100));
+#ifndef BRIDGE_MODE
+  //commands received within the acknowledges of the messages above
+  applyDownlinkCommands();
+#endif
+
+    g_globalSettingsAndStatus.strctRadioStatus.uiCurrentChannel = g_cc1101Device.getChannel();
+    g_globalSettingsAndStatus.strctRadioStatus.uiChannelBlacklist = g_cc1101Device.getChannelBlacklist();
+    g_globalSettingsAndStatus.strctRadioStatus.uiLinkProfile = g_cc1101Device.getLinkProfile();
+    for (l_byLinkProfile = 0; l_byLinkProfile < RADIO_LINK_PROFILES_COUNT; l_byLinkProfile++) {
+      memcpy(&g_globalSettingsAndStatus.strctRadioStatus.astrctLinkStats[l_byLinkProfile], 
+              g_cc1101Device.getLinkStats((CCC1100::ENM_LINK_PROFILE)l_byLinkProfile), sizeof(STRUCT_RADIO_LINK_STATS));
+    }
+#ifdef BRIDGE_MODE
+    g_globalSettingsAndStatus.strctMiscellaneousStatus.uiDownlinkPending = g_downlinkQueue.getCount();
+    g_globalSettingsAndStatus.strctMiscellaneousStatus.uiAliveDevices = g_deviceLiveness.getAliveCount();
+    g_globalSettingsAndStatus.strctMiscellaneousStatus.uiLostDevices = g_deviceLiveness.getLostCount();
+#else
+    g_globalSettingsAndStatus.strctMiscellaneousStatus.uiLoggedReadings = g_flashLog.getPendingCount();
+#endif
+
+#ifndef BRIDGE_MODE
+    //a node only receives the acknowledges of its own messages: the radio sleeps until the next one, cf postMessage()
+    g_cc1101Device.powerDown();
+#endif
+
+    //GDO2 interrupt or 100ms polling
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
   }
 }
 
+/**
+*   Convert a sensor value into hundredths, rounded to the nearest: readings are compared as integers
+*   params: 
+*     p_fValue:     sensor value
+*   return:
+*     value in hundredths       
+*/
+static int32_t toHundredths(float p_fValue) {
+  return (int32_t)((p_fValue * 100) + ((p_fValue < 0) ? -0.5f : 0.5f));
+}
+
+/**
+*   Convert a duration into ticks, computed on 64 bits: pdMS_TO_TICKS() overflows beyond 71 minutes
+*   params: 
+*     p_ulSeconds:  duration in seconds
+*   return:
+*     ticks, clamped below portMAX_DELAY       
+*/
+static TickType_t secondsToTicks(uint32_t p_ulSeconds) {
+  uint64_t l_ullTicks = (uint64_t)p_ulSeconds * configTICK_RATE_HZ;
+
+  return (l_ullTicks < portMAX_DELAY) ? (TickType_t)l_ullTicks : (portMAX_DELAY - 1);
+}
 
 /**
 *   SENSOR VALUES MEASUREMENT THREAD: Read Temperature, Humididy, partial pressure and dew point values from devices and send either to
@@ -248,13 +686,30 @@ static void thread_SensorValues( void *pvParameters ) {
   CHTU21::STRUCT_SENSOR_VALUES l_strctSensorValues;
 
   STRUCT_RADIO_SETTINGS l_readioSettings;
+  STRUCT_MISCELLANEOUS_SETTINGS l_strctMiscellaneousSettings;
+
+  //last sent reading, reference of the dead-bands
+  boolean l_bReadingSent = false;
+  int32_t l_iSentTemperatureValue = 0;
+  int32_t l_iSentHumidityValue = 0;
+  TickType_t l_xSentTick = 0;
+  boolean l_bSendReading;
+
+  //previous reading, reference of the adaptive measurement interval
+  boolean l_bAdaptiveInterval;
+  int32_t l_iPreviousTemperatureValue = 0;
+  int32_t l_iPreviousHumidityValue = 0;
+  uint16_t l_uiTemperatureStep;
+  uint16_t l_uiHumidityStep;
+  uint32_t l_ulMeasurementInterval;
 
   memcpy(&l_readioSettings, pvParameters, sizeof(STRUCT_RADIO_SETTINGS));
+  memcpy(&l_strctMiscellaneousSettings, &g_globalSettingsAndStatus.strctMiscellaneousSettings, sizeof(STRUCT_MISCELLANEOUS_SETTINGS));
 
   STRUCT_X_QUEUE_POST_MSG l_strctPostMessage = {ENM_X_QUEUE_POST_MSG_TYPE::POST_DEVICE_SENSOR_VALUES, 0, 0};
 
   //init sensor chip
-  if (!g_htu21Device.init()) {
+  if (!g_htu21Device.init((CHTU21::ENM_RESOLUTION)l_strctMiscellaneousSettings.uiSensorResolution)) {
     vTaskDelete( NULL );
   }
 
@@ -262,36 +717,105 @@ static void thread_SensorValues( void *pvParameters ) {
 
   //boot time: send sensor values
   xEventGroupSetBits(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__READ_SENSOR_VALUES_TIMER_EXPIRES);
+  xEventGroupSetBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__RELOAD_SENSOR_SETTINGS);
 
   while (1)
   {
+    //settings taken at boot time, and again once changed by a downlink command
+    if (xEventGroupClearBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__RELOAD_SENSOR_SETTINGS) & BIT_EVENT_GROUP_MISCELLANEOUS__RELOAD_SENSOR_SETTINGS) {
+      memcpy(&l_strctMiscellaneousSettings, &g_globalSettingsAndStatus.strctMiscellaneousSettings, sizeof(STRUCT_MISCELLANEOUS_SETTINGS));
+
+      //adaptive measurement interval starts from the fixed measurement timeout, within bounds
+      l_bAdaptiveInterval = (l_strctMiscellaneousSettings.uiMinMeasurementInterval != 0) && 
+                            (l_strctMiscellaneousSettings.uiMaxMeasurementInterval >= l_strctMiscellaneousSettings.uiMinMeasurementInterval);
+      l_ulMeasurementInterval = l_strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout * 60;
+      if (l_bAdaptiveInterval) {
+        l_ulMeasurementInterval = constrain(l_ulMeasurementInterval, l_strctMiscellaneousSettings.uiMinMeasurementInterval, l_strctMiscellaneousSettings.uiMaxMeasurementInterval);
+      }
+      if (l_ulMeasurementInterval != g_globalSettingsAndStatus.strctMiscellaneousStatus.uiMeasurementInterval) {
+        xTimerChangePeriod(g_xTimerReadSensorValuesHandle, secondsToTicks(l_ulMeasurementInterval), 0);
+      }
+      g_globalSettingsAndStatus.strctMiscellaneousStatus.uiMeasurementInterval = l_ulMeasurementInterval;
+
+      //rate of change thresholds: dead-bands when set
+      l_uiTemperatureStep = (l_strctMiscellaneousSettings.uiTemperatureDeadBand != 0) ? l_strctMiscellaneousSettings.uiTemperatureDeadBand : ADAPTIVE_INTERVAL_TEMPERATURE_STEP;
+      l_uiHumidityStep = (l_strctMiscellaneousSettings.uiHumidityDeadBand != 0) ? l_strctMiscellaneousSettings.uiHumidityDeadBand : ADAPTIVE_INTERVAL_HUMIDITY_STEP;
+    }
+
     //wait for BIT_EVENT_GROUP_TIMERS__READ_SENSOR_VALUES_TIMER_EXPIRES to bet set, meaning timer has expired
     if (xEventGroupWaitBits(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__READ_SENSOR_VALUES_TIMER_EXPIRES, pdTRUE, pdFALSE, 0) & BIT_EVENT_GROUP_TIMERS__READ_SENSOR_VALUES_TIMER_EXPIRES) {
 
       LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "Sensor timer occured", "");
 
-      //retreive sensor values
-      l_strctSensorValues = g_htu21Device.getSensorValues();
+      //retreive sensor values: burst of samples, filtered
+      l_strctSensorValues = g_htu21Device.getSensorValues(l_strctMiscellaneousSettings.uiOversamplingCount, &l_strctPostMessage.strctSensorValues.strctStatistics);
+
+      //sensor did not answer: nothing is reported, measured again at the next timer expiration
+      if (l_strctPostMessage.strctSensorValues.strctStatistics.uiSamplesCount == 0) {
+        LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Sensor values measurement", "FAILED");
+      } else {
+        //values moving by more than a step: halve the interval, otherwise lengthen it by a quarter. 
+        //Interval converges to the period where values move by about one step between two readings
+        if (l_bAdaptiveInterval && l_bReadingSent) {
+          if ((abs(toHundredths(l_strctSensorValues.fTemperatureValue) - l_iPreviousTemperatureValue) > l_uiTemperatureStep) ||
+              (abs(toHundredths(l_strctSensorValues.fHumidityValue) - l_iPreviousHumidityValue) > l_uiHumidityStep)) {
+            l_ulMeasurementInterval = max(l_ulMeasurementInterval / 2, (uint32_t)l_strctMiscellaneousSettings.uiMinMeasurementInterval);
+          } else {
+            l_ulMeasurementInterval = min(l_ulMeasurementInterval + max(l_ulMeasurementInterval / 4, (uint32_t)1), (uint32_t)l_strctMiscellaneousSettings.uiMaxMeasurementInterval);
+          }
+
+          if (l_ulMeasurementInterval != g_globalSettingsAndStatus.strctMiscellaneousStatus.uiMeasurementInterval) {
+            xTimerChangePeriod(g_xTimerReadSensorValuesHandle, secondsToTicks(l_ulMeasurementInterval), 0);
+            g_globalSettingsAndStatus.strctMiscellaneousStatus.uiMeasurementInterval = l_ulMeasurementInterval;
+            LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "Measurement interval (s)", l_ulMeasurementInterval);
+          }
+        }
+        l_iPreviousTemperatureValue = toHundredths(l_strctSensorValues.fTemperatureValue);
+        l_iPreviousHumidityValue = toHundredths(l_strctSensorValues.fHumidityValue);
+
+        //send-on-delta: skip readings within dead-bands, unless forced or silent for too long. 
+        //A zero dead-band sends any change of its own quantity; both at zero send every reading
+        l_bSendReading = (xEventGroupClearBits(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__FORCE_SENSOR_VALUES_SENDING) & BIT_EVENT_GROUP_TIMERS__FORCE_SENSOR_VALUES_SENDING) ||
+                        !l_bReadingSent ||
+                        ((l_strctMiscellaneousSettings.uiTemperatureDeadBand == 0) && (l_strctMiscellaneousSettings.uiHumidityDeadBand == 0)) ||
+                        (abs(toHundredths(l_strctSensorValues.fTemperatureValue) - l_iSentTemperatureValue) > l_strctMiscellaneousSettings.uiTemperatureDeadBand) ||
+                        (abs(toHundredths(l_strctSensorValues.fHumidityValue) - l_iSentHumidityValue) > l_strctMiscellaneousSettings.uiHumidityDeadBand) ||
+                        ((l_strctMiscellaneousSettings.uiMaxSilenceInterval != 0) && 
+                          ((xTaskGetTickCount() - l_xSentTick) >= secondsToTicks((uint32_t)l_strctMiscellaneousSettings.uiMaxSilenceInterval * 60)));
+
+        if (l_bSendReading) {
+          l_bReadingSent = true;
+          l_iSentTemperatureValue = toHundredths(l_strctSensorValues.fTemperatureValue);
+          l_iSentHumidityValue = toHundredths(l_strctSensorValues.fHumidityValue);
+          l_xSentTick = xTaskGetTickCount();
 
-      l_strctPostMessage.enmMsgType = ENM_X_QUEUE_POST_MSG_TYPE::POST_DEVICE_SENSOR_VALUES;
-      l_strctPostMessage.strctSensorValues.uiDeviceId = l_readioSettings.uiDeviceID;
-      l_strctPostMessage.strctSensorValues.byTemperatureQuotientValue = (byte)l_strctSensorValues.fTemperatureValue;
-      l_strctPostMessage.strctSensorValues.byTemperatureRemaindertValue = (byte)((l_strctSensorValues.fTemperatureValue - (byte)l_strctSensorValues.fTemperatureValue) * 100);
-      l_strctPostMessage.strctSensorValues.byHumidityQuotientValue = (byte)l_strctSensorValues.fHumidityValue;
-      l_strctPostMessage.strctSensorValues.byHumidityRemaindertValue = (byte)((l_strctSensorValues.fHumidityValue - (byte)l_strctSensorValues.fHumidityValue) * 100);
-      l_strctPostMessage.strctSensorValues.byPartialPressureQuotientValue = (byte)l_strctSensorValues.fPartialPressureValue;
-      l_strctPostMessage.strctSensorValues.byPartialPressureRemaindertValue = (byte)((l_strctSensorValues.fPartialPressureValue - (byte)l_strctSensorValues.fPartialPressureValue) * 100);
-      l_strctPostMessage.strctSensorValues.byDewPointeQuotientValue = (byte)l_strctSensorValues.fDewPointTemperatureValue;
-      l_strctPostMessage.strctSensorValues.byDewPointRemaindertValue = (byte)((l_strctSensorValues.fDewPointTemperatureValue - (byte)l_strctSensorValues.fDewPointTemperatureValue) * 100);
+          l_strctPostMessage.enmMsgType = ENM_X_QUEUE_POST_MSG_TYPE::POST_DEVICE_SENSOR_VALUES;
+          l_strctPostMessage.strctSensorValues.uiDeviceId = l_readioSettings.uiDeviceID;
+          l_strctPostMessage.strctSensorValues.byTemperatureQuotientValue = (byte)l_strctSensorValues.fTemperatureValue;
+          l_strctPostMessage.strctSensorValues.byTemperatureRemaindertValue = (byte)((l_strctSensorValues.fTemperatureValue - (byte)l_strctSensorValues.fTemperatureValue) * 100);
+          l_strctPostMessage.strctSensorValues.byHumidityQuotientValue = (byte)l_strctSensorValues.fHumidityValue;
+          l_strctPostMessage.strctSensorValues.byHumidityRemaindertValue = (byte)((l_strctSensorValues.fHumidityValue - (byte)l_strctSensorValues.fHumidityValue) * 100);
+          l_strctPostMessage.strctSensorValues.byPartialPressureQuotientValue = (byte)l_strctSensorValues.fPartialPressureValue;
+          l_strctPostMessage.strctSensorValues.byPartialPressureRemaindertValue = (byte)((l_strctSensorValues.fPartialPressureValue - (byte)l_strctSensorValues.fPartialPressureValue) * 100);
+          l_strctPostMessage.strctSensorValues.byDewPointeQuotientValue = (byte)l_strctSensorValues.fDewPointTemperatureValue;
+          l_strctPostMessage.strctSensorValues.byDewPointRemaindertValue = (byte)((l_strctSensorValues.fDewPointTemperatureValue - (byte)l_strctSensorValues.fDewPointTemperatureValue) * 100);
+          l_strctPostMessage.strctSensorValues.ulSampleAge = 0;
 
 #ifdef BRIDGE_MODE
-      //send values to API Server via Bridge Thread
-      xQueueSendToBack(g_xQueueBridgeHandle, ( void * )&l_strctPostMessage, 0/*portMAX_DELAY*/);
+          //send values to API Server via Bridge Thread, X_QUEUE_BRIDGE_OWN_SLOTS being kept for it
+          if (xQueueSendToBack(g_xQueueBridgeHandle, ( void * )&l_strctPostMessage, 0/*portMAX_DELAY*/) != pdPASS) {
+            LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Bridge queue full, reading lost", "");
+          }
 #else
-      //send values to device bridge-server via Radio Thread 
-      xQueueOverwrite(g_xQueueSensorValuesHandle, ( void * )&l_strctPostMessage);
+          //send values to device bridge-server via Radio Thread 
+          xQueueOverwrite(g_xQueueSensorValuesHandle, ( void * )&l_strctPostMessage);
 #endif
+        } else {
+          g_globalSettingsAndStatus.strctMiscellaneousStatus.ulSuppressedReadings++;
+          LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "Reading within dead-bands", g_globalSettingsAndStatus.strctMiscellaneousStatus.ulSuppressedReadings);
+        }
       }
+    }
 
     //perform a simple sensor values measurement without sending to server-bridge and API server; Internal usage only, e.g. AT command requestiong info
     if (xEventGroupWaitBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_SENSOR_VALUES_MEASUREMENT, pdTRUE, pdFALSE, 0) & BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_SENSOR_VALUES_MEASUREMENT) {
@@ -315,12 +839,23 @@ static void thread_SensorValues( void *pvParameters ) {
 */
 static void thread_Bridge( void *pvParameters ) {
   STRUCT_X_QUEUE_POST_MSG l_strctQueuePostMsg;
+  TickType_t l_xOutboxDrainTick = 0;
+  TickType_t l_xOutboxDrainPeriod = 0;
 
   STRUCT_X_QUEUE_MISCELLANEOUS l_strcMiscellaneous;
   STRUCT_BRIDGE_SETTINGS l_strctBridgeSettings;
 
   memcpy(&l_strctBridgeSettings, pvParameters, sizeof(STRUCT_BRIDGE_SETTINGS));
 
+  if (!g_bridgeDrv.initOutbox(g_abyBridgeOutboxArea, BRIDGE_OUTBOX_ROWS)) {
+    LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Bridge outbox init", "FAILED");
+  }
+  g_bridgeDrv.initDownlink(&g_downlinkQueue, g_globalSettingsAndStatus.strctRadioSettings.uiDeviceID);
+  g_bridgeDrv.initLiveness(&g_deviceLiveness);
+  g_bridgeDrv.initDeviceCache(&g_deviceCache);
+  g_globalSettingsAndStatus.strctMiscellaneousStatus.uiOutboxDepth = g_bridgeDrv.getOutboxDepth();
+  g_globalSettingsAndStatus.strctMiscellaneousStatus.ulOutboxAge = g_bridgeDrv.getOutboxAge();
+
   if (g_bridgeDrv.init(&Serial1, 115200, &l_strctBridgeSettings, &l_strcMiscellaneous.strctWwifiStatus) != CESP8266::ENM_STATUS::SUCEEDED) {
     vTaskDelete( NULL );
   }
@@ -339,11 +874,16 @@ static void thread_Bridge( void *pvParameters ) {
                                               l_strctQueuePostMsg.strctTemperatureHumidity.byTemperatureRemaindertValue,
                                               l_strctQueuePostMsg.strctTemperatureHumidity.byHumidityQuotientValue,
                                               l_strctQueuePostMsg.strctTemperatureHumidity.byHumidityRemaindertValue);*/
-            g_bridgeDrv.postSensorValues(l_strctQueuePostMsg.strctSensorValues);
-        break;
-
-        case ENM_X_QUEUE_POST_MSG_TYPE::POST_DEVICE_KEEP_ALIVE:
-          g_bridgeDrv.postKeepaliveDevice(l_strctQueuePostMsg.strctSensorValues.uiDeviceId);
+          //readings queue up behind the outbox, so that the API receives them in order. A reading which 
+          //can't be uploaded goes to the outbox as well
+          if ((g_bridgeDrv.getOutboxDepth() != 0) || !g_bridgeDrv.postSensorValues(l_strctQueuePostMsg.strctSensorValues)) {
+            g_bridgeDrv.storeSensorValues(l_strctQueuePostMsg.strctSensorValues);
+            g_globalSettingsAndStatus.strctMiscellaneousStatus.uiOutboxDepth = g_bridgeDrv.getOutboxDepth();
+            g_globalSettingsAndStatus.strctMiscellaneousStatus.ulOutboxAge = g_bridgeDrv.getOutboxAge();
+          } else {
+            //an upload is an implicit keep-alive of the bridge: explicit ones only go out on silent periods
+            xTimerReset(g_xTimerAPIKeepAliveHandle, 0);
+          }
         break;
 
         default:
@@ -351,15 +891,36 @@ static void thread_Bridge( void *pvParameters ) {
       }
     }
 
-    //wait for BIT_EVENT_GROUP_TIMERS__SEND_API_KEEP_ALIVE_TIMER_EXPIRES to bet set, meaning timer g_timerMinAPIKeepAlive has expired
+    //outbox drain: a batch at each pass while the API answers, retried later otherwise
+    if ((g_globalSettingsAndStatus.strctMiscellaneousStatus.uiOutboxDepth != 0) && ((xTaskGetTickCount() - l_xOutboxDrainTick) >= l_xOutboxDrainPeriod)) {
+      if (g_bridgeDrv.drainOutbox()) {
+        l_xOutboxDrainPeriod = 0;
+        xTimerReset(g_xTimerAPIKeepAliveHandle, 0);
+      } else {
+        l_xOutboxDrainPeriod = pdMS_TO_TICKS(BRIDGE_OUTBOX_RETRY_PERIOD * 1000);
+      }
+      l_xOutboxDrainTick = xTaskGetTickCount();
+
+      g_globalSettingsAndStatus.strctMiscellaneousStatus.uiOutboxDepth = g_bridgeDrv.getOutboxDepth();
+      g_globalSettingsAndStatus.strctMiscellaneousStatus.ulOutboxAge = g_bridgeDrv.getOutboxAge();
+      LOG_DEBUG_PRINTLN(LOG_PREFIX_MAIN, "Outbox readings", g_globalSettingsAndStatus.strctMiscellaneousStatus.uiOutboxDepth);
+    }
+
+    //wait for BIT_EVENT_GROUP_TIMERS__SEND_API_KEEP_ALIVE_TIMER_EXPIRES to bet set, meaning timer g_timerMinAPIKeepAlive has expired,
+    //or that a device keep-alive period has been closed
     if (xEventGroupWaitBits(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__SEND_API_KEEP_ALIVE_TIMER_EXPIRES, pdTRUE, pdFALSE, 0) & BIT_EVENT_GROUP_TIMERS__SEND_API_KEEP_ALIVE_TIMER_EXPIRES) {
-      g_bridgeDrv.postKeepaliveServer();
+      if (g_bridgeDrv.postKeepaliveServer()) {
+        xTimerReset(g_xTimerAPIKeepAliveHandle, 0);
+      }
     }
 
     if (xEventGroupWaitBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_BRIDGE_ERASE_WIFI_PARAMS, pdTRUE, pdFALSE, 0) & BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_FACTORY_RESET) {
       g_bridgeDrv.factoryReset();
     }
 
+    //local queries on the latest readings, answered when the bridge server is enabled
+    g_bridgeDrv.poll();
+
     vTaskDelay(pdMS_TO_TICKS(100));
   }
 }
@@ -376,6 +937,11 @@ static void thread_Bridge( void *pvParameters ) {
 static void thread_ATSettings( void *pvParameters ) {
 
   g_ATSettings.init(&g_USBSerial, (STRUCT_GLOBAL_SETTINGS_AND_STATUS *)pvParameters, &g_xEventGroupMiscellaneousHandle, &g_xQueueATSettingsHandle);
+#ifdef BRIDGE_MODE
+  g_ATSettings.initDeviceCache(&g_deviceCache);
+#else
+  g_ATSettings.initFlashLog(&g_flashLog, g_ulFlashLogTimeBase);
+#endif
 
   while (1) {
     g_ATSettings.pool();
@@ -441,23 +1007,30 @@ static void thread_Miscellaneous( void *pvParameters ) {
       }
     }
 
+    //NVM controller and page buffer are shared with the flash logs, written by higher priority threads: no switch while writing
     if (xEventGroupWaitBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_SAVE_SETTINGS, pdTRUE, pdFALSE, 0) & BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_SAVE_SETTINGS) {
+      vTaskSuspendAll();
       _g_flashStorageSignatureID.write(FLASH_STORAGE_SIGNATURE_ID);
 #ifdef BRIDGE_MODE
       _g_flashSettings.write(*(STRUCT_FLASH_SETTINGS *)(&g_globalSettingsAndStatus.strctBridgeSettings));
 #else  
       _g_flashSettings.write(*(STRUCT_FLASH_SETTINGS *)(&g_globalSettingsAndStatus.strctRadioSettings));
 #endif
+      xTaskResumeAll();
     }
 
     if (xEventGroupWaitBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_FACTORY_RESET, pdTRUE, pdFALSE, 0) & BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_FACTORY_RESET) {
+      vTaskSuspendAll();
       _g_flashStorageSignatureID.write(0x0000);
       memset(&g_globalSettingsAndStatus, 0, sizeof(STRUCT_GLOBAL_SETTINGS_AND_STATUS));
 #ifdef BRIDGE_MODE
       _g_flashSettings.write(*(STRUCT_FLASH_SETTINGS *)(&g_globalSettingsAndStatus.strctBridgeSettings));
-      xEventGroupSetBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_BRIDGE_ERASE_WIFI_PARAMS);
 #else  
       _g_flashSettings.write(*(STRUCT_FLASH_SETTINGS *)(&g_globalSettingsAndStatus.strctRadioSettings));
+#endif
+      xTaskResumeAll();
+#ifdef BRIDGE_MODE
+      xEventGroupSetBits(g_xEventGroupMiscellaneousHandle, BIT_EVENT_GROUP_MISCELLANEOUS__PERFORM_BRIDGE_ERASE_WIFI_PARAMS);
 #endif
     }
 
@@ -505,7 +1078,7 @@ void jumperInterruptPinCallback(void) {
   if ((millis() - g_iJumberRebounceLastISRTimeMillis) > 1000) {
     l_xHigherPriorityTaskWoken = pdFALSE;
 
-    l_xResult = xEventGroupSetBitsFromISR(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__READ_SENSOR_VALUES_TIMER_EXPIRES, &l_xHigherPriorityTaskWoken);
+    l_xResult = xEventGroupSetBitsFromISR(g_xEventGroupTimersHandle, BIT_EVENT_GROUP_TIMERS__READ_SENSOR_VALUES_TIMER_EXPIRES | BIT_EVENT_GROUP_TIMERS__FORCE_SENSOR_VALUES_SENDING, &l_xHigherPriorityTaskWoken);
     if (l_xResult != pdFAIL ) {
       portYIELD_FROM_ISR( l_xHigherPriorityTaskWoken );
     }
@@ -598,8 +1171,16 @@ void setup() {
   g_globalSettingsAndStatus.strctRadioSettings.uiKeepAliveTimeout = _RADIO_DEVELOP_KEEPALIVE_TIMEOUT;
   g_globalSettingsAndStatus.strctRadioSettings.uiMessageSignature = _RADIO_MSG_SIGNATURE;
   g_globalSettingsAndStatus.strctRadioSettings.uiOutputPower = CCC1100::ENM_OUTPUT_POWER_DBM::PLUS_7;
+  g_globalSettingsAndStatus.strctRadioSettings.uiChannel = _RADIO_DEVELOP_CHANNEL_;
 
   g_globalSettingsAndStatus.strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout = _MISCELLANEOUS_READ_SENSOR_VALUES_TIMEOUT_;
+  g_globalSettingsAndStatus.strctMiscellaneousSettings.uiTemperatureDeadBand = _MISCELLANEOUS_TEMPERATURE_DEAD_BAND_;
+  g_globalSettingsAndStatus.strctMiscellaneousSettings.uiHumidityDeadBand = _MISCELLANEOUS_HUMIDITY_DEAD_BAND_;
+  g_globalSettingsAndStatus.strctMiscellaneousSettings.uiMaxSilenceInterval = _MISCELLANEOUS_MAX_SILENCE_INTERVAL_;
+  g_globalSettingsAndStatus.strctMiscellaneousSettings.uiMinMeasurementInterval = _MISCELLANEOUS_MIN_MEASUREMENT_INTERVAL_;
+  g_globalSettingsAndStatus.strctMiscellaneousSettings.uiMaxMeasurementInterval = _MISCELLANEOUS_MAX_MEASUREMENT_INTERVAL_;
+  g_globalSettingsAndStatus.strctMiscellaneousSettings.uiSensorResolution = _MISCELLANEOUS_SENSOR_RESOLUTION_;
+  g_globalSettingsAndStatus.strctMiscellaneousSettings.uiOversamplingCount = _MISCELLANEOUS_SENSOR_OVERSAMPLING_;
 
   _WEB_USB_LANDING_PAGE
 
@@ -610,11 +1191,15 @@ void setup() {
     strcpy(g_globalSettingsAndStatus.strctBridgeSettings.strctAPIServerSettings.cAuthorizationToken, _BRIDGE_DEVELOP_AUTHORIZATION_);
     strcpy(g_globalSettingsAndStatus.strctBridgeSettings.strctAPIServerSettings.cClientID, _BRIDGE_DEVELOP_CLIENTID_);
     g_globalSettingsAndStatus.strctBridgeSettings.strctAPIServerSettings.uiKeepAliveTimeout = _BRIDGE_DEVELOP_KEEPALIVE_TIMEOUT_;
+    g_globalSettingsAndStatus.strctBridgeSettings.strctAPIServerSettings.uiOutboxRetention = _BRIDGE_DEVELOP_OUTBOX_RETENTION_;
+    g_globalSettingsAndStatus.strctRadioSettings.uiHoppingDwellTime = _RADIO_DEVELOP_HOPPING_DWELL_TIME_;
+    g_globalSettingsAndStatus.strctRadioSettings.uiFECMode = _RADIO_DEVELOP_FEC_MODE_;
 
     strcpy(g_globalSettingsAndStatus.strctBridgeSettings.strctWifiSettings.cSSID, _BRIDGE_DEVELOP_AP_SSID_);
     strcpy(g_globalSettingsAndStatus.strctBridgeSettings.strctWifiSettings.cKey, _BRIDGE_DEVELOP_AP_KEY_);
   #else
     g_globalSettingsAndStatus.strctRadioSettings.uiServerID = _RADIO_DEVELOP_SERVER_ADDR_;
+    g_globalSettingsAndStatus.strctRadioSettings.uiAggregatedSamples = _RADIO_DEVELOP_AGGREGATED_SAMPLES_;
   #endif
 #endif
 
@@ -638,15 +1223,24 @@ void setup() {
 
   if (l_bDeviceHasSettings) {
 #ifdef BRIDGE_MODE 
-    g_xTimerAPIKeepAliveHandle = xTimerCreateStatic("", pdMS_TO_TICKS(g_globalSettingsAndStatus.strctBridgeSettings.strctAPIServerSettings.uiKeepAliveTimeout * 60000), pdTRUE, ( void * ) 0, vTimerCallback, &g_xTimerAPIKeepAliveStatic);
+    g_xTimerAPIKeepAliveHandle = xTimerCreateStatic("", secondsToTicks((uint32_t)g_globalSettingsAndStatus.strctBridgeSettings.strctAPIServerSettings.uiKeepAliveTimeout * 60), pdTRUE, ( void * ) 0, vTimerCallback, &g_xTimerAPIKeepAliveStatic);
 #endif
-    g_xTimerDeviceKeepAliveHandle = xTimerCreateStatic("", pdMS_TO_TICKS(g_globalSettingsAndStatus.strctRadioSettings.uiKeepAliveTimeout * 60000), pdTRUE, ( void * ) 0, vTimerCallback, &g_xTimerDeviceKeepAliveStatic);
+    g_xTimerDeviceKeepAliveHandle = xTimerCreateStatic("", secondsToTicks((uint32_t)g_globalSettingsAndStatus.strctRadioSettings.uiKeepAliveTimeout * 60), pdTRUE, ( void * ) 0, vTimerCallback, &g_xTimerDeviceKeepAliveStatic);
 
-    g_xTimerReadSensorValuesHandle = xTimerCreateStatic("", pdMS_TO_TICKS(g_globalSettingsAndStatus.strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout * 60000), pdTRUE, ( void * ) 0, vTimerCallback, &g_xTimerReadSensrValuesStatic);
+    g_xTimerReadSensorValuesHandle = xTimerCreateStatic("", secondsToTicks((uint32_t)g_globalSettingsAndStatus.strctMiscellaneousSettings.uiReadSensorValuesMeasurementTimeout * 60), pdTRUE, ( void * ) 0, vTimerCallback, &g_xTimerReadSensrValuesStatic);
  
     g_xQueueSensorValuesHandle = xQueueCreateStatic(X_QUEUE_SENSOR_VALUES_LENGTH, X_QUEUE_SENSOR_VALUES_SIZE, g_xQueueSensorValuesHandleBuffer, &g_xQueueSensorValuesHandleStatic);
     configASSERT(g_xQueueSensorValuesHandle);
 
+#ifndef BRIDGE_MODE
+    //local data logger, rebuilt from the flash content: readings not delivered before the restart are replayed
+    if (!g_flashLog.init(g_abyFlashLogArea, FLASH_LOG_ROWS)) {
+      LOG_ERROR_PRINTLN(LOG_PREFIX_MAIN, "Flash log init", "FAILED");
+    }
+    g_ulFlashLogTimeBase = g_flashLog.getNewestTimestamp();
+    g_globalSettingsAndStatus.strctMiscellaneousStatus.uiLoggedReadings = g_flashLog.getPendingCount();
+#endif
+
 #ifdef BRIDGE_MODE
     g_xQueueBridgeHandle = xQueueCreateStatic(X_QUEUE_BRIDGE_LENGTH, X_QUEUE_BRIDGE_SIZE, g_xQueueBridgeHandleBuffer, &g_xQueueBridgeHandleStatic);
     configASSERT(g_xQueueBridgeHandle);
@@ -24,6 +24,10 @@
 
 #include "CCC1100.h"
 
+//frame layouts: RSSI and LQI right after the largest message, which fits a circular buffer page
+static_assert(sizeof(CCC1100::STRUCT_RADIO_PAYLOAD) == FRAME_BUFFER_SIZE, "STRUCT_RADIO_PAYLOAD size");
+static_assert(CIRCULAR_BUFFER_FIXED_PAGE_SIZE == MAX_RADIO_MESSAGE_LENGTH + 2, "circular buffer page size");
+
 /****************************************************************************************
  * 
  *     *****    *     *     *****       *         *****       **** 
@@ -39,20 +43,31 @@
 *   params: 
 *       p_byDeviceAdd:              address of the device
 *       p_byOutputPowerLevel:       output power level
+*       p_uiMsgSignature:           network signature, also seeding the hopping sequence
+*       p_byHomeChannel:            home channel of the network. Hopping uses the HOPPING_SEQUENCE_LENGTH channels from it
+*       p_byHoppingDwellTime:       seconds spent on each channel of the sequence. 0 disables hopping. 
+*                                   Devices shall set 0: they learn it from the bridge acknowledges
+*       p_enmFECMode:               bridge FEC policy. Devices shall set FEC_OFF: they learn the profile from the bridge acknowledges
 *   return:
 *       true in init has been performed. Else, false       
 */
-boolean CCC1100::init(byte p_byDeviceAdd, ENM_OUTPUT_POWER_DBM p_byOutputPowerLevel, uint16_t p_uiMsgSignature) {
+boolean CCC1100::init(byte p_byDeviceAdd, ENM_OUTPUT_POWER_DBM p_byOutputPowerLevel, uint16_t p_uiMsgSignature, 
+                        byte p_byHomeChannel, byte p_byHoppingDwellTime, ENM_FEC_MODE p_enmFECMode) {
     
     if ((p_byDeviceAdd == 0) || (p_byOutputPowerLevel == 0)) {
         return false;
     }
 
     m_RXCircularBuffer.init();
+    m_byQueuedReadings = 0;
 
     pinMode(PIN_CC1100_GD02, INPUT_PULLDOWN);
     pinMode(PIN_CC1100_CS, OUTPUT);
 
+    m_pulCSOutSetRegister = &PORT->Group[g_APinDescription[PIN_CC1100_CS].ulPort].OUTSET.reg;
+    m_pulCSOutClearRegister = &PORT->Group[g_APinDescription[PIN_CC1100_CS].ulPort].OUTCLR.reg;
+    m_ulCSPinMask = (1ul << g_APinDescription[PIN_CC1100_CS].ulPin);
+
     SPI.begin();
 
     digitalWrite(PIN_CC1100_CS, LOW);
@@ -62,6 +77,10 @@ boolean CCC1100::init(byte p_byDeviceAdd, ENM_OUTPUT_POWER_DBM p_byOutputPowerLe
 
     spiWriteStrobe(SRES);
     delay(1);
+    //registers are back to their reset values
+    m_bRegistersShadowValid = false;
+    m_bPATableShadowValid = false;
+    m_bPoweredDown = false;
 
     spiWriteStrobe(SFTX);
     delayMicroseconds(100);
@@ -72,15 +91,35 @@ boolean CCC1100::init(byte p_byDeviceAdd, ENM_OUTPUT_POWER_DBM p_byOutputPowerLe
     
     setISMBand(CCC1100::ENM_ISM_BAND::ISM_868);
 
-    setChannel(1);
+    m_byHomeChannel = p_byHomeChannel;
+    m_byCurrentChannel = p_byHomeChannel;
+    setChannel(p_byHomeChannel);
 
     m_byDeviceAddr = p_byDeviceAdd;
     setDeviceAddr(p_byDeviceAdd);
     
     m_uiMessageSignature = p_uiMsgSignature;
 
+    initHoppingSequence();
+    m_byHoppingDwellTime = p_byHoppingDwellTime;
+    m_byHoppingIndex = 0;
+    m_xHoppingSlotStartTick = xTaskGetTickCount();
+    //a bridge is its own time reference
+    m_bHoppingSynchronized = (p_byHoppingDwellTime != 0);
+
+    m_enmFECMode = p_enmFECMode;
+    memset(m_astrctLinkStats, 0, sizeof(m_astrctLinkStats));
+    selectLinkProfile();
+    if (m_enmNextLinkProfile != m_enmLinkProfile) {
+        setLinkProfile(m_enmNextLinkProfile);
+    }
+
     setOutputPowerLevel(p_byOutputPowerLevel);
 
+#ifdef _BENCHMARK_
+    benchmarkSPI();
+#endif
+
     setReceiveMode();
 
     return true;
@@ -98,8 +137,22 @@ boolean CCC1100::poll() {
     boolean bRetValue = false;
 
     //LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "poll", "");
+    selectLinkProfile();
+    if (m_enmNextLinkProfile != m_enmLinkProfile) {
+        setLinkProfile(m_enmNextLinkProfile);
+    }
+
+    updateHopping();
+
+    m_bReceiveIT = false;
     if (digitalRead(PIN_CC1100_GD02) == 1) {
         bRetValue = getPayload();
+    } else if ((m_byHoppingDwellTime != 0) && !(m_byChannelBlacklist & (1 << m_byHoppingIndex)) &&
+               ((xTaskGetTickCount() - m_xNoiseSampleTick) >= pdMS_TO_TICKS(HOPPING_NOISE_SAMPLE_PERIOD_MS))) {
+        //no pending packet: sample the channel noise floor, at a fixed pace whatever the poll rate
+        m_astrctHoppingStats[m_byHoppingIndex].iNoiseRSSISum += getRSSI();
+        m_astrctHoppingStats[m_byHoppingIndex].uiNoiseRSSICount++;
+        m_xNoiseSampleTick = xTaskGetTickCount();
     }
     
     if (!m_RXCircularBuffer.isEmpty()) {
@@ -110,6 +163,19 @@ boolean CCC1100::poll() {
 }
 
 
+/**
+*   To be called from GDO2 rising edge interrupt: RX FIFO reached its threshold or a packet ended. 
+*   The FIFO is drained by the next poll()
+*   params: 
+*       NONE
+*   return:
+*       NONE     
+*/
+void CCC1100::interruptHandler() {
+    m_bReceiveIT = true;
+}
+
+
 /**
 *   Return last incoming message  
 *   params: 
@@ -118,14 +184,39 @@ boolean CCC1100::poll() {
 *       address of the device which sent the payload. -1 if no payload available       
 */
 int16_t CCC1100::getMessage(STRUCT_RADIO_PAYLOAD_MESSAGE *p_pstrRadioPayloadMessage) {
-    if (m_RXCircularBuffer.pull(&m_unPayloadRXFIFOBuffer.byArray[0]) != -1) {
-        memcpy(p_pstrRadioPayloadMessage, &m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayloadMessage, sizeof(STRUCT_RADIO_PAYLOAD_MESSAGE));
-        return (int16_t)m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayLoadHeader.bySenderAddr;
+    if (m_RXCircularBuffer.pull(&m_strctRXFrame.unPayload.byArray[0]) != -1) {
+        memcpy(p_pstrRadioPayloadMessage, &m_strctRXFrame.unPayload.strctPayLoad.strctPayloadMessage, sizeof(STRUCT_RADIO_PAYLOAD_MESSAGE));
+        m_byQueuedReadings -= min(getMessageReadings(p_pstrRadioPayloadMessage), m_byQueuedReadings);
+        return (int16_t)m_strctRXFrame.unPayload.strctPayLoad.strctPayLoadHeader.bySenderAddr;
     } else {
         return -1;
     }
 }
 
+/**
+*   Retreive the RSSI of the last message returned by getMessage()
+*   params: 
+*       NONE
+*   return:
+*       RSSI in dBm       
+*/
+int16_t CCC1100::getMessageRSSI() {
+    int16_t l_iRSSI = (int8_t)m_strctRXFrame.unPayload.strctPayLoad.byRSSI;
+
+    return (l_iRSSI / 2) - RSSI_OFFSET_868MHZ;
+}
+
+/**
+*   Retreive the link quality indicator of the last message returned by getMessage()
+*   params: 
+*       NONE
+*   return:
+*       LQI, the lower the better       
+*/
+byte CCC1100::getMessageLQI() {
+    return m_strctRXFrame.unPayload.strctPayLoad.byLQI & ~LQI_CRC_OK;
+}
+
 
 /**
 *   Retreive the version of the device firmware  
@@ -149,58 +240,250 @@ byte CCC1100::getPartNumber() {
     return spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS::PARTNUM);
 }
 
+/**
+*   Retreive the channel the device is currently tuned on
+*   params: 
+*       NONE
+*   return:
+*       channel number       
+*/
+byte CCC1100::getChannel() {
+    return m_byCurrentChannel;
+}
+
+/**
+*   Retreive the blacklisted indexes of the hopping sequence
+*   params: 
+*       NONE
+*   return:
+*       bit n set if index n of the sequence is blacklisted       
+*/
+byte CCC1100::getChannelBlacklist() {
+    return m_byChannelBlacklist;
+}
+
+/**
+*   Retreive the link profile currently used
+*   params: 
+*       NONE
+*   return:
+*       link profile       
+*/
+CCC1100::ENM_LINK_PROFILE CCC1100::getLinkProfile() {
+    return m_enmLinkProfile;
+}
+
+/**
+*   Retreive the maximum data length of a message with the current link profile
+*   params: 
+*       NONE
+*   return:
+*       maximum data length in bytes       
+*/
+byte CCC1100::getMaxMessageDataLength() {
+    return (m_enmLinkProfile == ENM_LINK_PROFILE::FEC) ? FEC_MAX_RADIO_MESSAGE_DATA_LENGTH : MAX_RADIO_MESSAGE_DATA_LENGTH;
+}
+
+/**
+*   Retreive the delivery statistics of a link profile
+*   params: 
+*       p_enmLinkProfile:   link profile
+*   return:
+*       pointer to the statistics       
+*/
+STRUCT_RADIO_LINK_STATS *CCC1100::getLinkStats(ENM_LINK_PROFILE p_enmLinkProfile) {
+    return &m_astrctLinkStats[p_enmLinkProfile];
+}
+
+/**
+*   Set the state of the application pipeline fed by the incoming messages. A message carrying more readings 
+*   than the pipeline can still take is refused rather than acknowledged, so that a device never considers a 
+*   dropped reading as delivered. To be called before each poll()
+*   params: 
+*       p_byAcceptedReadings:   count of new readings the application can take, readings of the messages waiting 
+*                               into the circular buffers not included. RADIO_ACCEPT_UNLIMITED if not limited
+*       p_byOccupancy:          percent of the pipeline in use, reported by acknowledges
+*       p_byHoldOff:            seconds, delay suggested to devices before their next message. 0 if not congested
+*   return:
+*       NONE       
+*/
+void CCC1100::setBackPressure(byte p_byAcceptedReadings, byte p_byOccupancy, byte p_byHoldOff) {
+    if (p_byAcceptedReadings == RADIO_ACCEPT_UNLIMITED) {
+        m_byAcceptedReadings = RADIO_ACCEPT_UNLIMITED;
+    } else {
+        m_byAcceptedReadings = (p_byAcceptedReadings > m_byQueuedReadings) ? p_byAcceptedReadings - m_byQueuedReadings : 0;
+    }
+
+    m_byOccupancy = p_byOccupancy;
+    m_byHoldOff = p_byHoldOff;
+}
+
+/**
+*   Retreive the hold-off requested by the bridge acknowledge of the last posted message. The hold-off is 
+*   reported once
+*   params: 
+*       NONE
+*   return:
+*       seconds, 0 if the bridge is not congested       
+*/
+byte CCC1100::getHoldOff() {
+    byte l_byHoldOff = m_byReceivedHoldOff;
+
+    m_byReceivedHoldOff = 0;
+
+    return l_byHoldOff;
+}
+
+/**
+*   Set the downlink commands sent by the bridge within its acknowledges. Commands confirmed by devices 
+*   are released from the queue
+*   params: 
+*       p_pDownlinkQueue:   commands waiting for their device
+*   return:
+*       NONE       
+*/
+void CCC1100::setDownlinkQueue(CDownlinkQueue *p_pDownlinkQueue) {
+    m_pDownlinkQueue = p_pDownlinkQueue;
+}
+
+/**
+*   Retreive the downlink commands received with the last acknowledge. The sequence of the last one 
+*   is sent back to the bridge within the next message: commands must be applied once retreived
+*   params: 
+*       p_pstrctCommands:   RADIO_DOWNLINK_MAX_COMMANDS commands, oldest first
+*   return:
+*       count of commands, 0 if none       
+*/
+byte CCC1100::getDownlinkCommands(STRUCT_RADIO_DOWNLINK_COMMAND *p_pstrctCommands) {
+    byte l_byCount = m_byReceivedCommandsCount;
+
+    if (l_byCount != 0) {
+        memcpy(p_pstrctCommands, m_astrctReceivedCommands, l_byCount * sizeof(STRUCT_RADIO_DOWNLINK_COMMAND));
+        m_byDownlinkConfirmSequence = m_astrctReceivedCommands[l_byCount - 1].uiSequence;
+        m_byReceivedCommandsCount = 0;
+    }
+
+    return l_byCount;
+}
+
+/**
+*   Put the device into SLEEP state, nothing is received meanwhile. postMessage() and setOutputPowerLevel() 
+*   wake it up, cf wakeUp()
+*   params: 
+*       NONE
+*   return:
+*       NONE       
+*/
+void CCC1100::powerDown() {
+    if (m_bPoweredDown) {
+        return;
+    }
+
+    sidle();
+    spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::SPWD);
+    m_bPoweredDown = true;
+}
+
+/**
+*   Wake the device up from SLEEP state, restore its configuration and set it into receive mode. 
+*   Nothing is done if the device is not sleeping
+*   params: 
+*       NONE
+*   return:
+*       NONE       
+*/
+void CCC1100::wakeUp() {
+    uint32_t l_ulStartTime;
+
+    if (!m_bPoweredDown) {
+        return;
+    }
+
+    l_ulStartTime = micros();
+
+    //CS low wakes the crystal up, SO goes low once the device is ready
+    *m_pulCSOutClearRegister = m_ulCSPinMask;
+    while ((digitalRead(PIN_SPI_MISO) == HIGH) && ((micros() - l_ulStartTime) < CC1100_STATE_TIMEOUT_US));
+    *m_pulCSOutSetRegister = m_ulCSPinMask;
+
+    m_bPoweredDown = false;
+    restoreRegisters();
+
+    setReceiveMode();
+}
+
 
 /**
-*   Send a packet  
+*   Send a packet. When the network hops, the packet is sent on the channel the bridge is expected to listen to, 
+*   then, if no acknowledge is received, once on each channel of the sequence. If still not acknowledged, the 
+*   same is done with the other link profile since the bridge may have switched meanwhile. A message refused by 
+*   a congested bridge is not sent again, cf getHoldOff()
 *   params: 
+*       p_pyRecipientAddr:      recipient device address
 *       p_pstrRadioPayload:     STRUCT_RADIO_PAYLOAD containing payload informations  
 *       p_byTXRetryMax:         number of retries if no acknowledge is received
 *   return:
-*       NONE       
+*       true if the packet has been acknowledged (or broadcasted), false if not delivered or refused       
 */
 boolean CCC1100::postMessage(byte p_pyRecipientAddr, STRUCT_RADIO_PAYLOAD_MESSAGE *p_pstrRadioPayloadMessageRadioPayload, byte p_byTXRetryMax) {
-    byte p_byTXRetryCount = 0;
+    boolean l_bDelivered = false;
+    byte l_byFirstChannel;
+    byte l_byHoppingIndex;
+    byte l_byProfileAttempt;
+    ENM_LINK_PROFILE l_enmFirstLinkProfile;
     
     if (p_pstrRadioPayloadMessageRadioPayload->byDataLength > MAX_RADIO_MESSAGE_DATA_LENGTH) {
         return false;
-    } else {
-        do {
-            memcpy(&m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayloadMessage, p_pstrRadioPayloadMessageRadioPayload, sizeof(STRUCT_RADIO_PAYLOAD_MESSAGE));
-            m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.bySenderAddr = m_byDeviceAddr;
-            m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byRecipientAddr = p_pyRecipientAddr;
-            m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.wMessageToken = m_uiMessageSignature;
-            m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byPayloadType = ENM_PAYLOAD_TYPE::MSG;
-
-            m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byPayloadLength = 
-                                            p_pstrRadioPayloadMessageRadioPayload->byDataLength + 
-                                            sizeof(STRUCT_RADIO_PAYLOAD_HEADER) +
-                                            sizeof(STRUCT_RADIO_PAYLOAD_MESSAGE) -
-                                            MAX_RADIO_MESSAGE_DATA_LENGTH - 1;
-
-            TXPayloadBurst(&m_unPayloadTXFIFOBuffer);
-            setTransmitMode();
-            setReceiveMode();
-
-            if (p_pyRecipientAddr == BROADCAST_ADDRESS) {
-                return true;
-            } else {
-                vTaskDelay(pdMS_TO_TICKS(300));
+    } 
 
-                poll();
+    wakeUp();
 
-                if (m_bReceivedAck) {
-                    m_bReceivedAck = false;
-                    return true;
+    //apply the profile announced by the last bridge acknowledge
+    if (m_enmNextLinkProfile != m_enmLinkProfile) {
+        setLinkProfile(m_enmNextLinkProfile);
+    }
+
+    updateHopping();
+
+    m_byMessageTransmissions = 0;
+    m_bReceivedRefusal = false;
+    m_byReceivedHoldOff = 0;
+    l_byFirstChannel = m_byCurrentChannel;
+    l_enmFirstLinkProfile = m_enmLinkProfile;
+
+    for (l_byProfileAttempt = 0; (l_byProfileAttempt < RADIO_LINK_PROFILES_COUNT) && !l_bDelivered && !m_bReceivedRefusal; l_byProfileAttempt++) {
+        if (l_byProfileAttempt != 0) {
+            setLinkProfile((l_enmFirstLinkProfile == ENM_LINK_PROFILE::FEC) ? ENM_LINK_PROFILE::STANDARD : ENM_LINK_PROFILE::FEC);
+            tuneChannel(l_byFirstChannel);
+        }
+
+        if (p_pstrRadioPayloadMessageRadioPayload->byDataLength > getMaxMessageDataLength()) {
+            continue;
+        }
+
+        //the message counts once for each profile it is tried with, whatever the retries and channels
+        m_astrctLinkStats[m_enmLinkProfile].uiPosted++;
+        l_bDelivered = transmitPayload(p_pyRecipientAddr, p_pstrRadioPayloadMessageRadioPayload, (l_byProfileAttempt == 0) ? p_byTXRetryMax : 0);
+
+        //bridge has never been heard, or may have hopped meanwhile: scan the sequence
+        if (!l_bDelivered && !m_bReceivedRefusal && (m_byHoppingDwellTime != 0 || !m_bHoppingSynchronized)) {
+            for (l_byHoppingIndex = 0; (l_byHoppingIndex < HOPPING_SEQUENCE_LENGTH) && !l_bDelivered && !m_bReceivedRefusal; l_byHoppingIndex++) {
+                if ((m_byChannelBlacklist & (1 << l_byHoppingIndex)) || (getHoppingChannel(l_byHoppingIndex) == l_byFirstChannel)) {
+                    continue;
                 }
 
-                LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "p_byTXRetryCount", p_byTXRetryCount);
+                tuneChannel(getHoppingChannel(l_byHoppingIndex));
 
-                p_byTXRetryCount++;
+                m_astrctLinkStats[m_enmLinkProfile].ulRetries++;
+                l_bDelivered = transmitPayload(p_pyRecipientAddr, p_pstrRadioPayloadMessageRadioPayload, 0);
             }
-        } while (p_byTXRetryCount <= p_byTXRetryMax);
-
-        return false;
+        }
     }
+
+    //marginal link: ask the bridge for the FEC profile within the next messages. A refusal comes from a link that works
+    m_bRequestFEC = (!l_bDelivered && !m_bReceivedRefusal) || (m_byMessageTransmissions > FEC_REQUEST_RETRIES_THRESHOLD);
+
+    return l_bDelivered;
 }
 
 /****************************************************************************************
@@ -213,39 +496,117 @@ boolean CCC1100::postMessage(byte p_pyRecipientAddr, STRUCT_RADIO_PAYLOAD_MESSAG
  *   
  * **************************************************************************************/
 
+/**
+*   Send a packet on the current channel and wait for its acknowledge. The wait blocks on the task notification 
+*   given by the GDO2 interrupt, so it has to run into the thread notified by this interrupt
+*   params: 
+*       p_pyRecipientAddr:      recipient device address
+*       p_pstrRadioPayload:     STRUCT_RADIO_PAYLOAD containing payload informations  
+*       p_byTXRetryMax:         number of retries if no acknowledge is received
+*   return:
+*       true if the packet has been acknowledged (or broadcasted), false if not acknowledged or refused       
+*/
+boolean CCC1100::transmitPayload(byte p_pyRecipientAddr, STRUCT_RADIO_PAYLOAD_MESSAGE *p_pstrRadioPayloadMessageRadioPayload, byte p_byTXRetryMax) {
+    byte p_byTXRetryCount = 0;
+    TickType_t l_xStartTick, l_xElapsedTicks;
+#ifdef _BENCHMARK_
+    uint32_t l_ulTXEndTime;
+#endif
+    STRUCT_RADIO_LINK_STATS *l_pstrctLinkStats = &m_astrctLinkStats[m_enmLinkProfile];
+    boolean l_bDownlinkConfirmed = false;
+
+    do {
+        m_byMessageTransmissions++;
+
+        memcpy(&m_strctTXFrame.unPayload.strctPayLoad.strctPayloadMessage, p_pstrRadioPayloadMessageRadioPayload, sizeof(STRUCT_RADIO_PAYLOAD_MESSAGE));
+        m_strctTXFrame.unPayload.strctPayLoad.strctPayLoadHeader.bySenderAddr = m_byDeviceAddr;
+        m_strctTXFrame.unPayload.strctPayLoad.strctPayLoadHeader.byRecipientAddr = p_pyRecipientAddr;
+        m_strctTXFrame.unPayload.strctPayLoad.strctPayLoadHeader.wMessageToken = m_uiMessageSignature;
+        m_strctTXFrame.unPayload.strctPayLoad.strctPayLoadHeader.byPayloadType = ENM_PAYLOAD_TYPE::MSG;
+        m_strctTXFrame.unPayload.strctPayLoad.strctPayLoadHeader.byFlags = m_bRequestFEC ? RADIO_FLAG_FEC_REQUEST : 0;
+
+        m_strctTXFrame.unPayload.strctPayLoad.strctPayLoadHeader.byPayloadLength = 
+                                        p_pstrRadioPayloadMessageRadioPayload->byDataLength + 
+                                        sizeof(STRUCT_RADIO_PAYLOAD_HEADER) +
+                                        sizeof(STRUCT_RADIO_PAYLOAD_MESSAGE) -
+                                        MAX_RADIO_MESSAGE_DATA_LENGTH - 1;
+
+        //downlink commands applied since the last message: their sequence follows the message data, when it fits
+        l_bDownlinkConfirmed = (m_byDownlinkConfirmSequence != 0) && (p_pstrRadioPayloadMessageRadioPayload->byDataLength < getMaxMessageDataLength());
+        if (l_bDownlinkConfirmed) {
+            m_strctTXFrame.unPayload.strctPayLoad.strctPayloadMessage.abyData[p_pstrRadioPayloadMessageRadioPayload->byDataLength] = m_byDownlinkConfirmSequence;
+            m_strctTXFrame.unPayload.strctPayLoad.strctPayLoadHeader.byFlags |= RADIO_FLAG_DOWNLINK_CONFIRM;
+            m_strctTXFrame.unPayload.strctPayLoad.strctPayLoadHeader.byPayloadLength++;
+        }
+
+        TXPayloadBurst(&m_strctTXFrame);
+        setTransmitMode();
+
+        if (p_pyRecipientAddr == BROADCAST_ADDRESS) {
+            return true;
+        } else {
+            //leave as soon as the acknowledge is received
+            l_xStartTick = xTaskGetTickCount();
+#ifdef _BENCHMARK_
+            l_ulTXEndTime = micros();
+#endif
+            while (!m_bReceivedAck && ((l_xElapsedTicks = xTaskGetTickCount() - l_xStartTick) < pdMS_TO_TICKS(CC1100_ACK_TIMEOUT_MS))) {
+                if (digitalRead(PIN_CC1100_GD02) == 1) {
+                    getPayload();
+                } else {
+                    //sleep until the next packet raises GDO2
+                    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CC1100_ACK_TIMEOUT_MS) - l_xElapsedTicks);
+                }
+            }
+
+            if (m_bReceivedAck) {
+                m_bReceivedAck = false;
+#ifdef _BENCHMARK_
+                //end of the message to acknowledge read: recipient TX to RX turnaround, acknowledge airtime and FIFO drain
+                LOG_INFO_PRINTLN(LOG_PREFIX_CC1100, "ACK turnaround (us)", micros() - l_ulTXEndTime);
+#endif
+
+                //the bridge got the confirmation, even if it refused the message
+                if (l_bDownlinkConfirmed) {
+                    m_byDownlinkConfirmSequence = 0;
+                }
+
+                //bridge congested: retrying right away would not help
+                if (m_bReceivedRefusal) {
+                    return false;
+                }
+
+                l_pstrctLinkStats->uiDelivered++;
+                return true;
+            }
+
+            LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "p_byTXRetryCount", p_byTXRetryCount);
+
+            p_byTXRetryCount++;
+            if (p_byTXRetryCount <= p_byTXRetryMax) {
+                l_pstrctLinkStats->ulRetries++;
+            }
+        }
+    } while (p_byTXRetryCount <= p_byTXRetryMax);
+
+    return false;
+}
+
 /**
 *   Retreive full payload. cf STRUCT_RADIO_PAYLOAD
-*   RXPayloadBurst can return not only a single payload, but someting more than one.
-*   this function splits returned buffer into single payload frames
+*   RXPayloadBurst can return not only a single payload, but someting more than one: cf walkFrames()
 *   params: 
 *       NONE
 *   return:
 *       TRUE if a new incoming message has been added to the circular buffers., otherwise FALSE       
 */
 boolean CCC1100::getPayload() {
-    int8_t l_iReceivedLength;
-    int8_t l_iRemainingBytes;
+    int16_t l_iReceivedLength;
 
-    memset(&m_unPayloadRXFIFOBuffer.byArray[0], 0, FIFO_BUFFER_SIZE);
     if ((l_iReceivedLength = RXPayloadBurst()) != -1) {
-        l_iRemainingBytes = l_iReceivedLength;
-
         LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "l_uiReceivedLength", l_iReceivedLength);
 
-        //check if retreived more than one frame. 
-        do {
-            checkUnitPayload(&m_unPayloadRXFIFOBuffer);
-
-            //+2 include RSSI and LQI added bytes. +1 includes first length byte
-            l_iRemainingBytes -= (m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byPayloadLength + 1 + 2); 
-            
-            if (l_iRemainingBytes > 0) {
-                memmove(&m_unPayloadRXFIFOBuffer.byArray[0], 
-                        &m_unPayloadRXFIFOBuffer.byArray[m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byPayloadLength + 1 + 2],
-                        m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byPayloadLength + 1 + 2);
-            }
-            
-        } while (l_iRemainingBytes > 0);
+        walkFrames((uint16_t)l_iReceivedLength);
         
         return true; 
     }
@@ -255,99 +616,289 @@ boolean CCC1100::getPayload() {
 
 
 /**
-*   Retreive full payload  following interrupt. cf STRUCT_RADIO_PAYLOAD
+*   Walk the RX frame buffer frame by frame, without moving any byte. 
+*   The walk stops at the first truncated or inconsistent frame
 *   params: 
-*       NONE
+*       p_uiReceivedLength:     bytes received into the RX frame buffer, including RSSI and LQI bytes of each frame
+*   return:
+*       NONE       
+*/
+void CCC1100::walkFrames(uint16_t p_uiReceivedLength) {
+    uint16_t l_uiOffset = 0;
+    uint16_t l_uiFrameLength;
+    UNION_PAYLOAD *l_punionPayload;
+
+    //check if retreived more than one frame. 
+    while (l_uiOffset < p_uiReceivedLength) {
+        l_punionPayload = (UNION_PAYLOAD *)&m_strctRXFrame.unPayload.byArray[l_uiOffset];
+        l_uiFrameLength = getFrameLength(l_punionPayload);
+
+        //truncated or inconsistent frame: following bytes can't be trusted
+        if ((l_punionPayload->strctPayLoad.strctPayLoadHeader.byPayloadLength < (sizeof(STRUCT_RADIO_PAYLOAD_HEADER) - 1)) ||
+            (l_uiFrameLength > MAX_RADIO_MESSAGE_LENGTH + 2) ||
+            (l_uiFrameLength > p_uiReceivedLength - l_uiOffset)) {
+            m_astrctHoppingStats[m_byHoppingIndex].uiInvalidFrames++;
+            break;
+        }
+
+        checkUnitPayload(l_punionPayload, l_uiFrameLength);
+
+        l_uiOffset += l_uiFrameLength;
+    }
+}
+
+
+/**
+*   Process a single frame, located anywhere into the RX frame buffer. cf STRUCT_RADIO_PAYLOAD
+*   params: 
+*       p_punionPayload:    first byte of the frame
+*       p_uiFrameLength:    frame length, including RSSI and LQI bytes
 *   return:
 *       TRUE if a new incoming message has been added to the circular buffers., otherwise FALSE       
 */
-boolean CCC1100::checkUnitPayload(CCC1100::UNION_PAYLOAD *p_punionPayload) {
+boolean CCC1100::checkUnitPayload(CCC1100::UNION_PAYLOAD *p_punionPayload, uint16_t p_uiFrameLength) {
+    //FEC profile runs without hardware address check
+    if ((p_punionPayload->strctPayLoad.strctPayLoadHeader.byRecipientAddr != m_byDeviceAddr) && 
+        (p_punionPayload->strctPayLoad.strctPayLoadHeader.byRecipientAddr != BROADCAST_ADDRESS)) {
+        return false;
+    }
+
     //check if token is correct. Otherwise discard. 
-    if ((m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayLoadHeader.wMessageToken == m_uiMessageSignature)) {
+    if ((p_punionPayload->strctPayLoad.strctPayLoadHeader.wMessageToken == m_uiMessageSignature)) {
 
         if (checkAcknowledge(p_punionPayload->strctPayLoad.strctPayLoadHeader.byRecipientAddr, 
                         p_punionPayload->strctPayLoad.strctPayLoadHeader.bySenderAddr, 
                         p_punionPayload->strctPayLoad.strctPayLoadHeader.byPayloadType)) {
             LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "getPayload", "Receive acknowledge");
             m_bReceivedAck = true;
+            m_bReceivedRefusal = (p_punionPayload->strctAckPayLoad.strctPayLoadHeader.byFlags & RADIO_FLAG_REFUSED) != 0;
+
+            //acknowledges sent by a bridge carry its hopping state, then its back-pressure with later firmwares
+            if (p_punionPayload->strctAckPayLoad.strctPayLoadHeader.byPayloadLength >= 
+                    (sizeof(STRUCT_RADIO_PAYLOAD_HEADER) - 1 + offsetof(STRUCT_RADIO_ACK_DATA, byOccupancy))) {
+                synchronizeHopping(&p_punionPayload->strctAckPayLoad.strctAckData);
+                m_enmNextLinkProfile = (p_punionPayload->strctAckPayLoad.strctAckData.byLinkProfile == ENM_LINK_PROFILE::FEC) ? 
+                                            ENM_LINK_PROFILE::FEC : ENM_LINK_PROFILE::STANDARD;
+            }
+
+            if (p_punionPayload->strctAckPayLoad.strctPayLoadHeader.byPayloadLength >= (sizeof(STRUCT_RADIO_PAYLOAD_HEADER) - 1 + sizeof(STRUCT_RADIO_ACK_DATA))) {
+                m_byReceivedHoldOff = p_punionPayload->strctAckPayLoad.strctAckData.byHoldOff;
+            }
+
+            //downlink commands, handed to the application by getDownlinkCommands()
+            if ((p_punionPayload->strctAckPayLoad.strctPayLoadHeader.byPayloadLength >= (sizeof(STRUCT_RADIO_PAYLOAD_HEADER) + sizeof(STRUCT_RADIO_ACK_DATA))) &&
+                (p_punionPayload->strctAckPayLoad.byCommandsCount != 0) && (p_punionPayload->strctAckPayLoad.byCommandsCount <= RADIO_DOWNLINK_MAX_COMMANDS) &&
+                (p_punionPayload->strctAckPayLoad.strctPayLoadHeader.byPayloadLength >= (sizeof(STRUCT_RADIO_PAYLOAD_HEADER) + sizeof(STRUCT_RADIO_ACK_DATA) + 
+                                                                                         p_punionPayload->strctAckPayLoad.byCommandsCount * sizeof(STRUCT_RADIO_DOWNLINK_COMMAND)))) {
+                m_byReceivedCommandsCount = p_punionPayload->strctAckPayLoad.byCommandsCount;
+                memcpy(m_astrctReceivedCommands, p_punionPayload->strctAckPayLoad.astrctCommands, m_byReceivedCommandsCount * sizeof(STRUCT_RADIO_DOWNLINK_COMMAND));
+            }
         } else {
-            if (m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byRecipientAddr != BROADCAST_ADDRESS) {
-              sendAcknowledge(m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayLoadHeader.bySenderAddr); 
+            m_astrctHoppingStats[m_byHoppingIndex].uiValidFrames++;
+
+            //device on a marginal link: the acknowledge below announces the FEC profile
+            if (p_punionPayload->strctPayLoad.strctPayLoadHeader.byFlags & RADIO_FLAG_FEC_REQUEST) {
+                m_bFECRequestReceived = true;
+                m_xFECRequestTick = xTaskGetTickCount();
+                selectLinkProfile();
             }
 
-            if (m_unPayloadRXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byPayloadType == ENM_PAYLOAD_TYPE::MSG) {
-  
-                boolean m_bRetValue = m_RXCircularBuffer.push(&m_unPayloadRXFIFOBuffer.byArray[0]);
 
-                if (m_bRetValue) {
+            if (p_punionPayload->strctPayLoad.strctPayLoadHeader.byPayloadType == ENM_PAYLOAD_TYPE::MSG) {
+                //downlink commands applied by the device are released before the acknowledge brings the next ones
+                if ((m_pDownlinkQueue != NULL) && (p_punionPayload->strctPayLoad.strctPayLoadHeader.byFlags & RADIO_FLAG_DOWNLINK_CONFIRM) &&
+                    (p_punionPayload->strctPayLoad.strctPayloadMessage.byDataLength < MAX_RADIO_MESSAGE_DATA_LENGTH) &&
+                    (p_punionPayload->strctPayLoad.strctPayLoadHeader.byPayloadLength >= (sizeof(STRUCT_RADIO_PAYLOAD_HEADER) + sizeof(STRUCT_RADIO_PAYLOAD_MESSAGE) - 
+                                                                                          MAX_RADIO_MESSAGE_DATA_LENGTH + p_punionPayload->strctPayLoad.strctPayloadMessage.byDataLength))) {
+                    m_pDownlinkQueue->confirm(p_punionPayload->strctPayLoad.strctPayLoadHeader.bySenderAddr, 
+                                              p_punionPayload->strctPayLoad.strctPayloadMessage.abyData[p_punionPayload->strctPayLoad.strctPayloadMessage.byDataLength]);
+                }
+
+                //the frame is queued from a zeroed copy: bytes beyond a short frame belong to the next frame of the RX buffer, 
+                //which must not be overwritten. The RSSI and LQI bytes appended to the frame take their place into STRUCT_RADIO_PAYLOAD
+                STRUCT_RADIO_PAYLOAD l_strctPayload;
+                memset(&l_strctPayload, 0, sizeof(STRUCT_RADIO_PAYLOAD));
+                memcpy(&l_strctPayload, &p_punionPayload->byArray[0], min((uint16_t)(p_uiFrameLength - 2), (uint16_t)MAX_RADIO_MESSAGE_LENGTH));
+                l_strctPayload.byRSSI = p_punionPayload->byArray[p_uiFrameLength - 2];
+                l_strctPayload.byLQI = p_punionPayload->byArray[p_uiFrameLength - 1];
+
+                //the message is acknowledged only once it is queued: a full pipeline refuses it instead of dropping it.
+                //An aggregated frame is charged each of its readings
+                byte l_byReadings = getMessageReadings(&l_strctPayload.strctPayloadMessage);
+                boolean l_bAccepted = ((m_byAcceptedReadings == RADIO_ACCEPT_UNLIMITED) || (l_byReadings <= m_byAcceptedReadings)) && 
+                                      m_RXCircularBuffer.push((byte *)&l_strctPayload, MAX_RADIO_MESSAGE_LENGTH + 2);
+
+                if (l_bAccepted) {
+                    m_byQueuedReadings += l_byReadings;
+                    if (m_byAcceptedReadings != RADIO_ACCEPT_UNLIMITED) {
+                        m_byAcceptedReadings -= l_byReadings;
+                    }
+                }
+
+                if (p_punionPayload->strctPayLoad.strctPayLoadHeader.byRecipientAddr != BROADCAST_ADDRESS) {
+                    sendAcknowledge(p_punionPayload->strctPayLoad.strctPayLoadHeader.bySenderAddr, !l_bAccepted); 
+                }
+
+                if (l_bAccepted) {
                     return true;
                 } else {
-                    LOG_ERROR_PRINTLN(LOG_PREFIX_CC1100, "getPayload", "Cant't add to circular buffer");
+                    LOG_ERROR_PRINTLN(LOG_PREFIX_CC1100, "getPayload", "Message refused, pipeline full");
                 }
             } else {
                 LOG_ERROR_PRINTLN(LOG_PREFIX_CC1100, "ENM_PAYLOAD_TYPE::MSG", "");
             }
         }
+    } else {
+        m_astrctHoppingStats[m_byHoppingIndex].uiInvalidFrames++;
     }
 
     return false;
 }
 
 /**
- *   Send outgoing paylaod.  
- *   Payload format:
- *      [0]: payload length
- *      [1]: recipient address
- *      [2]: sender address
- *      [3]: code (cf ENM_PAYLOAD_TYPE)
- *      [4]: message length
- *      [5....]: message  
+*   Count the readings carried by a message, i.e. the room it takes into the application pipeline
+*   params: 
+*       p_pstrctMessage:    incoming message
+*   return:
+*       samples count for an aggregated frame, 1 otherwise       
+*/
+byte CCC1100::getMessageReadings(STRUCT_RADIO_PAYLOAD_MESSAGE *p_pstrctMessage) {
+    if (p_pstrctMessage->byMessageType == ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES_AGGREGATED) {
+        return (p_pstrctMessage->byDataLength != 0) ? p_pstrctMessage->abyData[0] : 0;
+    }
+
+    return 1;
+}
+
+/**
+ *   Write the payload into the TX FIFO. Packets longer than the FIFO are completed 
+ *   by setTransmitMode() while being sent
  *   params: 
- *       p_byRecipientAddr:  recipient device address   
- *       p_byDataArray:      byte array to transmit
- *       p_byLengthToSend:   length of bute array to transmit
+ *       p_pstrctFrame:  frame containing the payload to send
  *   return:
  *       NONE       
  */
-void CCC1100::TXPayloadBurst(UNION_PAYLOAD *p_pstrctunionPayload) {
-    spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS::TXFIFO_ARRAY, &p_pstrctunionPayload->byArray[0], 
-                        p_pstrctunionPayload->strctPayLoad.strctPayLoadHeader.byPayloadLength);
+void CCC1100::TXPayloadBurst(STRUCT_SPI_BURST_FRAME *p_pstrctFrame) {
+    m_pstrctTXPendingFrame = p_pstrctFrame;
+
+    //+1 includes first length byte. FEC profile sends fixed length packets: trailing bytes are padding
+    m_uiTXFrameLength = (m_enmLinkProfile == ENM_LINK_PROFILE::FEC) ? 
+                            FEC_PACKET_LENGTH : p_pstrctFrame->unPayload.strctPayLoad.strctPayLoadHeader.byPayloadLength + 1;
+    m_uiTXFrameOffset = min(m_uiTXFrameLength, (uint16_t)FIFO_SIZE);
+
+    spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS::TXFIFO_ARRAY, p_pstrctFrame, 0, m_uiTXFrameOffset);
+}
+
+
+/**
+ *   Read a FIFO bytes count. Read twice until stable, cf CC1101 errata on SPI read synchronization
+ *   params: 
+ *       p_enumRegister:     RXBYTES or TXBYTES
+ *   return:
+ *       bytes count including the overflow/underflow flag (FIFOBYTES_OVERFLOW)       
+ */
+byte CCC1100::getFIFOBytes(ENM_CC1101_READ_ONLY_REGISTERS p_enumRegister) {
+    byte l_byFIFOBytes;
+    byte l_byFIFOBytesCheck = spiReadRegister(p_enumRegister);
+
+    do {
+        l_byFIFOBytes = l_byFIFOBytesCheck;
+        l_byFIFOBytesCheck = spiReadRegister(p_enumRegister);
+    } while (l_byFIFOBytes != l_byFIFOBytesCheck);
+
+    return l_byFIFOBytes;
 }
 
 
 /**
- *   Retreive incoming paylaod.  
+ *   Retreive incoming paylaod. The RX FIFO is drained while the packet is being received, 
+ *   so packets up to MAX_RADIO_PACKET_LENGTH bytes fit, whatever the FIFO size. Between two chunks, 
+ *   the thread sleeps until GDO2 rises.
  *   params: 
  *       NONE
  *   return:
- *       length of payload. -1 if no payload available       
+ *       length of the frame, including RSSI and LQI bytes. -1 if no valid frame available       
  */
-int8_t CCC1100::RXPayloadBurst() {
-    byte l_byRXLengthBuferPending;
+int16_t CCC1100::RXPayloadBurst() {
+    byte l_byRXBytes;
+    uint16_t l_uiFrameLength = 0;
+    uint16_t l_uiReceivedLength = 0;
+    uint16_t l_uiLengthToRead;
+    uint32_t l_ulProgressTime = millis();
+
+    do {
+        l_byRXBytes = getFIFOBytes(ENM_CC1101_READ_ONLY_REGISTERS::RXBYTES);
+
+        if (l_byRXBytes & FIFOBYTES_OVERFLOW) {
+            LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "overflow", "");
+            break;
+        }
 
-    //reads the number of bytes in RXFIFO
-    l_byRXLengthBuferPending = spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS::RXBYTES);
+        if ((l_uiFrameLength == 0) && (l_byRXBytes == 0)) {
+            //packet discarded by the device (address check)
+            return -1;
+        }
 
-    LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "l_byRXLengthBuferPending", l_byRXLengthBuferPending);
+        if (l_uiFrameLength == 0) {
+            //length byte first
+            l_uiLengthToRead = (l_byRXBytes > 1) ? 1 : 0;
+        } else {
+            l_uiLengthToRead = l_uiFrameLength - l_uiReceivedLength;
+            //the last byte of the FIFO is never read while the packet is being received
+            if (l_byRXBytes < l_uiLengthToRead) {
+                l_uiLengthToRead = (l_byRXBytes > 1) ? l_byRXBytes - 1 : 0;
+            }
+        }
 
-    l_byRXLengthBuferPending &= 0x7F;
+        if (l_uiLengthToRead != 0) {
+            spiReadBurst(ENM_CC1101_READ_BURST_COMMANDS::RXFIFO_ARRAY, &m_strctRXFrame, l_uiReceivedLength, l_uiLengthToRead);
+            l_uiReceivedLength += l_uiLengthToRead;
+            l_ulProgressTime = millis();
 
-    //if bytes in buffer and no RX Overflow
-    if ((l_byRXLengthBuferPending & 0x7F) && !(l_byRXLengthBuferPending & 0x80)) {
-        //read payload and store into RX FIFO
-        spiReadBurst(ENM_CC1101_READ_BURST_COMMANDS::RXFIFO_ARRAY, &m_unPayloadRXFIFOBuffer.byArray[0], l_byRXLengthBuferPending);
-        return l_byRXLengthBuferPending;
-    } else {
-        LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "overflow", "");
-        //set to IDLE
-        sidle();
-        //flush RX Buffer
-        spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::SFRX);
-        delayMicroseconds(100);
-        //set to receive mode
-        setReceiveMode();
+            if (l_uiFrameLength == 0) {
+                l_uiFrameLength = getFrameLength(&m_strctRXFrame.unPayload);
+            }
+        } else {
+            if (l_uiFrameLength == 0) {
+                //the length byte alone: the header follows within a few byte times
+                vTaskDelay(1);
+            } else {
+                //GDO2 rises once the RX FIFO reaches its threshold or, when less than a threshold is still expected, 
+                //at the end of the packet
+                spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, ((l_uiFrameLength - l_uiReceivedLength) > RX_FIFO_THRESHOLD) ? 
+                                                                          IOCFG_RX_FIFO_THRESHOLD : (IOCFG_SYNC_WORD | IOCFG_INVERT));
+                waitGDO2(HIGH, CC1100_FIFO_TIMEOUT_MS);
+            }
+
+            if ((millis() - l_ulProgressTime) > CC1100_FIFO_TIMEOUT_MS) {
+                LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "RX timeout", l_uiReceivedLength);
+                break;
+            }
+        }
+    } while ((l_uiFrameLength == 0) || (l_uiReceivedLength < l_uiFrameLength));
+
+    //restore packet received signal
+    spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, m_byRegisterIOCFG2Settings);
+
+    //CRC computed by the device is reported into the LQI byte, autoflush being unavailable above FIFO size. 
+    //CRC failures count as invalid frames of the hopping slot
+    if ((l_uiFrameLength != 0) && (l_uiReceivedLength == l_uiFrameLength)) {
+        if ((m_strctRXFrame.unPayload.byArray[l_uiFrameLength - 1] & LQI_CRC_OK) && (l_uiFrameLength <= MAX_RADIO_MESSAGE_LENGTH + 2)) {
+            return l_uiFrameLength;
+        }
+
+        m_astrctHoppingStats[m_byHoppingIndex].uiInvalidFrames++;
         return -1;
     }
+
+    m_astrctHoppingStats[m_byHoppingIndex].uiInvalidFrames++;
+    //set to IDLE
+    sidle();
+    //flush RX Buffer
+    spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::SFRX);
+    //set to receive mode
+    setReceiveMode();
+    return -1;
 }
 
 /**
@@ -376,50 +927,111 @@ boolean CCC1100::checkAcknowledge(byte p_byRecipientAddr, byte p_bySenderAddr, b
  *      [1]: recipient address
  *      [2]: sender address
  *      [3]: code (cf ENM_PAYLOAD_TYPE)
+ *      [...]: hopping state and back-pressure, cf STRUCT_RADIO_ACK_DATA
+ *      [...]: downlink commands pending for the recipient, if any
  *   params: 
  *       p_bySenderAddr :    sender device address
+ *       p_bRefused:         true if the message could not be accepted, cf RADIO_FLAG_REFUSED
  *   return:
  *       NONE       
  */
-void CCC1100::sendAcknowledge(byte p_byRecipientddr) {
+void CCC1100::sendAcknowledge(byte p_byRecipientddr, boolean p_bRefused) {
+    STRUCT_RADIO_ACK_PAYLOAD *l_pstrctAckPayload = &m_strctTXFrame.unPayload.strctAckPayLoad;
     
-    m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.bySenderAddr = m_byDeviceAddr;
-    m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byRecipientAddr = p_byRecipientddr;
-    m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byPayloadType = ENM_PAYLOAD_TYPE::ACK;
-    m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.wMessageToken = m_uiMessageSignature;
-    m_unPayloadTXFIFOBuffer.strctPayLoad.strctPayLoadHeader.byPayloadLength = sizeof(STRUCT_RADIO_PAYLOAD_HEADER) - 1;
+    l_pstrctAckPayload->strctPayLoadHeader.bySenderAddr = m_byDeviceAddr;
+    l_pstrctAckPayload->strctPayLoadHeader.byRecipientAddr = p_byRecipientddr;
+    l_pstrctAckPayload->strctPayLoadHeader.byPayloadType = ENM_PAYLOAD_TYPE::ACK;
+    l_pstrctAckPayload->strctPayLoadHeader.wMessageToken = m_uiMessageSignature;
+    l_pstrctAckPayload->strctPayLoadHeader.byFlags = p_bRefused ? RADIO_FLAG_REFUSED : 0;
+    l_pstrctAckPayload->strctPayLoadHeader.byPayloadLength = sizeof(STRUCT_RADIO_PAYLOAD_HEADER) + sizeof(STRUCT_RADIO_ACK_DATA) - 1;
+
+    l_pstrctAckPayload->strctAckData.byHoppingDwellTime = m_byHoppingDwellTime;
+    l_pstrctAckPayload->strctAckData.byHoppingIndex = m_byHoppingIndex;
+    l_pstrctAckPayload->strctAckData.wHoppingSlotElapsedTime = (xTaskGetTickCount() - m_xHoppingSlotStartTick) * portTICK_PERIOD_MS / HOPPING_ELAPSED_TIME_UNIT_MS;
+    l_pstrctAckPayload->strctAckData.byChannelBlacklist = m_byChannelBlacklist;
+    l_pstrctAckPayload->strctAckData.byLinkProfile = m_enmNextLinkProfile;
+    l_pstrctAckPayload->strctAckData.byOccupancy = m_byOccupancy;
+    l_pstrctAckPayload->strctAckData.byHoldOff = m_byHoldOff;
+
+    l_pstrctAckPayload->byCommandsCount = (m_pDownlinkQueue != NULL) ? 
+                                            m_pDownlinkQueue->getPending(p_byRecipientddr, l_pstrctAckPayload->astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS) : 0;
+    if (l_pstrctAckPayload->byCommandsCount != 0) {
+        l_pstrctAckPayload->strctPayLoadHeader.byPayloadLength += sizeof(l_pstrctAckPayload->byCommandsCount) + 
+                                                                  l_pstrctAckPayload->byCommandsCount * sizeof(STRUCT_RADIO_DOWNLINK_COMMAND);
+    }
 
-    TXPayloadBurst(&m_unPayloadTXFIFOBuffer);
+    TXPayloadBurst(&m_strctTXFrame);
 
     setTransmitMode();
-    setReceiveMode();
 }
 
 
 /**
- *   Set the device into transmit mode state
+ *   Transmit the TX FIFO content. MCSM1 TXOFF_MODE brings the device back to receive mode 
+ *   at the end of the packet, GDO2 follows the sync word meanwhile. While the rest of a long packet 
+ *   is written, the thread sleeps until GDO2 signals room into the TX FIFO.
  *   params: 
  *       NONE 
  *   return:
  *       NONE       
  */
 void CCC1100::setTransmitMode() {
-    byte l_byMarcState;
-
-    //sets to idle first.
-    sidle();
-    //writes receive strobe (receive mode)
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    uint32_t l_ulStartTime = micros();
+#endif
+    uint32_t l_ulProgressTime;
+    byte l_byTXBytes;
+    uint16_t l_uiLengthToWrite;
+    boolean l_bStatus;
+
+    spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, IOCFG_SYNC_WORD);
     spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::STX);
 
-    //set unknown/dummy state value
-    l_byMarcState = 0xFF;
+    //sync word sent
+    l_bStatus = waitGDO2(HIGH, CC1100_TX_TIMEOUT_MS);
+
+    //refill the TX FIFO while the packet is being sent
+    l_ulProgressTime = millis();
+    while (l_bStatus && (m_uiTXFrameOffset < m_uiTXFrameLength)) {
+        l_byTXBytes = getFIFOBytes(ENM_CC1101_READ_ONLY_REGISTERS::TXBYTES);
 
-    //read out state of cc1100 to be sure in IDLE and TX is finished
-    while (l_byMarcState != ENM_CC1101_MARCSTATES::IDLE) {
-        l_byMarcState = (spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS::MARCSTATE) & 0x1F);
+        if (l_byTXBytes & FIFOBYTES_OVERFLOW) {
+            l_bStatus = false;
+            break;
+        }
+
+        l_uiLengthToWrite = min((uint16_t)(FIFO_SIZE - l_byTXBytes), (uint16_t)(m_uiTXFrameLength - m_uiTXFrameOffset));
+
+        if (l_uiLengthToWrite != 0) {
+            spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS::TXFIFO_ARRAY, m_pstrctTXPendingFrame, m_uiTXFrameOffset, l_uiLengthToWrite);
+            m_uiTXFrameOffset += l_uiLengthToWrite;
+            l_ulProgressTime = millis();
+        } else {
+            //TX FIFO full: GDO2 rises once it is drained below its threshold
+            spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, IOCFG_TX_FIFO_THRESHOLD | IOCFG_INVERT);
+            waitGDO2(HIGH, CC1100_FIFO_TIMEOUT_MS);
+
+            if ((millis() - l_ulProgressTime) > CC1100_FIFO_TIMEOUT_MS) {
+                l_bStatus = false;
+            }
+        }
     }
 
-    delayMicroseconds(100);
+    //end of packet
+    spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, IOCFG_SYNC_WORD);
+    if (!l_bStatus || !waitGDO2(LOW, CC1100_TX_TIMEOUT_MS)) {
+        LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "TX timeout", "");
+        sidle();
+        spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::SFTX);
+        setReceiveMode();
+    }
+
+    //restore packet received signal
+    spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, m_byRegisterIOCFG2Settings);
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "TX to RX (us)", micros() - l_ulStartTime);
+#endif
 }
 
 /**
@@ -430,22 +1042,12 @@ void CCC1100::setTransmitMode() {
  *       NONE       
  */
 void CCC1100::setReceiveMode() {
-    byte l_byMarcState;
-
     //sets to idle first.
     sidle();
     //writes receive strobe (receive mode)
     spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::SRX);
 
-    //set unknown/dummy state value
-    l_byMarcState = 0xFF;
-
-    //read out state of cc1100 to be sure in RX
-    while (l_byMarcState != ENM_CC1101_MARCSTATES::RX) {
-        l_byMarcState = (spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS::MARCSTATE) & 0x1F);
-    }
-
-    delayMicroseconds(100);
+    waitMarcState(ENM_CC1101_MARCSTATES::RX);
 }
 
 /**
@@ -456,20 +1058,58 @@ void CCC1100::setReceiveMode() {
  *       NONE       
  */
 void CCC1100::sidle() {
-    byte l_byMarcState;
-
-    //sets to idle first. 
     spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::SIDLE);
 
-    //set unknown/dummy state machine value
-    l_byMarcState = 0xFF;
+    waitMarcState(ENM_CC1101_MARCSTATES::IDLE);
+}
+
+/**
+ *   Wait until the state machine reaches a state, at most CC1100_STATE_TIMEOUT_US
+ *   params: 
+ *       p_enmMarcState:     expected state 
+ *   return:
+ *       true if the state has been reached, false on timeout       
+ */
+boolean CCC1100::waitMarcState(ENM_CC1101_MARCSTATES p_enmMarcState) {
+    uint32_t l_ulStartTime = micros();
 
-    //read out state of cc1100 to be sure in IDLE
-    while (l_byMarcState != ENM_CC1101_MARCSTATES::IDLE) {
-        l_byMarcState = (spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS::MARCSTATE) & 0x1F);
+    while ((spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS::MARCSTATE) & 0x1F) != p_enmMarcState) {
+        if ((micros() - l_ulStartTime) > CC1100_STATE_TIMEOUT_US) {
+            LOG_DEBUG_PRINTLN(LOG_PREFIX_CC1100, "state timeout", p_enmMarcState);
+            return false;
+        }
     }
 
-    delayMicroseconds(100);
+    return true;
+}
+
+/**
+ *   Wait until GDO2 pin reaches a level, without holding the CPU: the calling thread is the one notified 
+ *   by the GDO2 rising edge interrupt. There is no interrupt on the falling edge, which is polled every tick
+ *   params: 
+ *       p_byLevel:          expected level, HIGH or LOW 
+ *       p_ulTimeoutMs:      maximum waiting time
+ *   return:
+ *       true if the level has been reached, false on timeout       
+ */
+boolean CCC1100::waitGDO2(byte p_byLevel, uint32_t p_ulTimeoutMs) {
+    TickType_t l_xStartTick = xTaskGetTickCount();
+    TickType_t l_xElapsedTicks;
+
+    while (digitalRead(PIN_CC1100_GD02) != p_byLevel) {
+        if ((l_xElapsedTicks = xTaskGetTickCount() - l_xStartTick) >= pdMS_TO_TICKS(p_ulTimeoutMs)) {
+            return false;
+        }
+
+        if (p_byLevel == HIGH) {
+            //sleep until the rising edge. A notification left by an earlier edge only costs one more check
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(p_ulTimeoutMs) - l_xElapsedTicks);
+        } else {
+            vTaskDelay(1);
+        }
+    }
+
+    return true;
 }
 
 /**
@@ -532,6 +1172,7 @@ void CCC1100::setOutputPowerLevel(ENM_OUTPUT_POWER_DBM p_enumDBPowerLever) {
             break;
     }
 
+    wakeUp();
     spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::FREND0, l_Pa);
 }
 
@@ -547,6 +1188,239 @@ void CCC1100::setChannel(byte p_byChannelNumber) {
     spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::CHANNR, p_byChannelNumber);   
 }
 
+/**
+ *   Switch to another channel. The frequency synthesizer is calibrated again when returning to receive mode.
+ *   params: 
+ *       p_byChannelNumber:   channel number
+ *   return:
+ *       NONE       
+ */
+void CCC1100::tuneChannel(byte p_byChannelNumber) {
+    if (p_byChannelNumber != m_byCurrentChannel) {
+        sidle();
+        setChannel(p_byChannelNumber);
+        m_byCurrentChannel = p_byChannelNumber;
+        setReceiveMode();
+    }
+}
+
+/**
+ *   Build the hopping sequence of the network: a permutation of the HOPPING_SEQUENCE_LENGTH channels 
+ *   following the home channel, shuffled with the network signature as seed so that bridge and devices 
+ *   share it without any exchange.
+ *   params: 
+ *       NONE
+ *   return:
+ *       NONE       
+ */
+void CCC1100::initHoppingSequence() {
+    uint16_t l_uiSeed = m_uiMessageSignature;
+    byte l_byIndex, l_bySwapIndex, l_bySwapValue;
+
+    for (l_byIndex = 0; l_byIndex < HOPPING_SEQUENCE_LENGTH; l_byIndex++) {
+        m_abyHoppingSequence[l_byIndex] = l_byIndex;
+        memset(&m_astrctHoppingStats[l_byIndex], 0, sizeof(STRUCT_HOPPING_CHANNEL_STATS));
+    }
+
+    //Fisher-Yates shuffle fed by a 16 bits LCG
+    for (l_byIndex = HOPPING_SEQUENCE_LENGTH - 1; l_byIndex > 0; l_byIndex--) {
+        l_uiSeed = (l_uiSeed * 25173) + 13849;
+        l_bySwapIndex = (l_uiSeed >> 8) % (l_byIndex + 1);
+
+        l_bySwapValue = m_abyHoppingSequence[l_byIndex];
+        m_abyHoppingSequence[l_byIndex] = m_abyHoppingSequence[l_bySwapIndex];
+        m_abyHoppingSequence[l_bySwapIndex] = l_bySwapValue;
+    }
+
+    m_byChannelBlacklist = 0;
+}
+
+/**
+ *   Return the channel of a sequence index. Blacklisted indexes fall back to the home channel.
+ *   params: 
+ *       p_byHoppingIndex:   index into the hopping sequence
+ *   return:
+ *       channel number       
+ */
+byte CCC1100::getHoppingChannel(byte p_byHoppingIndex) {
+    if (m_byChannelBlacklist & (1 << p_byHoppingIndex)) {
+        return m_byHomeChannel;
+    }
+
+    return m_byHomeChannel + m_abyHoppingSequence[p_byHoppingIndex];
+}
+
+/**
+ *   Follow the hopping sequence: move to the slot matching the elapsed time since the last 
+ *   synchronization, and tune the corresponding channel.
+ *   params: 
+ *       NONE
+ *   return:
+ *       NONE       
+ */
+void CCC1100::updateHopping() {
+    TickType_t l_xSlotTicks, l_xElapsedSlots;
+    byte l_byLeftHoppingIndex;
+
+    if (m_byHoppingDwellTime == 0) {
+        tuneChannel(m_byHomeChannel);
+        return;
+    }
+
+    l_xSlotTicks = pdMS_TO_TICKS((uint32_t)m_byHoppingDwellTime * 1000);
+    l_xElapsedSlots = (xTaskGetTickCount() - m_xHoppingSlotStartTick) / l_xSlotTicks;
+
+    if (l_xElapsedSlots > 0) {
+        l_byLeftHoppingIndex = m_byHoppingIndex;
+        m_byHoppingIndex = (m_byHoppingIndex + l_xElapsedSlots) % HOPPING_SEQUENCE_LENGTH;
+        m_xHoppingSlotStartTick += l_xElapsedSlots * l_xSlotTicks;
+
+        updateChannelBlacklist(l_byLeftHoppingIndex, m_byHoppingIndex);
+    }
+
+    tuneChannel(getHoppingChannel(m_byHoppingIndex));
+}
+
+/**
+ *   Evaluate the statistics of the slot which is left and blacklist its channel if it is noisy or 
+ *   mostly carries invalid frames. Expire the blacklisting of the entered slot. The home channel is never blacklisted. 
+ *   params: 
+ *       p_byLeftHoppingIndex:       index of the slot which is left
+ *       p_byEnteredHoppingIndex:    index of the slot which is entered
+ *   return:
+ *       NONE       
+ */
+void CCC1100::updateChannelBlacklist(byte p_byLeftHoppingIndex, byte p_byEnteredHoppingIndex) {
+    STRUCT_HOPPING_CHANNEL_STATS *l_pstrctStats = &m_astrctHoppingStats[p_byLeftHoppingIndex];
+    boolean l_bBlacklist = false;
+
+    if ((m_abyHoppingSequence[p_byLeftHoppingIndex] != 0) && !(m_byChannelBlacklist & (1 << p_byLeftHoppingIndex))) {
+        if ((l_pstrctStats->uiNoiseRSSICount != 0) && 
+            ((l_pstrctStats->iNoiseRSSISum / l_pstrctStats->uiNoiseRSSICount) > HOPPING_NOISE_RSSI_THRESHOLD)) {
+            l_bBlacklist = true;
+        }
+
+        if ((l_pstrctStats->uiInvalidFrames >= HOPPING_INVALID_FRAMES_THRESHOLD) && 
+            (l_pstrctStats->uiInvalidFrames > l_pstrctStats->uiValidFrames)) {
+            l_bBlacklist = true;
+        }
+
+        if (l_bBlacklist) {
+            m_byChannelBlacklist |= (1 << p_byLeftHoppingIndex);
+            l_pstrctStats->uiBlacklistCycles = HOPPING_BLACKLIST_CYCLES;
+            LOG_INFO_PRINTLN(LOG_PREFIX_CC1100, "blacklist channel", m_byHomeChannel + m_abyHoppingSequence[p_byLeftHoppingIndex]);
+        }
+    }
+
+    l_pstrctStats = &m_astrctHoppingStats[p_byEnteredHoppingIndex];
+
+    if (l_pstrctStats->uiBlacklistCycles != 0) {
+        if (--l_pstrctStats->uiBlacklistCycles == 0) {
+            m_byChannelBlacklist &= ~(1 << p_byEnteredHoppingIndex);
+        }
+    }
+
+    l_pstrctStats->iNoiseRSSISum = 0;
+    l_pstrctStats->uiNoiseRSSICount = 0;
+    l_pstrctStats->uiValidFrames = 0;
+    l_pstrctStats->uiInvalidFrames = 0;
+}
+
+/**
+ *   Synchronize the hopping sequence on the state received from a bridge acknowledge
+ *   params: 
+ *       p_pstrctAckData:    hopping state of the bridge
+ *   return:
+ *       NONE       
+ */
+void CCC1100::synchronizeHopping(STRUCT_RADIO_ACK_DATA *p_pstrctAckData) {
+    m_byHoppingDwellTime = p_pstrctAckData->byHoppingDwellTime;
+    m_byHoppingIndex = p_pstrctAckData->byHoppingIndex % HOPPING_SEQUENCE_LENGTH;
+    m_xHoppingSlotStartTick = xTaskGetTickCount() - pdMS_TO_TICKS((uint32_t)p_pstrctAckData->wHoppingSlotElapsedTime * HOPPING_ELAPSED_TIME_UNIT_MS);
+    m_byChannelBlacklist = p_pstrctAckData->byChannelBlacklist;
+    m_bHoppingSynchronized = true;
+}
+
+/**
+ *   Set the link profile. FEC profile enables forward error correction with interleaving, which the CC1101 
+ *   only supports with fixed length packets, and disables the hardware address check since the first byte 
+ *   of a fixed length packet is not the address but the payload length.
+ *   params: 
+ *       p_enmLinkProfile:   link profile to apply
+ *   return:
+ *       NONE       
+ */
+void CCC1100::setLinkProfile(ENM_LINK_PROFILE p_enmLinkProfile) {
+    byte l_abyRegisters[CFG_REGISTER_SIZE];
+
+    sidle();
+
+    memcpy(l_abyRegisters, m_abyRegistersShadow, CFG_REGISTER_SIZE);
+
+    if (p_enmLinkProfile == ENM_LINK_PROFILE::FEC) {
+        l_abyRegisters[PKTCTRL1] = m_pbyCFGRegisters[PKTCTRL1] & ~PKTCTRL1_ADR_CHK;
+        l_abyRegisters[PKTCTRL0] = m_pbyCFGRegisters[PKTCTRL0] & ~PKTCTRL0_LENGTH_CONFIG;
+        l_abyRegisters[PKTLEN] = FEC_PACKET_LENGTH;
+        l_abyRegisters[MDMCFG1] = m_pbyCFGRegisters[MDMCFG1] | MDMCFG1_FEC_EN;
+    } else {
+        l_abyRegisters[PKTCTRL1] = m_pbyCFGRegisters[PKTCTRL1];
+        l_abyRegisters[PKTCTRL0] = m_pbyCFGRegisters[PKTCTRL0];
+        l_abyRegisters[PKTLEN] = m_pbyCFGRegisters[PKTLEN];
+        l_abyRegisters[MDMCFG1] = m_pbyCFGRegisters[MDMCFG1];
+    }
+
+    writeRegisters(ENM_CC1101_READ_WRITE_REGISTERS::PKTLEN, &l_abyRegisters[PKTLEN], MDMCFG1 - PKTLEN + 1);
+
+    m_enmLinkProfile = p_enmLinkProfile;
+    LOG_INFO_PRINTLN(LOG_PREFIX_CC1100, "link profile", p_enmLinkProfile);
+
+    spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::SFRX);
+    setReceiveMode();
+}
+
+/**
+ *   Bridge only: select the link profile announced to the devices, according to the FEC mode
+ *   params: 
+ *       NONE
+ *   return:
+ *       NONE       
+ */
+void CCC1100::selectLinkProfile() {
+    switch (m_enmFECMode) {
+        case ENM_FEC_MODE::FEC_ON:
+            m_enmNextLinkProfile = ENM_LINK_PROFILE::FEC;
+            break;
+
+        case ENM_FEC_MODE::FEC_ON_REQUEST:
+            if (m_bFECRequestReceived && ((xTaskGetTickCount() - m_xFECRequestTick) < pdMS_TO_TICKS(FEC_HOLD_TIME))) {
+                m_enmNextLinkProfile = ENM_LINK_PROFILE::FEC;
+            } else {
+                m_bFECRequestReceived = false;
+                m_enmNextLinkProfile = ENM_LINK_PROFILE::STANDARD;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ *   Return the length of a frame into the RX FIFO, including the appended RSSI and LQI bytes
+ *   params: 
+ *       p_punionPayload:    frame
+ *   return:
+ *       length in bytes       
+ */
+uint16_t CCC1100::getFrameLength(UNION_PAYLOAD *p_punionPayload) {
+    if (m_enmLinkProfile == ENM_LINK_PROFILE::FEC) {
+        return FEC_PACKET_LENGTH + 2;
+    }
+
+    //+2 include RSSI and LQI added bytes. +1 includes first length byte
+    return p_punionPayload->strctPayLoad.strctPayLoadHeader.byPayloadLength + 1 + 2;
+}
+
 /**
  *   Set the ISM band (frequency)
  *   params: 
@@ -555,7 +1429,8 @@ void CCC1100::setChannel(byte p_byChannelNumber) {
  *       NONE       
  */
 void CCC1100::setISMBand(ENM_ISM_BAND p_enumISMBand) {
-    byte l_byFreq2, l_byFreq1, l_byFreq0;
+    byte l_abyFreq[3];
+    byte *l_pbyPATable;
 
     //loads the RF freq which is defined in cc1100_freq_select
     switch (p_enumISMBand)                                                       
@@ -563,50 +1438,48 @@ void CCC1100::setISMBand(ENM_ISM_BAND p_enumISMBand) {
 
         //315MHz
         case ENM_ISM_BAND::ISM_315:                                                          
-                    l_byFreq2 = 0x0C;
-                    l_byFreq1 = 0x1D;
-                    l_byFreq0 = 0x89;
-                    memcpy(&m_unPayloadTXFIFOBuffer.byArray[0], (byte *)patable_power_315, 8);
+                    l_abyFreq[0] = 0x0C;
+                    l_abyFreq[1] = 0x1D;
+                    l_abyFreq[2] = 0x89;
+                    l_pbyPATable = (byte *)patable_power_315;
                     break;
 
         //433.92MHz
         case ENM_ISM_BAND::ISM_433:                                                          
-                    l_byFreq2 = 0x10;
-                    l_byFreq1 = 0xB0;
-                    l_byFreq0 = 0x71;
-                    memcpy(&m_unPayloadTXFIFOBuffer.byArray[0], (byte *)patable_power_433, 8);
+                    l_abyFreq[0] = 0x10;
+                    l_abyFreq[1] = 0xB0;
+                    l_abyFreq[2] = 0x71;
+                    l_pbyPATable = (byte *)patable_power_433;
                     break;
         //868.3MHz
         case ENM_ISM_BAND::ISM_868:                                                          
-                    l_byFreq2 = 0x21;
-                    l_byFreq1 = 0x65;
-                    l_byFreq0 = 0x6A;
-                    memcpy(&m_unPayloadTXFIFOBuffer.byArray[0], (byte *)patable_power_868, 8);
+                    l_abyFreq[0] = 0x21;
+                    l_abyFreq[1] = 0x65;
+                    l_abyFreq[2] = 0x6A;
+                    l_pbyPATable = (byte *)patable_power_868;
                     break;
 
         //915MHz
         case ENM_ISM_BAND::ISM_915:                                                          
-                    l_byFreq2 = 0x23;
-                    l_byFreq1 = 0x31;
-                    l_byFreq0 = 0x3B;
-                    memcpy(&m_unPayloadTXFIFOBuffer.byArray[0], (byte *)patable_power_915, 8);
+                    l_abyFreq[0] = 0x23;
+                    l_abyFreq[1] = 0x31;
+                    l_abyFreq[2] = 0x3B;
+                    l_pbyPATable = (byte *)patable_power_915;
                     break;
 
         //default is 868.3MHz
         default:                                                             
-                    l_byFreq2 = 0x21;
-                    l_byFreq1 = 0x65;
-                    l_byFreq0 = 0x6A;
-                    memcpy(&m_unPayloadTXFIFOBuffer.byArray[0], (byte *)patable_power_868, 8);
+                    l_abyFreq[0] = 0x21;
+                    l_abyFreq[1] = 0x65;
+                    l_abyFreq[2] = 0x6A;
+                    l_pbyPATable = (byte *)patable_power_868;
                     break;
     }
 
-    spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS::WRITE_PATABLE_ARRAY, &m_unPayloadTXFIFOBuffer.byArray[0], 8);
+    writePATable(l_pbyPATable);
 
-    //stores the new freq setting for defined ISM band
-    spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::FREQ2, l_byFreq2);                                         
-    spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::FREQ1, l_byFreq1);
-    spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::FREQ0, l_byFreq0);
+    //stores the new freq setting for defined ISM band (FREQ2, FREQ1, FREQ0)
+    writeRegisters(ENM_CC1101_READ_WRITE_REGISTERS::FREQ2, l_abyFreq, 3);
 
 }
 
@@ -652,12 +1525,28 @@ void CCC1100::setBaudeRateAndModulation(ENM_BAUD_RATE_MODULATION p_enumBaudRateM
             break;
     }
 
-    memcpy(&m_unPayloadTXFIFOBuffer.byArray[0], l_pCFGRegister, CFG_REGISTER_SIZE);
-    spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS::WRITE_ARRAY, &m_unPayloadTXFIFOBuffer.byArray[0], CFG_REGISTER_SIZE);
+    //only registers differing from the current profile are written
+    writeRegisters(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, l_pCFGRegister, CFG_REGISTER_SIZE);
 
     //store value of IOCFG2 ([0]) register used later when an interrupt occurs
     m_byRegisterIOCFG2Settings = *l_pCFGRegister;
+    //keep the profile table, used when switching link profile
+    m_pbyCFGRegisters = l_pCFGRegister;
+    m_enmLinkProfile = ENM_LINK_PROFILE::STANDARD;
 }
+/**
+ *   Read the current RSSI
+ *   params: 
+ *       NONE
+ *   return:
+ *       RSSI in dBm       
+ */
+int16_t CCC1100::getRSSI() {
+    int16_t l_iRSSI = (int8_t)spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS::RSSI);
+
+    return (l_iRSSI / 2) - RSSI_OFFSET_868MHZ;
+}
+
 /**
  *   Read an single byte from a register 
  *   params: 
@@ -667,7 +1556,12 @@ void CCC1100::setBaudeRateAndModulation(ENM_BAUD_RATE_MODULATION p_enumBaudRateM
  */
 byte CCC1100::spiReadRegister(ENM_CC1101_READ_WRITE_REGISTERS p_enumRegister) {
     byte l_byDataAray[2];
-    l_byDataAray[0] = p_enumRegister;
+
+    if (m_bRegistersShadowValid) {
+        return m_abyRegistersShadow[p_enumRegister];
+    }
+
+    l_byDataAray[0] = p_enumRegister | ENM_CC1101_READ_BURST_COMMANDS::READ_SINGLE;
 
     spiTransaction(l_byDataAray, 2);
 
@@ -700,43 +1594,187 @@ byte CCC1100::spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS p_enumRegister) {
  */
 void CCC1100::spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS p_enumRegister, byte p_byData) {
     byte l_byDataAray[2];
+
+    if (m_bRegistersShadowValid && (m_abyRegistersShadow[p_enumRegister] == p_byData)) {
+        return;
+    }
+
     l_byDataAray[0] = p_enumRegister;
     l_byDataAray[1] = p_byData;
 
     spiTransaction(l_byDataAray, 2);
+
+    m_abyRegistersShadow[p_enumRegister] = p_byData;
+}
+
+/**
+ *   Write consecutive configuration registers through the shadow copy. Only the runs of registers 
+ *   which differ are written, each run in a single burst. Everything is written when the shadow 
+ *   copy is not valid (after reset)
+ *   params: 
+ *       p_byFirstRegister:  address of the first register
+ *       p_pbyValues:        values of the registers
+ *       p_byCount:          count of registers
+ *   return:
+ *       NONE      
+ */
+void CCC1100::writeRegisters(byte p_byFirstRegister, const byte *p_pbyValues, byte p_byCount) {
+    byte l_byIndex = 0;
+    byte l_byRunStart;
+    byte l_byRunEnd;
+    byte l_byGap;
+
+    while (l_byIndex < p_byCount) {
+        //skip unchanged registers
+        if (m_bRegistersShadowValid && (m_abyRegistersShadow[p_byFirstRegister + l_byIndex] == p_pbyValues[l_byIndex])) {
+            l_byIndex++;
+            continue;
+        }
+
+        //extend the run while the next changed register is close enough
+        l_byRunStart = l_byIndex;
+        l_byRunEnd = l_byIndex;
+        l_byGap = 0;
+        for (l_byIndex++; (l_byIndex < p_byCount) && (l_byGap <= SHADOW_MAX_BURST_GAP); l_byIndex++) {
+            if (m_bRegistersShadowValid && (m_abyRegistersShadow[p_byFirstRegister + l_byIndex] == p_pbyValues[l_byIndex])) {
+                l_byGap++;
+            } else {
+                l_byRunEnd = l_byIndex;
+                l_byGap = 0;
+            }
+        }
+        l_byIndex = l_byRunEnd + 1;
+
+        m_abySPIRegistersFrame[0] = (p_byFirstRegister + l_byRunStart) | ENM_CC1101_WRITE_BURST_COMMANDS::WRITE_ARRAY;
+        memcpy(&m_abySPIRegistersFrame[1], &p_pbyValues[l_byRunStart], l_byRunEnd - l_byRunStart + 1);
+        spiTransaction(m_abySPIRegistersFrame, l_byRunEnd - l_byRunStart + 2);
+
+        memcpy(&m_abyRegistersShadow[p_byFirstRegister + l_byRunStart], &p_pbyValues[l_byRunStart], l_byRunEnd - l_byRunStart + 1);
+    }
+
+    //full image written
+    if ((p_byFirstRegister == 0) && (p_byCount == CFG_REGISTER_SIZE)) {
+        m_bRegistersShadowValid = true;
+    }
+}
+
+/**
+ *   Write the PATABLE through its shadow copy
+ *   params: 
+ *       p_pbyValues:        PATABLE_SIZE values
+ *   return:
+ *       NONE      
+ */
+void CCC1100::writePATable(const byte *p_pbyValues) {
+    if (m_bPATableShadowValid && (memcmp(m_abyPATableShadow, p_pbyValues, PATABLE_SIZE) == 0)) {
+        return;
+    }
+
+    m_abySPIRegistersFrame[0] = ENM_CC1101_WRITE_BURST_COMMANDS::WRITE_PATABLE_ARRAY;
+    memcpy(&m_abySPIRegistersFrame[1], p_pbyValues, PATABLE_SIZE);
+    spiTransaction(m_abySPIRegistersFrame, PATABLE_SIZE + 1);
+
+    memcpy(m_abyPATableShadow, p_pbyValues, PATABLE_SIZE);
+    m_bPATableShadowValid = true;
+}
+
+/**
+ *   Restore the whole configuration from the shadow copy in a single burst, then the PATABLE.
+ *   PATABLE and test registers are lost in SLEEP state
+ *   params: 
+ *       NONE
+ *   return:
+ *       NONE      
+ */
+void CCC1100::restoreRegisters() {
+    m_abySPIRegistersFrame[0] = ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2 | ENM_CC1101_WRITE_BURST_COMMANDS::WRITE_ARRAY;
+    memcpy(&m_abySPIRegistersFrame[1], m_abyRegistersShadow, CFG_REGISTER_SIZE);
+    spiTransaction(m_abySPIRegistersFrame, CFG_REGISTER_SIZE + 1);
+
+    m_abySPIRegistersFrame[0] = ENM_CC1101_WRITE_BURST_COMMANDS::WRITE_PATABLE_ARRAY;
+    memcpy(&m_abySPIRegistersFrame[1], m_abyPATableShadow, PATABLE_SIZE);
+    spiTransaction(m_abySPIRegistersFrame, PATABLE_SIZE + 1);
 }
 
 /**
  *   Read an array of bytes from a register
  *   params: 
  *       p_enumBurstCOmmande:    byte register.
- *       p_pbyDataArray:         bytes' array filled with data readed from the register
+ *       p_pstrctFrame:          frame whose payload is filled with data readed from the register
+ *       p_uiOffset:             offset into the payload where data are stored
  *       p_byLengthToRead:       length of bytes to read
  *   return:
  *       NONE       
  */
-void CCC1100::spiReadBurst(ENM_CC1101_READ_BURST_COMMANDS p_enumBurstCommande, byte *p_pbyDataArray, byte p_byLengthToRead) {
-    *p_pbyDataArray = p_enumBurstCommande;
-    spiTransaction(p_pbyDataArray, p_byLengthToRead + 1);
-    memmove(p_pbyDataArray, p_pbyDataArray+1, p_byLengthToRead);
+void CCC1100::spiReadBurst(ENM_CC1101_READ_BURST_COMMANDS p_enumBurstCommande, STRUCT_SPI_BURST_FRAME *p_pstrctFrame, uint16_t p_uiOffset, byte p_byLengthToRead) {
+    //the byte preceding the data holds the command, it is the last byte of the previous chunk when streaming
+    byte *l_pbyCommand = (byte *)p_pstrctFrame + p_uiOffset;
+    byte l_bySavedByte = *l_pbyCommand;
+
+    *l_pbyCommand = p_enumBurstCommande;
+    spiTransaction(l_pbyCommand, p_byLengthToRead + 1);
+    *l_pbyCommand = l_bySavedByte;
 }
 
 /**
  *   Write an array of bytes to a register
  *   params: 
  *       p_enumBustCommand:  burst write command.
- *       p_pbyDataArray:     bytes' array to write to the register
- *       p_byLengthToWrite:  length of bytes' array to write
+ *       p_pstrctFrame:      frame whose payload is written to the register
+ *       p_uiOffset:         offset into the payload of the first byte to write
+ *       p_byLengthToWrite:  length of bytes to write
  *   return:
  *       NONE      
  */
-void CCC1100::spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS p_enumBustCommand, byte *p_pbyDataArray, byte p_byLengthToWrite) {
-    memmove(&m_unPayloadTXFIFOBuffer.byArray[1], &m_unPayloadTXFIFOBuffer.byArray[0], p_byLengthToWrite + 1);
-    m_unPayloadTXFIFOBuffer.byArray[0] = p_enumBustCommand;
-    spiTransaction(&m_unPayloadTXFIFOBuffer.byArray[0], p_byLengthToWrite + 2);
+void CCC1100::spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS p_enumBustCommand, STRUCT_SPI_BURST_FRAME *p_pstrctFrame, uint16_t p_uiOffset, byte p_byLengthToWrite) {
+    //the byte preceding the data holds the command, it is the last byte of the previous chunk when streaming
+    byte *l_pbyCommand = (byte *)p_pstrctFrame + p_uiOffset;
+    byte l_bySavedByte = *l_pbyCommand;
+
+    *l_pbyCommand = p_enumBustCommand;
+    spiTransaction(l_pbyCommand, p_byLengthToWrite + 1);
+    *l_pbyCommand = l_bySavedByte;
 }
 
 
+#ifdef _BENCHMARK_
+/**
+ *   Log the average duration of a register access and of a full FIFO burst
+ *   params: 
+ *       NONE
+ *   return:
+ *       NONE      
+ */
+void CCC1100::benchmarkSPI() {
+    const uint16_t l_uiLoops = 1000;
+    uint32_t l_ulStartTime;
+    uint16_t l_uiIndex;
+
+    sidle();
+
+    l_ulStartTime = micros();
+    for (l_uiIndex = 0; l_uiIndex < l_uiLoops; l_uiIndex++) {
+        spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS::MARCSTATE);
+    }
+    LOG_INFO_PRINTLN(LOG_PREFIX_CC1100, "register read (us x1000)", micros() - l_ulStartTime);
+
+    l_ulStartTime = micros();
+    for (l_uiIndex = 0; l_uiIndex < l_uiLoops; l_uiIndex++) {
+        //alternate values, unchanged ones are skipped by the shadow copy
+        spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, (l_uiIndex & 0x01) ? IOCFG_SYNC_WORD : m_byRegisterIOCFG2Settings);
+    }
+    spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS::IOCFG2, m_byRegisterIOCFG2Settings);
+    LOG_INFO_PRINTLN(LOG_PREFIX_CC1100, "register write (us x1000)", micros() - l_ulStartTime);
+
+    l_ulStartTime = micros();
+    for (l_uiIndex = 0; l_uiIndex < l_uiLoops; l_uiIndex++) {
+        spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS::TXFIFO_ARRAY, &m_strctTXFrame, 0, FIFO_SIZE);
+        spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS::SFTX);
+    }
+    LOG_INFO_PRINTLN(LOG_PREFIX_CC1100, "FIFO burst + flush (us x1000)", micros() - l_ulStartTime);
+}
+#endif
+
 /**
  *   Write a single byte instruction to the device
  *   params: 
@@ -753,6 +1791,8 @@ void CCC1100::spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS p_enumStrobeCommand) {
 
 /**
  *   Perform SPI transaction, as much as for Read and Write
+ *   CS is driven through the PORT registers. CC1101 CS setup and hold times (20ns when the 
+ *   crystal is running, the device is never put in SLEEP/XOFF) are shorter than a register access.
  *   params: 
  *       p_pbyData:  pointer to the bytes array containing the data to write.
  *                   If the transaction expects some incoming data (read), then 
@@ -763,11 +1803,9 @@ void CCC1100::spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS p_enumStrobeCommand) {
  *       NONE (readed data are returned into p_pbyData)      
  */
 void CCC1100::spiTransaction(byte *p_pbyData, byte p_byLength) {
-    SPI.beginTransaction (SPISettings (SPI_CLOCK, SPI_DATA_ORDER, SPI_MODE));  
-    digitalWrite(PIN_CC1100_CS, LOW);
-    delayMicroseconds(10);
+    SPI.beginTransaction(m_spiSettings);  
+    *m_pulCSOutClearRegister = m_ulCSPinMask;
     SPI.transfer(p_pbyData, p_byLength);
-    delayMicroseconds(10);
-    digitalWrite(PIN_CC1100_CS, HIGH);
-    SPI.endTransaction ();  
+    *m_pulCSOutSetRegister = m_ulCSPinMask;
+    SPI.endTransaction();  
 }
@@ -24,26 +24,38 @@
 #ifndef _CCC1100_H_
 #define _CCC1100_H_
 
-#include "global.h"
+#include "Global.h"
 #include "CCircularBuffer.h"
+#include "CDownlinkQueue.h"
 #include <SPI.h>
 
-#include "logging.h"
+#include "Logging.h"
 
 #define PIN_CC1100_CS                       2   
 #define PIN_CC1100_GD02                     3 
 
-#define SPI_CLOCK                           4000000
+#define SPI_CLOCK                           6000000   //CC1101 burst access without inter-byte delay is limited to 6.5MHz
 #define SPI_DATA_ORDER                      MSBFIRST
 #define SPI_MODE                            SPI_MODE0
 
-#define MAX_RADIO_MESSAGE_DATA_LENGTH       32
-#define MAX_RADIO_MESSAGE_LENGTH            sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_HEADER) + sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE)
+#define MAX_RADIO_PACKET_LENGTH             255   //CC1101 variable packet length limit, packets longer than the FIFO are streamed
+#define MAX_RADIO_MESSAGE_DATA_LENGTH       120
+#define MAX_RADIO_MESSAGE_LENGTH            (sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_HEADER) + sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE))
+
+//FEC profile: fixed length packets, shorter in order to limit the doubled air time
+#define FEC_MAX_RADIO_MESSAGE_DATA_LENGTH   16
+#define FEC_PACKET_LENGTH                   (sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_HEADER) + sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE) - MAX_RADIO_MESSAGE_DATA_LENGTH + FEC_MAX_RADIO_MESSAGE_DATA_LENGTH)
+#define FEC_REQUEST_RETRIES_THRESHOLD       2       //retries of a message making the device request the FEC profile
+#define FEC_HOLD_TIME                       3600000 //ms. bridge in FEC on-request mode goes back to standard without new request 
 
 //----------------------[CC1100 - misc]---------------------------------------
 #define CRYSTAL_FREQUENCY                   26000000
 #define CFG_REGISTER_SIZE                   0x2F  //47 registers
-#define FIFO_BUFFER_SIZE                    0x42  //size of Fifo Buffer
+#define PATABLE_SIZE                        0x08
+#define SHADOW_MAX_BURST_GAP                2     //unchanged registers rewritten rather than splitting a burst
+#define FIFO_SIZE                           0x40  //size of the RX and TX FIFOs
+#define RX_FIFO_THRESHOLD                   32    //bytes, cf FIFOTHR FIFO_THR = 7 of every configuration. TX threshold is 33 bytes
+#define FRAME_BUFFER_SIZE                   (MAX_RADIO_PACKET_LENGTH + 1 + 2)  //length byte, packet, RSSI and LQI bytes
 #define RSSI_OFFSET_868MHZ                  0x4E  //dec = 74
 #define TX_RETRIES_MAX                      0x05  //tx_retries_max
 #define ACK_TIMEOUT                         200  //ACK timeout in ms
@@ -57,16 +69,49 @@
 #define CC1100_TEMP_ADC_MV                  3.225 //3.3V/1023 . mV pro digit
 #define CC1100_TEMP_CELS_CO                 2.47  //Temperature coefficient 2.47mV per Grad Celsius
 
+//----------------------[CC1100 - channel hopping]-----------------------------
+#define HOPPING_SEQUENCE_LENGTH             8     //channels of a network plan: home channel + 7 following ones
+#define HOPPING_ELAPSED_TIME_UNIT_MS        10    //resolution of the slot elapsed time carried by acknowledges
+#define HOPPING_NOISE_RSSI_THRESHOLD        -90   //dBm. averaged idle RSSI above this value blacklists the channel
+#define HOPPING_NOISE_SAMPLE_PERIOD_MS      250   //minimum time between two idle RSSI samples, each one costs an SPI access
+#define HOPPING_INVALID_FRAMES_THRESHOLD    4     //invalid frames per slot (and more than valid ones) blacklisting the channel. CRC failures included
+#define HOPPING_BLACKLIST_CYCLES            16    //count of full sequences during which a blacklisted channel is skipped
+
+//----------------------[CC1100 - state machine timings]----------------------
+#define CC1100_STATE_TIMEOUT_US             2000  //upper bound of a strobe state transition, calibration included
+#define CC1100_TX_TIMEOUT_MS                500   //upper bound of a packet transmission at the lowest data rate
+#define CC1100_ACK_TIMEOUT_MS               300   //acknowledge waiting time after a transmission
+#define CC1100_FIFO_TIMEOUT_MS              250   //upper bound without FIFO progress while streaming a packet
+
+//----------------------[CC1100 - registers bits]------------------------------
+#define IOCFG_SYNC_WORD                     0x06  //GDOx asserts when sync word is sent/received, deasserts at end of packet
+#define IOCFG_RX_FIFO_THRESHOLD             0x00  //GDOx asserts when RX FIFO reaches its threshold, deasserts when drained below
+#define IOCFG_TX_FIFO_THRESHOLD             0x02  //GDOx asserts when TX FIFO is at or above its threshold, deasserts below
+#define IOCFG_INVERT                        0x40  //GDOx active low: the GDO2 interrupt is on rising edges only
+#define FIFOBYTES_OVERFLOW                  0x80  //RXBYTES overflow and TXBYTES underflow flag
+#define LQI_CRC_OK                          0x80
+#define MDMCFG1_FEC_EN                      0x80
+#define PKTCTRL0_LENGTH_CONFIG              0x03
+#define PKTCTRL1_ADR_CHK                    0x03
+
+//----------------------[payload header flags]---------------------------------
+#define RADIO_FLAG_FEC_REQUEST              (1 << 0)
+#define RADIO_FLAG_REFUSED                  (1 << 1)    //acknowledge of a message the bridge could not accept: send it again after the hold-off
+#define RADIO_FLAG_DOWNLINK_CONFIRM         (1 << 2)    //message data followed by the sequence of the last downlink command applied
+
+//----------------------[back-pressure]----------------------------------------
+#define RADIO_ACCEPT_UNLIMITED              0xFF  //no admission limit set by the application
+
 //-------------------[global EEPROM default settings 868 Mhz]-------------------
 const byte cc1100_GFSK_1_2_kb[CFG_REGISTER_SIZE] PROGMEM = {
-                    0x07,  // IOCFG2        GDO2 Output Pin Configuration
+                    0x01,  // IOCFG2        GDO2 Output Pin Configuration
                     0x2E,  // IOCFG1        GDO1 Output Pin Configuration
                     0x80,  // IOCFG0        GDO0 Output Pin Configuration
                     0x07,  // FIFOTHR       RX FIFO and TX FIFO Thresholds
                     0x57,  // SYNC1         Sync Word, High Byte
                     0x43,  // SYNC0         Sync Word, Low Byte
                     0x3E,  // PKTLEN        Packet Length
-                    0x0E,  // PKTCTRL1      Packet Automation Control
+                    0x06,  // PKTCTRL1      Packet Automation Control
                     0x45,  // PKTCTRL0      Packet Automation Control
                     0xFF,  // ADDR          Device Address
                     0x00,  // CHANNR        Channel Number
@@ -82,7 +127,7 @@ const byte cc1100_GFSK_1_2_kb[CFG_REGISTER_SIZE] PROGMEM = {
                     0xF8,  // MDMCFG0       Modem Configuration
                     0x15,  // DEVIATN       Modem Deviation Setting
                     0x07,  // MCSM2         Main Radio Control State Machine Configuration
-                    0x0C,  // MCSM1         Main Radio Control State Machine Configuration
+                    0x0F,  // MCSM1         Main Radio Control State Machine Configuration
                     0x18,  // MCSM0         Main Radio Control State Machine Configuration
                     0x16,  // FOCCFG        Frequency Offset Compensation Configuration
                     0x6C,  // BSCFG         Bit Synchronization Configuration
@@ -109,14 +154,14 @@ const byte cc1100_GFSK_1_2_kb[CFG_REGISTER_SIZE] PROGMEM = {
                 };
 
 const byte cc1100_GFSK_38_4_kb[CFG_REGISTER_SIZE] PROGMEM = {
-                    0x07,  // IOCFG2        GDO2 Output Pin Configuration
+                    0x01,  // IOCFG2        GDO2 Output Pin Configuration
                     0x2E,  // IOCFG1        GDO1 Output Pin Configuration
                     0x80,  // IOCFG0        GDO0 Output Pin Configuration
                     0x07,  // FIFOTHR       RX FIFO and TX FIFO Thresholds
                     0x57,  // SYNC1         Sync Word, High Byte
                     0x43,  // SYNC0         Sync Word, Low Byte
                     0x3E,  // PKTLEN        Packet Length
-                    0x0E,  // PKTCTRL1      Packet Automation Control
+                    0x06,  // PKTCTRL1      Packet Automation Control
                     0x45,  // PKTCTRL0      Packet Automation Control
                     0xFF,  // ADDR          Device Address
                     0x00,  // CHANNR        Channel Number
@@ -132,7 +177,7 @@ const byte cc1100_GFSK_38_4_kb[CFG_REGISTER_SIZE] PROGMEM = {
                     0xF8,  // MDMCFG0       Modem Configuration
                     0x34,  // DEVIATN       Modem Deviation Setting
                     0x07,  // MCSM2         Main Radio Control State Machine Configuration
-                    0x0C,  // MCSM1         Main Radio Control State Machine Configuration
+                    0x0F,  // MCSM1         Main Radio Control State Machine Configuration
                     0x18,  // MCSM0         Main Radio Control State Machine Configuration
                     0x16,  // FOCCFG        Frequency Offset Compensation Configuration
                     0x6C,  // BSCFG         Bit Synchronization Configuration
@@ -159,14 +204,14 @@ const byte cc1100_GFSK_38_4_kb[CFG_REGISTER_SIZE] PROGMEM = {
                 };
 
 const byte cc1100_GFSK_100_kb[CFG_REGISTER_SIZE] PROGMEM = {
-                    0x07,  // IOCFG2        GDO2 Output Pin Configuration
+                    0x01,  // IOCFG2        GDO2 Output Pin Configuration
                     0x2E,  // IOCFG1        GDO1 Output Pin Configuration
                     0x80,  // IOCFG0        GDO0 Output Pin Configuration
                     0x07,  // FIFOTHR       RX FIFO and TX FIFO Thresholds
                     0x57,  // SYNC1         Sync Word, High Byte
                     0x43,  // SYNC0         Sync Word, Low Byte
                     0x3E,  // PKTLEN        Packet Length
-                    0x0F,  // PKTCTRL1      Packet Automation Control
+                    0x07,  // PKTCTRL1      Packet Automation Control
                     0x45,  // PKTCTRL0      Packet Automation Control
                     0xFF,  // ADDR          Device Address
                     0x00,  // CHANNR        Channel Number
@@ -182,7 +227,7 @@ const byte cc1100_GFSK_100_kb[CFG_REGISTER_SIZE] PROGMEM = {
                     0xF8,  // MDMCFG0       Modem Configuration
                     0x47,  // DEVIATN       Modem Deviation Setting
                     0x07,  // MCSM2         Main Radio Control State Machine Configuration
-                    0x0C,  // MCSM1         Main Radio Control State Machine Configuration
+                    0x0F,  // MCSM1         Main Radio Control State Machine Configuration
                     0x18,  // MCSM0         Main Radio Control State Machine Configuration
                     0x1D,  // FOCCFG        Frequency Offset Compensation Configuration
                     0x1C,  // BSCFG         Bit Synchronization Configuration
@@ -209,14 +254,14 @@ const byte cc1100_GFSK_100_kb[CFG_REGISTER_SIZE] PROGMEM = {
                 };
 
 const byte cc1100_MSK_250_kb[CFG_REGISTER_SIZE] PROGMEM = {
-                    0x07,  // IOCFG2        GDO2 Output Pin Configuration
+                    0x01,  // IOCFG2        GDO2 Output Pin Configuration
                     0x2E,  // IOCFG1        GDO1 Output Pin Configuration
                     0x80,  // IOCFG0        GDO0 Output Pin Configuration
                     0x07,  // FIFOTHR       RX FIFO and TX FIFO Thresholds
                     0x57,  // SYNC1         Sync Word, High Byte
                     0x43,  // SYNC0         Sync Word, Low Byte
                     0x3E,  // PKTLEN        Packet Length
-                    0x0E,  // PKTCTRL1      Packet Automation Control
+                    0x06,  // PKTCTRL1      Packet Automation Control
                     0x45,  // PKTCTRL0      Packet Automation Control
                     0xFF,  // ADDR          Device Address
                     0x00,  // CHANNR        Channel Number
@@ -232,7 +277,7 @@ const byte cc1100_MSK_250_kb[CFG_REGISTER_SIZE] PROGMEM = {
                     0xF8,  // MDMCFG0       Modem Configuration
                     0x00,  // DEVIATN       Modem Deviation Setting
                     0x07,  // MCSM2         Main Radio Control State Machine Configuration
-                    0x0C,  // MCSM1         Main Radio Control State Machine Configuration
+                    0x0F,  // MCSM1         Main Radio Control State Machine Configuration
                     0x18,  // MCSM0         Main Radio Control State Machine Configuration
                     0x1D,  // FOCCFG        Frequency Offset Compensation Configuration
                     0x1C,  // BSCFG         Bit Synchronization Configuration
@@ -259,14 +304,14 @@ const byte cc1100_MSK_250_kb[CFG_REGISTER_SIZE] PROGMEM = {
                 };
 
 const byte cc1100_MSK_500_kb[CFG_REGISTER_SIZE] PROGMEM = {
-                    0x07,  // IOCFG2        GDO2 Output Pin Configuration
+                    0x01,  // IOCFG2        GDO2 Output Pin Configuration
                     0x2E,  // IOCFG1        GDO1 Output Pin Configuration
                     0x80,  // IOCFG0        GDO0 Output Pin Configuration
                     0x07,  // FIFOTHR       RX FIFO and TX FIFO Thresholds
                     0x57,  // SYNC1         Sync Word, High Byte
                     0x43,  // SYNC0         Sync Word, Low Byte
                     0x3E,  // PKTLEN        Packet Length
-                    0x0E,  // PKTCTRL1      Packet Automation Control
+                    0x06,  // PKTCTRL1      Packet Automation Control
                     0x45,  // PKTCTRL0      Packet Automation Control
                     0xFF,  // ADDR          Device Address
                     0x00,  // CHANNR        Channel Number
@@ -282,7 +327,7 @@ const byte cc1100_MSK_500_kb[CFG_REGISTER_SIZE] PROGMEM = {
                     0xF8,  // MDMCFG0       Modem Configuration
                     0x00,  // DEVIATN       Modem Deviation Setting
                     0x07,  // MCSM2         Main Radio Control State Machine Configuration
-                    0x0C,  // MCSM1         Main Radio Control State Machine Configuration
+                    0x0F,  // MCSM1         Main Radio Control State Machine Configuration
                     0x18,  // MCSM0         Main Radio Control State Machine Configuration
                     0x1D,  // FOCCFG        Frequency Offset Compensation Configuration
                     0x1C,  // BSCFG         Bit Synchronization Configuration
@@ -309,7 +354,7 @@ const byte cc1100_MSK_500_kb[CFG_REGISTER_SIZE] PROGMEM = {
                 };
 
 const byte cc1100_OOK_4_8_kb[CFG_REGISTER_SIZE] PROGMEM = {
-                    0x06,  // IOCFG2        GDO2 Output Pin Configuration
+                    0x01,  // IOCFG2        GDO2 Output Pin Configuration
                     0x2E,  // IOCFG1        GDO1 Output Pin Configuration
                     0x06,  // IOCFG0        GDO0 Output Pin Configuration
                     0x47,  // FIFOTHR       RX FIFO and TX FIFO Thresholds
@@ -332,7 +377,7 @@ const byte cc1100_OOK_4_8_kb[CFG_REGISTER_SIZE] PROGMEM = {
                     0xF8,  // MDMCFG0       Modem Configuration
                     0x15,  // DEVIATN       Modem Deviation Setting
                     0x07,  // MCSM2         Main Radio Control State Machine Configuration
-                    0x30,  // MCSM1         Main Radio Control State Machine Configuration
+                    0x33,  // MCSM1         Main Radio Control State Machine Configuration
                     0x18,  // MCSM0         Main Radio Control State Machine Configuration
                     0x14,  // FOCCFG        Frequency Offset Compensation Configuration
                     0x6C,  // BSCFG         Bit Synchronization Configuration
@@ -372,6 +417,8 @@ public:
     enum ENM_OUTPUT_POWER_DBM {MINUS_30=1, MINUS_20, MINUS_15, MINUS_10, PLUS_0, PLUS_5, PLUS_7, PLUS_10};
     enum ENM_BAUD_RATE_MODULATION {GFSK_1_2_kb=1, GFSK_38_4_kb, GFSK_100_kb, MSK_250_kb, MSK_500_kb, OOK_4_8_kb};
     enum ENM_PAYLOAD_TYPE {ACK=0x00, MSG=0x01};
+    enum ENM_LINK_PROFILE {STANDARD=0, FEC};
+    enum ENM_FEC_MODE {FEC_OFF=0, FEC_ON, FEC_ON_REQUEST};
 
     struct STRUCT_RADIO_PAYLOAD_HEADER {
         byte                byPayloadLength;
@@ -379,6 +426,7 @@ public:
         byte                bySenderAddr;
         word                wMessageToken;
         byte                byPayloadType;  
+        byte                byFlags;            //cf RADIO_FLAG_*
     } __attribute__ ((packed));     //non aligment pragma
 
     struct STRUCT_RADIO_PAYLOAD_MESSAGE {
@@ -392,23 +440,68 @@ public:
         STRUCT_RADIO_PAYLOAD_MESSAGE    strctPayloadMessage;
         byte                            byRSSI;
         byte                            byLQI;
-        byte                            _dummy[FIFO_BUFFER_SIZE - MAX_RADIO_MESSAGE_LENGTH - 2];        
+        byte                            _dummy[FRAME_BUFFER_SIZE - MAX_RADIO_MESSAGE_LENGTH - 2];        
+    } __attribute__ ((packed));     //non aligment pragma
+
+    //data appended by the bridge to every acknowledge, used by devices to synchronize on the hopping sequence
+    struct STRUCT_RADIO_ACK_DATA {
+        byte                byHoppingDwellTime;         //seconds, 0 if hopping is disabled
+        byte                byHoppingIndex;
+        word                wHoppingSlotElapsedTime;    //cf HOPPING_ELAPSED_TIME_UNIT_MS
+        byte                byChannelBlacklist;         //bit n set if sequence index n is blacklisted
+        byte                byLinkProfile;              //profile used by the bridge from now on, cf ENM_LINK_PROFILE
+        byte                byOccupancy;                //percent of the bridge upload pipeline in use
+        byte                byHoldOff;                  //seconds, suggested delay before the next message. 0 if not congested
+    } __attribute__ ((packed));     //non aligment pragma
+
+    //downlink commands follow the acknowledge data, only when some are pending for the recipient
+    struct STRUCT_RADIO_ACK_PAYLOAD {
+        STRUCT_RADIO_PAYLOAD_HEADER     strctPayLoadHeader;
+        STRUCT_RADIO_ACK_DATA           strctAckData;
+        byte                            byCommandsCount;
+        STRUCT_RADIO_DOWNLINK_COMMAND   astrctCommands[RADIO_DOWNLINK_MAX_COMMANDS];
     } __attribute__ ((packed));     //non aligment pragma
 
     union UNION_PAYLOAD {
-        byte                    byArray[FIFO_BUFFER_SIZE];
-        STRUCT_RADIO_PAYLOAD    strctPayLoad;
+        byte                        byArray[FRAME_BUFFER_SIZE];
+        STRUCT_RADIO_PAYLOAD        strctPayLoad;
+        STRUCT_RADIO_ACK_PAYLOAD    strctAckPayLoad;
     };
+
+    //SPI burst frame: the command byte is reserved ahead of the payload, so nothing is shifted
+    struct STRUCT_SPI_BURST_FRAME {
+        byte                        byCommand;
+        UNION_PAYLOAD               unPayload;
+    } __attribute__ ((packed));     //non aligment pragma
     
     boolean postMessage(byte p_pyRecipientAddr, STRUCT_RADIO_PAYLOAD_MESSAGE *p_pstrRadioPayloadMessage, byte p_byTXRetryMax);
     int16_t getMessage(STRUCT_RADIO_PAYLOAD_MESSAGE *p_pstrRadioPayloadMessage);
+    int16_t getMessageRSSI();
+    byte getMessageLQI();
     byte getVersion();
     byte getPartNumber();
     void interruptHandler();
     boolean poll();
-    boolean init(byte p_byDeviceAdd, ENM_OUTPUT_POWER_DBM p_byOutputPowerLevel, uint16_t p_uiMsgSignature);
+    byte getChannel();
+    byte getChannelBlacklist();
+    ENM_LINK_PROFILE getLinkProfile();
+    byte getMaxMessageDataLength();
+    STRUCT_RADIO_LINK_STATS *getLinkStats(ENM_LINK_PROFILE p_enmLinkProfile);
+    void setBackPressure(byte p_byAcceptedReadings, byte p_byOccupancy, byte p_byHoldOff);
+    byte getHoldOff();
+    void setDownlinkQueue(CDownlinkQueue *p_pDownlinkQueue);
+    byte getDownlinkCommands(STRUCT_RADIO_DOWNLINK_COMMAND *p_pstrctCommands);
+    void setOutputPowerLevel(ENM_OUTPUT_POWER_DBM p_enumDBPowerLever);
+    boolean init(byte p_byDeviceAdd, ENM_OUTPUT_POWER_DBM p_byOutputPowerLevel, uint16_t p_uiMsgSignature, 
+                    byte p_byHomeChannel, byte p_byHoppingDwellTime, ENM_FEC_MODE p_enmFECMode);
+    void powerDown();
+    void wakeUp();
     
 private:
+#ifdef PIO_UNIT_TESTING
+    friend class CCC1100Test;       //host tests, cf test/test_radio_frames
+#endif
+
     enum ENM_CC1101_MARCSTATES {SLEEP=0x00, IDLE, XOFF, VCOON_LC, REGON_MC, MANCAL, VCOON, REGON, STARTCAL, BWBOOST, FS_LOCK, IFADCON, ENDCAL, 
                                 RX, RX_END, RX_RST, TXRX_SWITCH, RXFIFO_OVERFLOW, FSTXON, TX, TX_END, RXTX_SWITXH, TXFIFO_UNDERFLOW};
     
@@ -516,12 +609,73 @@ private:
     };
 
 
+    //per sequence index statistics used in order to blacklist noisy channels
+    struct STRUCT_HOPPING_CHANNEL_STATS {
+        int32_t             iNoiseRSSISum;          //dBm
+        uint16_t            uiNoiseRSSICount;
+        uint8_t             uiValidFrames;
+        uint8_t             uiInvalidFrames;        //CRC failures, truncated frames and foreign signatures
+        uint8_t             uiBlacklistCycles;      //remaining sequences to skip, 0 if not blacklisted
+    };
+
     byte m_byDeviceAddr;
 
     uint16_t m_uiMessageSignature;
+
+    byte m_byHomeChannel;
+    byte m_byCurrentChannel;
+    byte m_byHoppingDwellTime;
+    byte m_abyHoppingSequence[HOPPING_SEQUENCE_LENGTH];
+    byte m_byHoppingIndex;
+    byte m_byChannelBlacklist = 0;
+    boolean m_bHoppingSynchronized = false;
+    TickType_t m_xHoppingSlotStartTick;
+    TickType_t m_xNoiseSampleTick = 0;
+    STRUCT_HOPPING_CHANNEL_STATS m_astrctHoppingStats[HOPPING_SEQUENCE_LENGTH];
+
+    const byte *m_pbyCFGRegisters;
+    ENM_FEC_MODE m_enmFECMode;
+    ENM_LINK_PROFILE m_enmLinkProfile = ENM_LINK_PROFILE::STANDARD;
+    ENM_LINK_PROFILE m_enmNextLinkProfile = ENM_LINK_PROFILE::STANDARD;
+    boolean m_bRequestFEC = false;
+    byte m_byMessageTransmissions;
+    boolean m_bFECRequestReceived = false;
+    TickType_t m_xFECRequestTick;
+    STRUCT_RADIO_LINK_STATS m_astrctLinkStats[RADIO_LINK_PROFILES_COUNT];
+
+    //back-pressure announced by the bridge acknowledges, and received by devices
+    byte m_byAcceptedReadings = RADIO_ACCEPT_UNLIMITED;
+    byte m_byQueuedReadings = 0;                    //readings of the messages waiting into the circular buffers
+    byte m_byOccupancy = 0;
+    byte m_byHoldOff = 0;
+    boolean m_bReceivedRefusal = false;
+    byte m_byReceivedHoldOff = 0;
+
+    //downlink commands: queued by the bridge, received and confirmed by devices
+    CDownlinkQueue *m_pDownlinkQueue = NULL;
+    STRUCT_RADIO_DOWNLINK_COMMAND m_astrctReceivedCommands[RADIO_DOWNLINK_MAX_COMMANDS];
+    byte m_byReceivedCommandsCount = 0;
+    byte m_byDownlinkConfirmSequence = 0;       //0: nothing to confirm
     
-    UNION_PAYLOAD   m_unPayloadRXFIFOBuffer;
-    UNION_PAYLOAD   m_unPayloadTXFIFOBuffer; 
+    STRUCT_SPI_BURST_FRAME  m_strctRXFrame;
+    STRUCT_SPI_BURST_FRAME  m_strctTXFrame; 
+    //TX frame streamed into the TX FIFO: total length and length already written
+    STRUCT_SPI_BURST_FRAME  *m_pstrctTXPendingFrame;
+    uint16_t                m_uiTXFrameLength;
+    uint16_t                m_uiTXFrameOffset;
+
+    //shadow copy of the configuration registers and PATABLE: writes of unchanged values are skipped
+    byte                m_abyRegistersShadow[CFG_REGISTER_SIZE];
+    byte                m_abyPATableShadow[PATABLE_SIZE];
+    boolean             m_bRegistersShadowValid = false;
+    boolean             m_bPATableShadowValid = false;
+    boolean             m_bPoweredDown = false;         //SLEEP state: any SPI access would wake the device up unconfigured
+    byte                m_abySPIRegistersFrame[CFG_REGISTER_SIZE + 1];
+
+    SPISettings         m_spiSettings = SPISettings(SPI_CLOCK, SPI_DATA_ORDER, SPI_MODE);
+    volatile uint32_t   *m_pulCSOutSetRegister;
+    volatile uint32_t   *m_pulCSOutClearRegister;
+    uint32_t            m_ulCSPinMask;
 
     byte m_byRegisterIOCFG2Settings;
     boolean m_bReceivedAck = false;
@@ -529,26 +683,47 @@ private:
     volatile boolean m_bReceiveIT = false;
 
     boolean getPayload();
-     void TXPayloadBurst(UNION_PAYLOAD *p_pstrctunionPayload);
+    void walkFrames(uint16_t p_uiReceivedLength);
+     void TXPayloadBurst(STRUCT_SPI_BURST_FRAME *p_pstrctFrame);
+    byte getFIFOBytes(ENM_CC1101_READ_ONLY_REGISTERS p_enumRegister);
     boolean checkAcknowledge(byte p_byRecipientAddr, byte p_bySenderAddr, byte p_byType);
-    void sendAcknowledge(byte p_byRecipientddr);
-    int8_t RXPayloadBurst();
+    void sendAcknowledge(byte p_byRecipientddr, boolean p_bRefused);
+    int16_t RXPayloadBurst();
     void setTransmitMode();
     void spiTransaction(byte *p_pbyData, byte p_byLength);
     void spiWriteStrobe(ENM_CC1101_STROBE_COMMANDS p_enumStrobeCommand);
-    void spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS p_enumBustCommand, byte *p_pbyDataArray, byte p_byLengthToWrite);
-    void spiReadBurst(ENM_CC1101_READ_BURST_COMMANDS p_enumBurstCOmmande, byte *p_pbyDataArray, byte p_byLengthToRead);
+    void spiWriteBurst(ENM_CC1101_WRITE_BURST_COMMANDS p_enumBustCommand, STRUCT_SPI_BURST_FRAME *p_pstrctFrame, uint16_t p_uiOffset, byte p_byLengthToWrite);
+    void spiReadBurst(ENM_CC1101_READ_BURST_COMMANDS p_enumBurstCOmmande, STRUCT_SPI_BURST_FRAME *p_pstrctFrame, uint16_t p_uiOffset, byte p_byLengthToRead);
     void spiWriteRegister(ENM_CC1101_READ_WRITE_REGISTERS p_enumRegister, byte p_byData);
+    void writeRegisters(byte p_byFirstRegister, const byte *p_pbyValues, byte p_byCount);
+    void writePATable(const byte *p_pbyValues);
+    void restoreRegisters();
     byte spiReadRegister(ENM_CC1101_READ_WRITE_REGISTERS p_enumRegister);
     byte spiReadRegister(ENM_CC1101_READ_ONLY_REGISTERS p_enumRegister);
     void setBaudeRateAndModulation(ENM_BAUD_RATE_MODULATION p_enumBaudRateModulation);
     void setISMBand(ENM_ISM_BAND p_enumISMBand);
     void setChannel(byte p_byChannelNumber);
-    void setOutputPowerLevel(ENM_OUTPUT_POWER_DBM p_enumDBPowerLever);
+    void initHoppingSequence();
+    byte getHoppingChannel(byte p_byHoppingIndex);
+    void updateHopping();
+    void updateChannelBlacklist(byte p_byLeftHoppingIndex, byte p_byEnteredHoppingIndex);
+    void synchronizeHopping(STRUCT_RADIO_ACK_DATA *p_pstrctAckData);
+    void tuneChannel(byte p_byChannelNumber);
+    boolean transmitPayload(byte p_byRecipientAddr, STRUCT_RADIO_PAYLOAD_MESSAGE *p_pstrRadioPayloadMessage, byte p_byTXRetryMax);
+    int16_t getRSSI();
+    void setLinkProfile(ENM_LINK_PROFILE p_enmLinkProfile);
+    void selectLinkProfile();
+    uint16_t getFrameLength(UNION_PAYLOAD *p_punionPayload);
     void setDeviceAddr(byte p_byAddr);
     void sidle();
     void setReceiveMode();
-    boolean checkUnitPayload(UNION_PAYLOAD *p_puinionPayload);
+    boolean waitMarcState(ENM_CC1101_MARCSTATES p_enmMarcState);
+#ifdef _BENCHMARK_
+    void benchmarkSPI();
+#endif
+    boolean waitGDO2(byte p_byLevel, uint32_t p_ulTimeoutMs);
+    boolean checkUnitPayload(UNION_PAYLOAD *p_puinionPayload, uint16_t p_uiFrameLength);
+    byte getMessageReadings(STRUCT_RADIO_PAYLOAD_MESSAGE *p_pstrctMessage);
 };
 
 #endif
\ No newline at end of file
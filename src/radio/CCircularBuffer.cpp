@@ -17,7 +17,7 @@
  *	Date: November 5th, 2020.
  */
 #include "CCircularBuffer.h"
-#include "logging.h"
+#include "Logging.h"
 
 /****************************************************************************************
  * 
@@ -53,12 +53,13 @@ void CCircularBuffer::init() {
 *   params: 
 *       p_pbyArray:                 pointer to the first byte of the arry. Size is fixed and defined into header. 
 *                                   cf CIRCULAR_BUFFER_FIXED_PAGE_SIZE  
+*       p_byLength:                 count of significant bytes, remaining bytes of the page are cleared
 *   return:
 *       true if array has been added, otherwise return false, meaning that no free buffer available       
 */
-boolean CCircularBuffer::push(byte *p_pbyArray) {
+boolean CCircularBuffer::push(byte *p_pbyArray, byte p_byLength) {
     //check if a free circulat buffer is available 
-    if (m_byCurrentSize++ <= MAX_CIRCULAR_BUFFER_FIXED_PAGES_COUNT) {
+    if (m_byCurrentSize < MAX_CIRCULAR_BUFFER_FIXED_PAGES_COUNT) {
 
         CCircularBuffer::buffer_page *l_pFreeBufferPage;
         
@@ -70,7 +71,11 @@ boolean CCircularBuffer::push(byte *p_pbyArray) {
             return false;
         } else {
             //copy byte array to circular buffer
-            memcpy(&l_pFreeBufferPage->bufferData[0], p_pbyArray, CIRCULAR_BUFFER_FIXED_PAGE_SIZE);
+            if (p_byLength > CIRCULAR_BUFFER_FIXED_PAGE_SIZE) {
+                p_byLength = CIRCULAR_BUFFER_FIXED_PAGE_SIZE;
+            }
+            memcpy(&l_pFreeBufferPage->bufferData[0], p_pbyArray, p_byLength);
+            memset(&l_pFreeBufferPage->bufferData[p_byLength], 0, CIRCULAR_BUFFER_FIXED_PAGE_SIZE - p_byLength);
             l_pFreeBufferPage->bFree = false;
         }
 
@@ -85,6 +90,8 @@ boolean CCircularBuffer::push(byte *p_pbyArray) {
             l_pFreeBufferPage->pNext = mCirculartBufferHead;
         }
 
+        m_byCurrentSize++;
+
         return true;
     } else {
         return false;
@@ -135,6 +142,17 @@ boolean CCircularBuffer::isEmpty() {
     return (m_byCurrentSize == 0) ? true : false;
 }
 
+/**
+*   Retreive the count of byte arrays waiting into the circular buffers
+*   params: 
+*       NONE
+*   return:
+*       count of buffers in use       
+*/
+byte CCircularBuffer::getCount() {
+    return m_byCurrentSize;
+}
+
 /****************************************************************************************
  * 
  *     *****    *****      ***     *       *     *****      *******     ******   
@@ -19,20 +19,21 @@
 #ifndef _CCIRCULAR_BUFFER_H_
 #define _CCIRCULAR_BUFFER_H_
 
-#include <arduino.h>
+#include <Arduino.h>
 
 //maximum count of buffers
 #define MAX_CIRCULAR_BUFFER_FIXED_PAGES_COUNT       20
 //size of an unique buffer
-//size of CCC1100::STRUCT_RADIO_PAYLOAD_HEADER + size of CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE
-#define CIRCULAR_BUFFER_FIXED_PAGE_SIZE             6 + (2 + 35)
+//size of CCC1100::STRUCT_RADIO_PAYLOAD_HEADER + size of CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE + RSSI and LQI bytes
+#define CIRCULAR_BUFFER_FIXED_PAGE_SIZE             (7 + (2 + 120) + 2)
 
 class CCircularBuffer {
 public:
     void init();
-    boolean push(byte *p_pbyArray);
+    boolean push(byte *p_pbyArray, byte p_byLength = CIRCULAR_BUFFER_FIXED_PAGE_SIZE);
     int8_t pull(byte *p_pbyArray);
     boolean isEmpty();
+    byte getCount();
 private:
     //circular buffer unit object
     struct buffer_page {
@@ -0,0 +1,163 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#include "CDownlinkQueue.h"
+
+/****************************************************************************************
+ * 
+ *     *****    *     *     *****       *         *****       **** 
+ *     *    *   *     *     *    *      *           *       *     
+ *     * * *    *     *     *  *        *           *      *       
+ *     *        *     *     *    *      *           *       *        
+ *     *         * * *      ******      ******    *****       ****        
+ *    
+ * **************************************************************************************/
+
+/**
+*   Queue a command for a device. A pending command of the same kind is replaced, the new value being 
+*   queued last. The oldest command is dropped when the queue is full
+*   params: 
+*       p_uiDeviceId:       recipient device
+*       p_byCommand:        cf ENM_RADIO_DOWNLINK_COMMAND
+*       p_uiValue:          command value
+*   return:
+*       false if an older command had to be dropped       
+*/
+boolean CDownlinkQueue::push(uint8_t p_uiDeviceId, byte p_byCommand, uint16_t p_uiValue) {
+    boolean l_bRetValue = true;
+    byte l_byIndex;
+
+    vTaskSuspendAll();
+
+    for (l_byIndex = 0; l_byIndex < m_byCount; l_byIndex++) {
+        if ((m_astrctEntries[l_byIndex].uiDeviceId == p_uiDeviceId) && (m_astrctEntries[l_byIndex].strctCommand.uiCommand == p_byCommand)) {
+            remove(l_byIndex);
+            break;
+        }
+    }
+
+    if (m_byCount == RADIO_DOWNLINK_QUEUE_LENGTH) {
+        remove(0);
+        l_bRetValue = false;
+    }
+
+    //sequence 0 means nothing to confirm
+    if (++m_bySequence == 0) {
+        m_bySequence = 1;
+    }
+
+    m_astrctEntries[m_byCount].uiDeviceId = p_uiDeviceId;
+    m_astrctEntries[m_byCount].strctCommand.uiSequence = m_bySequence;
+    m_astrctEntries[m_byCount].strctCommand.uiCommand = p_byCommand;
+    m_astrctEntries[m_byCount].strctCommand.uiValue = p_uiValue;
+    m_byCount++;
+
+    xTaskResumeAll();
+
+    return l_bRetValue;
+}
+
+/**
+*   Retreive the oldest commands pending for a device
+*   params: 
+*       p_uiDeviceId:       device
+*       p_pstrctCommands:   commands, oldest first
+*       p_byMaxCount:       size of p_pstrctCommands
+*   return:
+*       count of commands retreived       
+*/
+byte CDownlinkQueue::getPending(uint8_t p_uiDeviceId, STRUCT_RADIO_DOWNLINK_COMMAND *p_pstrctCommands, byte p_byMaxCount) {
+    byte l_byIndex;
+    byte l_byCount = 0;
+
+    vTaskSuspendAll();
+
+    for (l_byIndex = 0; (l_byIndex < m_byCount) && (l_byCount < p_byMaxCount); l_byIndex++) {
+        if (m_astrctEntries[l_byIndex].uiDeviceId == p_uiDeviceId) {
+            memcpy(&p_pstrctCommands[l_byCount++], &m_astrctEntries[l_byIndex].strctCommand, sizeof(STRUCT_RADIO_DOWNLINK_COMMAND));
+        }
+    }
+
+    xTaskResumeAll();
+
+    return l_byCount;
+}
+
+/**
+*   Release the commands applied by a device: the confirmed one and the older ones of the same device. 
+*   An unknown sequence, e.g. confirmed twice, releases nothing
+*   params: 
+*       p_uiDeviceId:       device
+*       p_bySequence:       sequence of the last command applied
+*   return:
+*       NONE       
+*/
+void CDownlinkQueue::confirm(uint8_t p_uiDeviceId, byte p_bySequence) {
+    int16_t l_iIndex;
+    int16_t l_iConfirmedIndex = -1;
+
+    vTaskSuspendAll();
+
+    for (l_iIndex = 0; l_iIndex < m_byCount; l_iIndex++) {
+        if ((m_astrctEntries[l_iIndex].uiDeviceId == p_uiDeviceId) && (m_astrctEntries[l_iIndex].strctCommand.uiSequence == p_bySequence)) {
+            l_iConfirmedIndex = l_iIndex;
+            break;
+        }
+    }
+
+    for (l_iIndex = l_iConfirmedIndex; l_iIndex >= 0; l_iIndex--) {
+        if (m_astrctEntries[l_iIndex].uiDeviceId == p_uiDeviceId) {
+            remove(l_iIndex);
+        }
+    }
+
+    xTaskResumeAll();
+}
+
+/**
+*   Retreive the count of commands pending, all devices together
+*   params: 
+*       NONE
+*   return:
+*       commands count       
+*/
+byte CDownlinkQueue::getCount() {
+    return m_byCount;
+}
+
+/****************************************************************************************
+ * 
+ *     *****    *****      ***     *       *     *****      *******     ******   
+ *     *    *   *    *      *       *     *     *     *        *        *
+ *     * * *    * * *       *        *   *      * *** *        *        ******
+ *     *        *    *      *         * *       *     *        *        *
+ *     *        *     *    ***         *        *     *        *        ******
+ *   
+ * **************************************************************************************/
+
+/**
+*   Remove an entry, following ones keep their order
+*   params: 
+*       p_byIndex:          entry index
+*   return:
+*       NONE       
+*/
+void CDownlinkQueue::remove(byte p_byIndex) {
+    m_byCount--;
+    memmove(&m_astrctEntries[p_byIndex], &m_astrctEntries[p_byIndex + 1], (m_byCount - p_byIndex) * sizeof(STRUCT_DOWNLINK_ENTRY));
+}
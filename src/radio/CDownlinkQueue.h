@@ -0,0 +1,49 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#ifndef _CDOWNLINK_QUEUE_H_
+#define _CDOWNLINK_QUEUE_H_
+
+#include <Arduino.h>
+#include "Global.h"
+
+/**
+ *  Downlink commands waiting on the bridge for their device, oldest first. Commands are sent within the 
+ *  acknowledges of the device messages, until the device sends back the sequence of the last one applied. 
+ *  Shared by the radio thread and the bridge thread.
+ */
+class CDownlinkQueue {
+public:
+    boolean push(uint8_t p_uiDeviceId, byte p_byCommand, uint16_t p_uiValue);
+    byte getPending(uint8_t p_uiDeviceId, STRUCT_RADIO_DOWNLINK_COMMAND *p_pstrctCommands, byte p_byMaxCount);
+    void confirm(uint8_t p_uiDeviceId, byte p_bySequence);
+    byte getCount();
+private:
+    struct STRUCT_DOWNLINK_ENTRY {
+        uint8_t                         uiDeviceId;
+        STRUCT_RADIO_DOWNLINK_COMMAND   strctCommand;
+    };
+
+    STRUCT_DOWNLINK_ENTRY m_astrctEntries[RADIO_DOWNLINK_QUEUE_LENGTH];
+    byte m_byCount = 0;
+    byte m_bySequence = 0;
+
+    void remove(byte p_byIndex);
+};
+
+#endif
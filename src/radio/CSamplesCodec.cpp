@@ -0,0 +1,299 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#include "CSamplesCodec.h"
+
+/****************************************************************************************
+ * 
+ *     *****    *     *     *****       *         *****       **** 
+ *     *    *   *     *     *    *      *           *       *     
+ *     * * *    *     *     *  *        *           *      *       
+ *     *        *     *     *    *      *           *       *        
+ *     *         * * *      ******      ******    *****       ****        
+ *    
+ * **************************************************************************************/
+
+/**
+*   Start a new frame. Samples have to be added oldest first
+*   params: 
+*       p_pbyBuffer:        frame data
+*       p_byBufferLength:   frame data maximum length
+*   return:
+*       NONE       
+*/
+void CSamplesCodec::startEncoding(byte *p_pbyBuffer, byte p_byBufferLength) {
+    m_pbyBuffer = p_pbyBuffer;
+    m_byBufferLength = p_byBufferLength;
+    m_bySamplesCount = 0;
+    m_byOffset = 1;
+    m_pbyBuffer[0] = 0;
+}
+
+/**
+*   Append a sample to the frame 
+*   params: 
+*       p_pstrctSample:     sample to add
+*   return:
+*       true if the sample has been added, false if the frame is full       
+*/
+boolean CSamplesCodec::addSample(STRUCT_RADIO_AGGREGATED_SAMPLE *p_pstrctSample) {
+    byte l_abyCodedSample[SAMPLES_CODEC_MAX_SAMPLE_LENGTH];
+    byte l_byCodedLength = 0;
+    uint16_t l_auiValues[SAMPLES_CODEC_VALUES_COUNT];
+    int32_t l_lInterval;
+    byte l_byValueIndex;
+
+    getValues(p_pstrctSample, l_auiValues);
+
+    if (m_bySamplesCount == 0) {
+        //keyframe
+        memcpy(l_abyCodedSample, p_pstrctSample->abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+        l_byCodedLength = RADIO_SENSOR_VALUES_LENGTH;
+        l_byCodedLength += writeVarint(&l_abyCodedSample[l_byCodedLength], p_pstrctSample->uiTimeOffset);
+        l_lInterval = 0;
+    } else {
+        for (l_byValueIndex = 0; l_byValueIndex < SAMPLES_CODEC_VALUES_COUNT; l_byValueIndex++) {
+            l_byCodedLength += writeVarint(&l_abyCodedSample[l_byCodedLength], 
+                                    zigZagEncode((int16_t)(l_auiValues[l_byValueIndex] - m_auiPreviousValues[l_byValueIndex])));
+        }
+
+        //samples come oldest first: time offsets decrease
+        l_lInterval = (int32_t)m_uiPreviousTimeOffset - p_pstrctSample->uiTimeOffset;
+        l_byCodedLength += writeVarint(&l_abyCodedSample[l_byCodedLength], zigZagEncode(l_lInterval - m_lPreviousInterval));
+    }
+
+    if ((m_byOffset + l_byCodedLength > m_byBufferLength) || (m_bySamplesCount == 255)) {
+        return false;
+    }
+
+    memcpy(&m_pbyBuffer[m_byOffset], l_abyCodedSample, l_byCodedLength);
+    m_byOffset += l_byCodedLength;
+    m_pbyBuffer[0] = ++m_bySamplesCount;
+
+    memcpy(m_auiPreviousValues, l_auiValues, sizeof(m_auiPreviousValues));
+    m_uiPreviousTimeOffset = p_pstrctSample->uiTimeOffset;
+    m_lPreviousInterval = l_lInterval;
+
+    return true;
+}
+
+/**
+*   Retreive the length of the frame data
+*   params: 
+*       NONE
+*   return:
+*       coded length in bytes, including samples count       
+*/
+byte CSamplesCodec::getEncodedLength() {
+    return m_byOffset;
+}
+
+/**
+*   Retreive the number of samples added to, or read from, the frame
+*   params: 
+*       NONE
+*   return:
+*       samples count       
+*/
+byte CSamplesCodec::getSamplesCount() {
+    return m_bySamplesCount;
+}
+
+/**
+*   Start reading a received frame
+*   params: 
+*       p_pbyBuffer:        frame data
+*       p_byLength:         frame data length
+*   return:
+*       false if the frame is empty       
+*/
+boolean CSamplesCodec::startDecoding(byte *p_pbyBuffer, byte p_byLength) {
+    m_pbyBuffer = p_pbyBuffer;
+    m_byBufferLength = p_byLength;
+    m_byOffset = 1;
+    m_bySamplesIndex = 0;
+    m_bySamplesCount = (p_byLength != 0) ? p_pbyBuffer[0] : 0;
+
+    return (m_bySamplesCount != 0);
+}
+
+/**
+*   Read the next sample of a received frame
+*   params: 
+*       p_pstrctSample:     decoded sample
+*   return:
+*       false if all samples have been read, or if the frame is truncated       
+*/
+boolean CSamplesCodec::getNextSample(STRUCT_RADIO_AGGREGATED_SAMPLE *p_pstrctSample) {
+    uint16_t l_auiValues[SAMPLES_CODEC_VALUES_COUNT];
+    uint32_t l_ulValue;
+    int32_t l_lInterval;
+    byte l_byValueIndex;
+
+    if (m_bySamplesIndex >= m_bySamplesCount) {
+        return false;
+    }
+
+    if (m_bySamplesIndex == 0) {
+        //keyframe
+        if (m_byOffset + RADIO_SENSOR_VALUES_LENGTH > m_byBufferLength) {
+            return false;
+        }
+
+        memcpy(p_pstrctSample->abySensorValues, &m_pbyBuffer[m_byOffset], RADIO_SENSOR_VALUES_LENGTH);
+        m_byOffset += RADIO_SENSOR_VALUES_LENGTH;
+
+        if (!readVarint(&l_ulValue)) {
+            return false;
+        }
+        p_pstrctSample->uiTimeOffset = l_ulValue;
+        l_lInterval = 0;
+        getValues(p_pstrctSample, l_auiValues);
+    } else {
+        for (l_byValueIndex = 0; l_byValueIndex < SAMPLES_CODEC_VALUES_COUNT; l_byValueIndex++) {
+            if (!readVarint(&l_ulValue)) {
+                return false;
+            }
+            l_auiValues[l_byValueIndex] = m_auiPreviousValues[l_byValueIndex] + (int16_t)zigZagDecode(l_ulValue);
+        }
+
+        if (!readVarint(&l_ulValue)) {
+            return false;
+        }
+        l_lInterval = m_lPreviousInterval + zigZagDecode(l_ulValue);
+        p_pstrctSample->uiTimeOffset = m_uiPreviousTimeOffset - l_lInterval;
+        setValues(p_pstrctSample, l_auiValues);
+    }
+
+    memcpy(m_auiPreviousValues, l_auiValues, sizeof(m_auiPreviousValues));
+    m_uiPreviousTimeOffset = p_pstrctSample->uiTimeOffset;
+    m_lPreviousInterval = l_lInterval;
+    m_bySamplesIndex++;
+
+    return true;
+}
+
+/****************************************************************************************
+ * 
+ *     *****    *****      ***     *       *     *****      *******     ******   
+ *     *    *   *    *      *       *     *     *     *        *        *
+ *     * * *    * * *       *        *   *      * *** *        *        ******
+ *     *        *    *      *         * *       *     *        *        *
+ *     *        *     *    ***         *        *     *        *        ******
+ *   
+ * **************************************************************************************/
+
+/**
+*   Convert raw sensor values into 16 bits words. A value crossing a unit boundary costs one more byte, 
+*   but any quotient/remainder pair is coded without loss
+*   params: 
+*       p_pstrctSample:     sample
+*       p_puiValues:        SAMPLES_CODEC_VALUES_COUNT words
+*   return:
+*       NONE       
+*/
+void CSamplesCodec::getValues(STRUCT_RADIO_AGGREGATED_SAMPLE *p_pstrctSample, uint16_t *p_puiValues) {
+    byte l_byValueIndex;
+
+    for (l_byValueIndex = 0; l_byValueIndex < SAMPLES_CODEC_VALUES_COUNT; l_byValueIndex++) {
+        p_puiValues[l_byValueIndex] = (p_pstrctSample->abySensorValues[l_byValueIndex * 2] << 8) | p_pstrctSample->abySensorValues[l_byValueIndex * 2 + 1];
+    }
+}
+
+/**
+*   Convert 16 bits words back to raw sensor values
+*   params: 
+*       p_pstrctSample:     sample
+*       p_puiValues:        SAMPLES_CODEC_VALUES_COUNT words
+*   return:
+*       NONE       
+*/
+void CSamplesCodec::setValues(STRUCT_RADIO_AGGREGATED_SAMPLE *p_pstrctSample, uint16_t *p_puiValues) {
+    byte l_byValueIndex;
+
+    for (l_byValueIndex = 0; l_byValueIndex < SAMPLES_CODEC_VALUES_COUNT; l_byValueIndex++) {
+        p_pstrctSample->abySensorValues[l_byValueIndex * 2] = p_puiValues[l_byValueIndex] >> 8;
+        p_pstrctSample->abySensorValues[l_byValueIndex * 2 + 1] = p_puiValues[l_byValueIndex] & 0xFF;
+    }
+}
+
+/**
+*   Write a varint: 7 bits per byte, least significant first, MSB set if more bytes follow
+*   params: 
+*       p_pbyBuffer:        destination
+*       p_ulValue:          value
+*   return:
+*       bytes count written       
+*/
+byte CSamplesCodec::writeVarint(byte *p_pbyBuffer, uint32_t p_ulValue) {
+    byte l_byLength = 0;
+
+    while (p_ulValue >= 0x80) {
+        p_pbyBuffer[l_byLength++] = (p_ulValue & 0x7F) | 0x80;
+        p_ulValue >>= 7;
+    }
+    p_pbyBuffer[l_byLength++] = p_ulValue;
+
+    return l_byLength;
+}
+
+/**
+*   Read a varint at the current decoding offset
+*   params: 
+*       p_pulValue:         value read
+*   return:
+*       false if the frame is truncated       
+*/
+boolean CSamplesCodec::readVarint(uint32_t *p_pulValue) {
+    byte l_byShift = 0;
+
+    *p_pulValue = 0;
+
+    do {
+        if ((m_byOffset >= m_byBufferLength) || (l_byShift > 28)) {
+            return false;
+        }
+
+        *p_pulValue |= (uint32_t)(m_pbyBuffer[m_byOffset] & 0x7F) << l_byShift;
+        l_byShift += 7;
+    } while (m_pbyBuffer[m_byOffset++] & 0x80);
+
+    return true;
+}
+
+/**
+*   Zig-zag mapping: small negative and positive values give small unsigned values
+*   params: 
+*       p_lValue:           signed value
+*   return:
+*       unsigned value       
+*/
+uint32_t CSamplesCodec::zigZagEncode(int32_t p_lValue) {
+    return ((uint32_t)p_lValue << 1) ^ (uint32_t)(p_lValue >> 31);
+}
+
+/**
+*   Reverse zig-zag mapping
+*   params: 
+*       p_ulValue:          unsigned value
+*   return:
+*       signed value       
+*/
+int32_t CSamplesCodec::zigZagDecode(uint32_t p_ulValue) {
+    return (int32_t)(p_ulValue >> 1) ^ -(int32_t)(p_ulValue & 1);
+}
@@ -0,0 +1,67 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+#ifndef _CSAMPLES_CODEC_H_
+#define _CSAMPLES_CODEC_H_
+
+#include <Arduino.h>
+#include "Global.h"
+
+//sample values are coded as 16 bits words: quotient in MSB, remainder in LSB
+#define SAMPLES_CODEC_VALUES_COUNT          (RADIO_SENSOR_VALUES_LENGTH / 2)
+//worst case size of a coded sample: 3 bytes varint for each value and for the time offset
+#define SAMPLES_CODEC_MAX_SAMPLE_LENGTH     ((SAMPLES_CODEC_VALUES_COUNT + 1) * 3)
+
+/**
+ *  Delta coding of aggregated readings, cf ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES_AGGREGATED
+ *      [0]:    samples count
+ *      first sample (keyframe):    raw sensor values, then time offset as varint
+ *      next samples:               zig-zag varint delta of each value, then zig-zag varint of the 
+ *                                  sampling interval change (0 with a steady measurement timeout)
+ *  Every frame starts with a keyframe, so a lost frame does not affect the following ones.
+ */
+class CSamplesCodec {
+public:
+    void startEncoding(byte *p_pbyBuffer, byte p_byBufferLength);
+    boolean addSample(STRUCT_RADIO_AGGREGATED_SAMPLE *p_pstrctSample);
+    byte getEncodedLength();
+    byte getSamplesCount();
+
+    boolean startDecoding(byte *p_pbyBuffer, byte p_byLength);
+    boolean getNextSample(STRUCT_RADIO_AGGREGATED_SAMPLE *p_pstrctSample);
+private:
+    byte *m_pbyBuffer;
+    byte m_byBufferLength;
+    byte m_byOffset;
+    byte m_bySamplesCount;
+    byte m_bySamplesIndex;
+
+    //previous sample, reference of the deltas
+    uint16_t m_auiPreviousValues[SAMPLES_CODEC_VALUES_COUNT];
+    uint16_t m_uiPreviousTimeOffset;
+    int32_t m_lPreviousInterval;
+
+    void getValues(STRUCT_RADIO_AGGREGATED_SAMPLE *p_pstrctSample, uint16_t *p_puiValues);
+    void setValues(STRUCT_RADIO_AGGREGATED_SAMPLE *p_pstrctSample, uint16_t *p_puiValues);
+    byte writeVarint(byte *p_pbyBuffer, uint32_t p_ulValue);
+    boolean readVarint(uint32_t *p_pulValue);
+    uint32_t zigZagEncode(int32_t p_lValue);
+    int32_t zigZagDecode(uint32_t p_ulValue);
+};
+
+#endif
@@ -0,0 +1,43 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host stand-in of the Adafruit TinyUSB library, for the native test environment. 
+ *  Logging is silent in the tested units: nothing is ever printed
+ */
+#ifndef _STUB_ADAFRUIT_TINYUSB_H_
+#define _STUB_ADAFRUIT_TINYUSB_H_
+
+#include <Arduino.h>
+
+class Adafruit_USBD_CDC : public Stream {
+public:
+    operator bool() { 
+        return false; 
+    }
+};
+
+class Adafruit_USBD_WebUSB : public Stream {
+public:
+    operator bool() { 
+        return false; 
+    }
+};
+
+#endif
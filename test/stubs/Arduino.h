@@ -0,0 +1,133 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host stand-in of the Arduino core, for the native test environment. 
+ *  Only what the tested units use is provided. Reading the clock moves it forward, 
+ *  so the hardware polling loops reach their timeouts instead of blocking
+ */
+#ifndef _STUB_ARDUINO_H_
+#define _STUB_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define PROGMEM
+
+#define HIGH                    1
+#define LOW                     0
+#define INPUT                   0x0
+#define OUTPUT                  0x1
+#define INPUT_PULLUP            0x2
+#define INPUT_PULLDOWN          0x3
+
+#define MSBFIRST                1
+#define SPI_MODE0               0x02
+
+#define PIN_SPI_MISO            9
+
+#ifndef min
+#define min(a,b)                ((a)<(b)?(a):(b))
+#define max(a,b)                ((a)>(b)?(a):(b))
+#endif
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+//host clock, in microseconds
+inline uint32_t g_ulStubMicros = 0;
+//pins are read as alternate levels: edges waited for arrive at once
+inline uint32_t g_ulStubPinReads = 0;
+
+inline unsigned long micros() { 
+    return g_ulStubMicros += 10; 
+}
+
+inline unsigned long millis() { 
+    return (g_ulStubMicros += 10) / 1000; 
+}
+
+inline void delay(unsigned long p_ulMs) { 
+    g_ulStubMicros += p_ulMs * 1000; 
+}
+
+inline void delayMicroseconds(unsigned int p_uiUs) { 
+    g_ulStubMicros += p_uiUs; 
+}
+
+inline void pinMode(uint32_t p_ulPin, uint32_t p_ulMode) {}
+inline void digitalWrite(uint32_t p_ulPin, uint32_t p_ulValue) {}
+
+inline int digitalRead(uint32_t p_ulPin) { 
+    return (g_ulStubPinReads++) & 0x01; 
+}
+
+//PORT registers, written by drivers bypassing digitalWrite()
+struct PortGroup { 
+    struct { uint32_t reg; } OUTSET, OUTCLR, IN, OUT, DIRSET, DIRCLR; 
+};
+
+struct Port { 
+    PortGroup Group[2]; 
+};
+
+struct PinDescription { 
+    uint32_t ulPort; 
+    uint32_t ulPin; 
+    uint32_t ulPinType; 
+};
+
+//text output goes nowhere
+class Print {
+public:
+    template<typename T> size_t print(T p_value, int p_iFormat = 0) { 
+        return 0; 
+    }
+
+    template<typename T> size_t println(T p_value, int p_iFormat = 0) { 
+        return 0; 
+    }
+
+    size_t println() { 
+        return 0; 
+    }
+};
+
+class Stream : public Print {
+public:
+    int available() { 
+        return 0; 
+    }
+
+    int read() { 
+        return -1; 
+    }
+};
+
+inline Port g_stubPort;
+#define PORT                    (&g_stubPort)
+inline const PinDescription g_APinDescription[16] = {};
+
+#endif
@@ -0,0 +1,87 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host stand-in of the FlashStorage library, for the native test environment: a simulated SAMD21 NVM 
+ *  on top of a RAM area. A write can only clear bits, word by word; an erase sets a whole row to 0xFF. 
+ *  Misaligned accesses and writes setting bits are counted as faults. A power loss is simulated by 
+ *  a budget of flash words: once spent, writes and erases are dropped
+ */
+#ifndef _STUB_FLASH_STORAGE_H_
+#define _STUB_FLASH_STORAGE_H_
+
+#include <Arduino.h>
+
+#define STUB_FLASH_ROW_SIZE             256
+#define STUB_FLASH_WORD_SIZE            4
+#define STUB_FLASH_UNLIMITED            -1
+
+inline uint32_t g_ulStubFlashFaults = 0;
+inline uint32_t g_ulStubFlashErases = 0;
+inline const volatile void *g_pvStubFlashLastErase = NULL;
+inline int32_t g_lStubFlashWordsBudget = STUB_FLASH_UNLIMITED;      //words written before the power loss
+
+class FlashClass {
+public:
+    FlashClass(const void *p_pvFlashAddr = NULL, uint32_t p_ulSize = 0) {}
+
+    void write(const volatile void *p_pvFlashPtr, const void *p_pvData, uint32_t p_ulSize) {
+        volatile uint8_t *l_puiFlash = (volatile uint8_t *)p_pvFlashPtr;
+        const uint8_t *l_puiData = (const uint8_t *)p_pvData;
+
+        if ((((uintptr_t)p_pvFlashPtr % STUB_FLASH_WORD_SIZE) != 0) || ((p_ulSize % STUB_FLASH_WORD_SIZE) != 0)) {
+            g_ulStubFlashFaults++;
+        }
+
+        for (uint32_t l_ulIndex = 0; l_ulIndex < p_ulSize; l_ulIndex++) {
+            if ((l_ulIndex % STUB_FLASH_WORD_SIZE) == 0) {
+                if (g_lStubFlashWordsBudget == 0) {
+                    return;
+                } else if (g_lStubFlashWordsBudget > 0) {
+                    g_lStubFlashWordsBudget--;
+                }
+            }
+
+            if (~l_puiFlash[l_ulIndex] & l_puiData[l_ulIndex]) {
+                g_ulStubFlashFaults++;
+            }
+            l_puiFlash[l_ulIndex] &= l_puiData[l_ulIndex];
+        }
+    }
+
+    void erase(const volatile void *p_pvFlashPtr, uint32_t p_ulSize) {
+        if ((((uintptr_t)p_pvFlashPtr % STUB_FLASH_ROW_SIZE) != 0) || ((p_ulSize % STUB_FLASH_ROW_SIZE) != 0)) {
+            g_ulStubFlashFaults++;
+        }
+
+        if (g_lStubFlashWordsBudget == 0) {
+            return;
+        }
+
+        memset((void *)p_pvFlashPtr, 0xFF, p_ulSize);
+        g_ulStubFlashErases++;
+        g_pvStubFlashLastErase = p_pvFlashPtr;
+    }
+
+    void read(const volatile void *p_pvFlashPtr, void *p_pvData, uint32_t p_ulSize) {
+        memcpy(p_pvData, (const void *)p_pvFlashPtr, p_ulSize);
+    }
+};
+
+#endif
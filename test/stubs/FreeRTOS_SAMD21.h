@@ -0,0 +1,75 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host stand-in of FreeRTOS_SAMD21, for the native test environment. 
+ *  Tests run single-threaded: the scheduler calls do nothing and the tick count is set by the tests
+ */
+#ifndef _STUB_FREERTOS_SAMD21_H_
+#define _STUB_FREERTOS_SAMD21_H_
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef void *SemaphoreHandle_t;
+typedef void *QueueHandle_t;
+typedef void *TaskHandle_t;
+
+#define pdFALSE                 ((BaseType_t)0)
+#define pdTRUE                  ((BaseType_t)1)
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+
+#define configTICK_RATE_HZ      ((TickType_t)1000)
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000))
+
+inline TickType_t g_xStubTickCount = 0;
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t p_xSemaphore, TickType_t p_xBlockTime) { 
+    return pdTRUE; 
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t p_xSemaphore) { 
+    return pdTRUE; 
+}
+
+inline TickType_t xTaskGetTickCount() { 
+    return g_xStubTickCount; 
+}
+
+inline void vTaskDelay(const TickType_t p_xTicksToDelay) { 
+    g_xStubTickCount += p_xTicksToDelay; 
+}
+
+inline void vTaskSuspendAll() {}
+
+inline BaseType_t xTaskResumeAll() { 
+    return pdFALSE; 
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t p_xClearCountOnExit, TickType_t p_xTicksToWait) { 
+    g_xStubTickCount += p_xTicksToWait; 
+    return 0; 
+}
+
+#endif
@@ -0,0 +1,89 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host stand-in of the SPI library, for the native test environment. 
+ *  It models the few CC1101 behaviours the driver waits for: command strobes move 
+ *  the state read back from MARCSTATE, and every other read returns 0 (empty FIFOs)
+ */
+#ifndef _STUB_SPI_H_
+#define _STUB_SPI_H_
+
+#include <Arduino.h>
+
+#define STUB_CC1101_SRX             0x34
+#define STUB_CC1101_STX             0x35
+#define STUB_CC1101_SIDLE           0x36
+#define STUB_CC1101_MARCSTATE       0xF5
+#define STUB_CC1101_TXFIFO_BURST    0x7F
+#define STUB_CC1101_STATE_IDLE      0x01
+#define STUB_CC1101_STATE_RX        0x0D
+
+class SPISettings {
+public:
+    SPISettings() {}
+    SPISettings(uint32_t p_ulClock, uint8_t p_uiBitOrder, uint8_t p_uiDataMode) {}
+};
+
+class SPIClass {
+public:
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings p_settings) {}
+    void endTransaction() {}
+
+    uint8_t transfer(uint8_t p_uiData) { 
+        return 0; 
+    }
+
+    void transfer(void *p_pvBuffer, size_t p_sztCount) {
+        uint8_t *l_puiBuffer = (uint8_t *)p_pvBuffer;
+
+        switch (l_puiBuffer[0]) {
+            case STUB_CC1101_SIDLE:
+                m_uiMarcState = STUB_CC1101_STATE_IDLE;
+                break;
+
+            //end of the packet: back to receive mode
+            case STUB_CC1101_SRX:
+            case STUB_CC1101_STX:
+                m_uiMarcState = STUB_CC1101_STATE_RX;
+                break;
+
+            case STUB_CC1101_TXFIFO_BURST:
+                m_ulTXFIFOBursts++;
+                break;
+
+            case STUB_CC1101_MARCSTATE:
+                l_puiBuffer[1] = m_uiMarcState;
+                break;
+
+            default:
+                memset(&l_puiBuffer[1], 0, p_sztCount - 1);
+                break;
+        }
+    }
+
+    uint8_t m_uiMarcState = STUB_CC1101_STATE_IDLE;
+    uint32_t m_ulTXFIFOBursts = 0;      //frames written into the TX FIFO, i.e. acknowledges sent
+};
+
+inline SPIClass SPI;
+
+#endif
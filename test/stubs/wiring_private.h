@@ -0,0 +1,69 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host stand-in of the SAMD core private wiring header, for the native test environment. 
+ *  The Wire SERCOM is a plain register block: nothing answers, transactions time out
+ */
+#ifndef _STUB_WIRING_PRIVATE_H_
+#define _STUB_WIRING_PRIVATE_H_
+
+#include <Arduino.h>
+
+#define SERCOM_I2CM_INTFLAG_MB          (1 << 0)
+#define SERCOM_I2CM_INTFLAG_SB          (1 << 1)
+#define SERCOM_I2CM_INTFLAG_ERROR       (1 << 7)
+#define SERCOM_I2CM_INTENSET_MB         SERCOM_I2CM_INTFLAG_MB
+#define SERCOM_I2CM_INTENSET_SB         SERCOM_I2CM_INTFLAG_SB
+#define SERCOM_I2CM_INTENSET_ERROR      SERCOM_I2CM_INTFLAG_ERROR
+#define SERCOM_I2CM_INTENCLR_MB         SERCOM_I2CM_INTFLAG_MB
+#define SERCOM_I2CM_INTENCLR_SB         SERCOM_I2CM_INTFLAG_SB
+#define SERCOM_I2CM_INTENCLR_ERROR      SERCOM_I2CM_INTFLAG_ERROR
+
+#define PIN_WIRE_SDA                    4
+#define PIN_WIRE_SCL                    5
+
+struct SercomI2cm {
+    union { struct { uint32_t :16; uint32_t CMD:2; uint32_t ACKACT:1; } bit; uint32_t reg; } CTRLB;
+    union { struct { uint16_t BUSERR:1; uint16_t ARBLOST:1; uint16_t RXNACK:1; uint16_t :1; uint16_t BUSSTATE:2; } bit; uint16_t reg; } STATUS;
+    union { struct { uint32_t SWRST:1; uint32_t ENABLE:1; uint32_t SYSOP:1; } bit; uint32_t reg; } SYNCBUSY;
+    union { struct { uint32_t ADDR:11; } bit; uint32_t reg; } ADDR;
+    struct { uint8_t reg; } DATA, INTFLAG, INTENSET, INTENCLR;
+};
+
+struct Sercom {
+    SercomI2cm I2CM;
+};
+
+class SERCOM {
+public:
+    void initMasterWIRE(uint32_t p_ulBaudrate) {}
+    void enableWIRE() {}
+};
+
+inline Sercom g_stubSercom2;
+#define SERCOM2                         (&g_stubSercom2)
+inline SERCOM sercom2;
+#define PERIPH_WIRE                     sercom2
+
+inline int pinPeripheral(uint32_t p_ulPin, uint32_t p_ulPeripheral) { 
+    return 0; 
+}
+
+#endif
@@ -0,0 +1,116 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host tests of CCRC8, against the bitwise polynomial division CHTU21::checkCRC performed 
+ *  before the table-driven implementation
+ */
+#include <unity.h>
+#include "CCRC8.h"
+#include "CHTU21.h"
+
+/**
+ *  Access to the private CRC check, cf friend declaration of CHTU21
+ */
+class CHTU21Test {
+public:
+    static boolean checkCRC(CHTU21 *p_pSensor, uint16_t p_uiMeasureValue, uint8_t p_uiCRCValue) {
+        return p_pSensor->checkCRC(p_uiMeasureValue, p_uiCRCValue);
+    }
+};
+
+static CHTU21 g_sensor;
+
+/**
+ *  Former CHTU21::checkCRC division, returning the CRC
+ */
+static uint8_t computeBitwiseCRC(uint16_t p_uiMeasureValue) {
+    uint32_t l_ulPolynom = 0x988000;        //x^8 + x^5 + x^4 + 1
+    uint32_t l_ulMsb = 0x800000;
+    uint32_t l_ulMask = 0xFF8000;
+    uint32_t l_ulResult = (uint32_t)p_uiMeasureValue << 8;
+
+    while (l_ulMsb != 0x80) {
+        if (l_ulResult & l_ulMsb) {
+            l_ulResult = ((l_ulResult ^ l_ulPolynom) & l_ulMask) | (l_ulResult & ~l_ulMask);
+        }
+
+        l_ulMsb >>= 1;
+        l_ulMask >>= 1;
+        l_ulPolynom >>= 1;
+    }
+
+    return (uint8_t)l_ulResult;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_all_measures() {
+    byte l_abyDataArray[2];
+    uint8_t l_uiCRC;
+
+    for (uint32_t l_ulValue = 0; l_ulValue <= 0xFFFF; l_ulValue++) {
+        l_abyDataArray[0] = l_ulValue >> 8;
+        l_abyDataArray[1] = l_ulValue & 0xFF;
+        l_uiCRC = computeBitwiseCRC(l_ulValue);
+
+        TEST_ASSERT_EQUAL_HEX8(l_uiCRC, CCRC8::compute(l_abyDataArray, 2));
+        TEST_ASSERT_TRUE(CHTU21Test::checkCRC(&g_sensor, l_ulValue, l_uiCRC));
+        TEST_ASSERT_FALSE(CHTU21Test::checkCRC(&g_sensor, l_ulValue, l_uiCRC ^ 0x01));
+    }
+}
+
+void test_datasheet_examples() {
+    byte l_abyTemperature[] = {0x68, 0x3A};
+    byte l_abyHumidity[] = {0x4E, 0x85};
+    byte l_abySingle[] = {0xDC};
+
+    TEST_ASSERT_EQUAL_HEX8(0x7C, CCRC8::compute(l_abyTemperature, 2));
+    TEST_ASSERT_EQUAL_HEX8(0x6B, CCRC8::compute(l_abyHumidity, 2));
+    TEST_ASSERT_EQUAL_HEX8(0x79, CCRC8::compute(l_abySingle, 1));
+}
+
+void test_update_chaining() {
+    byte l_abyDataArray[64];
+    uint8_t l_uiCRC;
+
+    for (byte l_byIndex = 0; l_byIndex < sizeof(l_abyDataArray); l_byIndex++) {
+        l_abyDataArray[l_byIndex] = l_byIndex * 37 + 11;
+    }
+
+    //split anywhere, same CRC
+    for (byte l_bySplit = 0; l_bySplit <= sizeof(l_abyDataArray); l_bySplit++) {
+        l_uiCRC = CCRC8::update(CRC8_INIT, l_abyDataArray, l_bySplit);
+        l_uiCRC = CCRC8::update(l_uiCRC, &l_abyDataArray[l_bySplit], sizeof(l_abyDataArray) - l_bySplit);
+
+        TEST_ASSERT_EQUAL_HEX8(CCRC8::compute(l_abyDataArray, sizeof(l_abyDataArray)), l_uiCRC);
+    }
+
+    TEST_ASSERT_EQUAL_HEX8(CRC8_INIT, CCRC8::compute(l_abyDataArray, 0));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_all_measures);
+    RUN_TEST(test_datasheet_examples);
+    RUN_TEST(test_update_chaining);
+    return UNITY_END();
+}
@@ -0,0 +1,114 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host tests of CDeviceCache: latest reading of each device, older readings ignored, reading age and tick wrap
+ */
+#include <unity.h>
+#include "bridge/CDeviceCache.h"
+
+#define TEST_DEVICE_ID              3
+#define TEST_START_TICK             5000
+
+static CDeviceCache g_cache;
+static byte g_abyFirstValues[RADIO_SENSOR_VALUES_LENGTH] = {21, 5, 40, 0, 1, 2, 3, 4};
+static byte g_abySecondValues[RADIO_SENSOR_VALUES_LENGTH] = {22, 0, 41, 0, 5, 6, 7, 8};
+
+void setUp() {
+    g_cache = CDeviceCache();
+    g_xStubTickCount = TEST_START_TICK;
+}
+
+void tearDown() {}
+
+void test_empty() {
+    CDeviceCache::STRUCT_DEVICE_CACHE_ENTRY l_strctEntry;
+
+    TEST_ASSERT_FALSE(g_cache.get(TEST_DEVICE_ID, &l_strctEntry));
+    TEST_ASSERT_FALSE(g_cache.get(MAX_RADIO_DEVICES, &l_strctEntry));
+
+    //out of range address ignored
+    g_cache.update(MAX_RADIO_DEVICES, g_abyFirstValues, 0, -70, 12);
+    TEST_ASSERT_FALSE(g_cache.get(MAX_RADIO_DEVICES, &l_strctEntry));
+}
+
+void test_update() {
+    CDeviceCache::STRUCT_DEVICE_CACHE_ENTRY l_strctEntry;
+
+    g_cache.update(TEST_DEVICE_ID, g_abyFirstValues, 0, -70, 12);
+    TEST_ASSERT_TRUE(g_cache.get(TEST_DEVICE_ID, &l_strctEntry));
+    TEST_ASSERT_EQUAL_MEMORY(g_abyFirstValues, l_strctEntry.abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+    TEST_ASSERT_EQUAL_INT8(-70, l_strctEntry.iRSSI);
+    TEST_ASSERT_EQUAL_UINT8(12, l_strctEntry.uiLQI);
+    TEST_ASSERT_EQUAL_UINT32(0, g_cache.getReadingAge(&l_strctEntry));
+    TEST_ASSERT_FALSE(g_cache.get(TEST_DEVICE_ID + 1, &l_strctEntry));
+
+    //RSSI kept within 8 bits
+    g_cache.update(TEST_DEVICE_ID, g_abyFirstValues, 0, -300, 0);
+    g_cache.get(TEST_DEVICE_ID, &l_strctEntry);
+    TEST_ASSERT_EQUAL_INT8(-128, l_strctEntry.iRSSI);
+}
+
+void test_older_reading_ignored() {
+    CDeviceCache::STRUCT_DEVICE_CACHE_ENTRY l_strctEntry;
+
+    g_cache.update(TEST_DEVICE_ID, g_abyFirstValues, 0, -70, 12);
+
+    //e.g. an aggregated frame reading measured before the cached one
+    g_cache.update(TEST_DEVICE_ID, g_abySecondValues, 60, -50, 3);
+    g_cache.get(TEST_DEVICE_ID, &l_strctEntry);
+    TEST_ASSERT_EQUAL_MEMORY(g_abyFirstValues, l_strctEntry.abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+    TEST_ASSERT_EQUAL_UINT8(12, l_strctEntry.uiLQI);
+
+    g_xStubTickCount += 10 * configTICK_RATE_HZ;
+    TEST_ASSERT_EQUAL_UINT32(10, g_cache.getReadingAge(&l_strctEntry));
+
+    //newer one, even if sampled before being sent
+    g_cache.update(TEST_DEVICE_ID, g_abySecondValues, 2, -50, 3);
+    g_cache.get(TEST_DEVICE_ID, &l_strctEntry);
+    TEST_ASSERT_EQUAL_MEMORY(g_abySecondValues, l_strctEntry.abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+    TEST_ASSERT_EQUAL_UINT32(2, g_cache.getReadingAge(&l_strctEntry));
+}
+
+void test_tick_wrap() {
+    CDeviceCache::STRUCT_DEVICE_CACHE_ENTRY l_strctEntry;
+
+    //sample age going past the tick origin
+    g_cache.update(TEST_DEVICE_ID, g_abyFirstValues, 65535, -70, 12);
+    g_cache.get(TEST_DEVICE_ID, &l_strctEntry);
+    TEST_ASSERT_EQUAL_UINT32(65535, g_cache.getReadingAge(&l_strctEntry));
+
+    //tick count wrapping between two readings
+    g_xStubTickCount = (TickType_t)-1000;
+    g_cache.update(TEST_DEVICE_ID + 1, g_abyFirstValues, 0, -70, 12);
+    g_xStubTickCount += 3 * configTICK_RATE_HZ;
+    g_cache.update(TEST_DEVICE_ID + 1, g_abySecondValues, 1, -70, 12);
+    g_cache.get(TEST_DEVICE_ID + 1, &l_strctEntry);
+    TEST_ASSERT_EQUAL_MEMORY(g_abySecondValues, l_strctEntry.abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+    TEST_ASSERT_EQUAL_UINT32(1, g_cache.getReadingAge(&l_strctEntry));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty);
+    RUN_TEST(test_update);
+    RUN_TEST(test_older_reading_ignored);
+    RUN_TEST(test_tick_wrap);
+    return UNITY_END();
+}
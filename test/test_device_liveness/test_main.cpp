@@ -0,0 +1,168 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host tests of CDeviceLiveness: alive bitmap of a keep-alive period, devices lost after missed periods, 
+ *  loss reports and devices heard again
+ */
+#include <unity.h>
+#include "bridge/CDeviceLiveness.h"
+
+#define TEST_DEVICE_ID              5
+#define TEST_OTHER_DEVICE_ID        (MAX_RADIO_DEVICES - 1)
+
+/**
+ *  Access to the private table, cf friend declaration of CDeviceLiveness
+ */
+class CDeviceLivenessTest {
+public:
+    static CDeviceLiveness::STRUCT_DEVICE_LIVENESS *getDevice(CDeviceLiveness *p_pLiveness, uint8_t p_uiDeviceId) {
+        return &p_pLiveness->m_astrctDevices[p_uiDeviceId];
+    }
+};
+
+static CDeviceLiveness g_liveness;
+
+void setUp() {
+    g_liveness = CDeviceLiveness();
+    g_xStubTickCount = 0;
+}
+
+void tearDown() {}
+
+void test_update() {
+    CDeviceLiveness::STRUCT_DEVICE_LIVENESS *l_pstrctDevice = CDeviceLivenessTest::getDevice(&g_liveness, TEST_DEVICE_ID);
+
+    g_xStubTickCount = 1234;
+    g_liveness.update(TEST_DEVICE_ID, -70);
+    TEST_ASSERT_EQUAL_UINT32(1234, l_pstrctDevice->xLastSeenTick);
+    TEST_ASSERT_EQUAL_INT8(-70, l_pstrctDevice->iLastRSSI);
+    TEST_ASSERT_EQUAL_UINT16(1, l_pstrctDevice->uiMessagesCount);
+
+    //RSSI kept within 8 bits
+    g_liveness.update(TEST_DEVICE_ID, -300);
+    TEST_ASSERT_EQUAL_INT8(-128, l_pstrctDevice->iLastRSSI);
+    g_liveness.update(TEST_DEVICE_ID, 300);
+    TEST_ASSERT_EQUAL_INT8(127, l_pstrctDevice->iLastRSSI);
+
+    //messages count saturates
+    l_pstrctDevice->uiMessagesCount = 0xFFFE;
+    g_liveness.update(TEST_DEVICE_ID, -70);
+    g_liveness.update(TEST_DEVICE_ID, -70);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, l_pstrctDevice->uiMessagesCount);
+}
+
+void test_alive_bitmap() {
+    byte l_abyBitmap[DEVICE_LIVENESS_BITMAP_LENGTH];
+
+    TEST_ASSERT_EQUAL_UINT8(16, DEVICE_LIVENESS_BITMAP_LENGTH);
+
+    //out of range address ignored
+    g_liveness.update(TEST_DEVICE_ID, -70);
+    g_liveness.update(TEST_OTHER_DEVICE_ID, -80);
+    g_liveness.update(MAX_RADIO_DEVICES, -80);
+    g_liveness.closePeriod();
+
+    TEST_ASSERT_EQUAL_UINT8(2, g_liveness.getAliveBitmap(l_abyBitmap));
+    TEST_ASSERT_EQUAL_UINT8(2, g_liveness.getAliveCount());
+    TEST_ASSERT_EQUAL_HEX8(1 << (TEST_DEVICE_ID % 8), l_abyBitmap[TEST_DEVICE_ID / 8]);
+    TEST_ASSERT_EQUAL_HEX8(1 << (TEST_OTHER_DEVICE_ID % 8), l_abyBitmap[TEST_OTHER_DEVICE_ID / 8]);
+    for (byte l_byIndex = 1; l_byIndex < DEVICE_LIVENESS_BITMAP_LENGTH - 1; l_byIndex++) {
+        TEST_ASSERT_EQUAL_HEX8(0, l_abyBitmap[l_byIndex]);
+    }
+
+    //next period: only the devices heard again
+    g_liveness.update(TEST_OTHER_DEVICE_ID, -80);
+    g_liveness.closePeriod();
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getAliveBitmap(l_abyBitmap));
+    TEST_ASSERT_EQUAL_HEX8(0, l_abyBitmap[TEST_DEVICE_ID / 8]);
+}
+
+void test_lost_devices() {
+    uint8_t l_auiLost[MAX_RADIO_DEVICES];
+    byte l_byPeriod;
+
+    g_liveness.update(TEST_DEVICE_ID, -70);
+    g_liveness.update(TEST_OTHER_DEVICE_ID, -80);
+    g_liveness.closePeriod();
+    g_liveness.update(TEST_OTHER_DEVICE_ID, -80);
+
+    //never heard devices are never lost
+    for (l_byPeriod = 1; l_byPeriod < DEVICE_LIVENESS_LOST_PERIODS; l_byPeriod++) {
+        g_liveness.closePeriod();
+        TEST_ASSERT_EQUAL_UINT8(0, g_liveness.getLostDevices(l_auiLost, MAX_RADIO_DEVICES));
+        TEST_ASSERT_EQUAL_UINT8(0, g_liveness.getLostCount());
+    }
+
+    g_liveness.closePeriod();
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getLostDevices(l_auiLost, MAX_RADIO_DEVICES));
+    TEST_ASSERT_EQUAL_UINT8(TEST_DEVICE_ID, l_auiLost[0]);
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getLostCount());
+
+    //reported once, still counted
+    g_liveness.confirmLostDevices(l_auiLost, 1);
+    TEST_ASSERT_EQUAL_UINT8(0, g_liveness.getLostDevices(l_auiLost, MAX_RADIO_DEVICES));
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getLostCount());
+
+    g_liveness.closePeriod();
+    TEST_ASSERT_EQUAL_UINT8(2, g_liveness.getLostCount());
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getLostDevices(l_auiLost, MAX_RADIO_DEVICES));
+    TEST_ASSERT_EQUAL_UINT8(TEST_OTHER_DEVICE_ID, l_auiLost[0]);
+
+    //heard again: alive, and lost again only after the full count of missed periods
+    g_liveness.update(TEST_DEVICE_ID, -50);
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getLostCount());
+    g_liveness.closePeriod();
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getAliveCount());
+    for (l_byPeriod = 1; l_byPeriod < DEVICE_LIVENESS_LOST_PERIODS; l_byPeriod++) {
+        g_liveness.closePeriod();
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getLostCount());
+    g_liveness.closePeriod();
+    TEST_ASSERT_EQUAL_UINT8(2, g_liveness.getLostCount());
+}
+
+void test_confirm_heard_again() {
+    uint8_t l_auiLost[MAX_RADIO_DEVICES];
+
+    g_liveness.update(TEST_DEVICE_ID, -70);
+    for (byte l_byPeriod = 0; l_byPeriod <= DEVICE_LIVENESS_LOST_PERIODS; l_byPeriod++) {
+        g_liveness.closePeriod();
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getLostDevices(l_auiLost, MAX_RADIO_DEVICES));
+
+    //heard between the upload and its confirmation: left alive, a later loss is reported again
+    g_liveness.update(TEST_DEVICE_ID, -70);
+    g_liveness.confirmLostDevices(l_auiLost, 1);
+    TEST_ASSERT_EQUAL_UINT8(0, g_liveness.getLostCount());
+
+    for (byte l_byPeriod = 0; l_byPeriod <= DEVICE_LIVENESS_LOST_PERIODS; l_byPeriod++) {
+        g_liveness.closePeriod();
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, g_liveness.getLostDevices(l_auiLost, MAX_RADIO_DEVICES));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_update);
+    RUN_TEST(test_alive_bitmap);
+    RUN_TEST(test_lost_devices);
+    RUN_TEST(test_confirm_heard_again);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host tests of CDownlinkQueue: replacement of a pending command, confirmation, overflow and sequence wrap
+ */
+#include <unity.h>
+#include "radio/CDownlinkQueue.h"
+
+#define TEST_DEVICE_ID              5
+#define TEST_OTHER_DEVICE_ID        6
+
+static CDownlinkQueue g_queue;
+
+void setUp() {
+    g_queue = CDownlinkQueue();
+}
+
+void tearDown() {}
+
+void test_pending_per_device() {
+    STRUCT_RADIO_DOWNLINK_COMMAND l_astrctCommands[RADIO_DOWNLINK_MAX_COMMANDS];
+
+    TEST_ASSERT_TRUE(g_queue.push(TEST_DEVICE_ID, 1, 10));
+    TEST_ASSERT_TRUE(g_queue.push(TEST_OTHER_DEVICE_ID, 2, 3));
+    TEST_ASSERT_TRUE(g_queue.push(TEST_DEVICE_ID, 3, 20));
+    TEST_ASSERT_TRUE(g_queue.push(TEST_DEVICE_ID, 4, 30));
+    TEST_ASSERT_EQUAL_UINT8(4, g_queue.getCount());
+
+    //oldest first, no more than asked
+    TEST_ASSERT_EQUAL_UINT8(RADIO_DOWNLINK_MAX_COMMANDS, g_queue.getPending(TEST_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS));
+    TEST_ASSERT_EQUAL_UINT8(1, l_astrctCommands[0].uiCommand);
+    TEST_ASSERT_EQUAL_UINT16(10, l_astrctCommands[0].uiValue);
+    TEST_ASSERT_EQUAL_UINT8(3, l_astrctCommands[1].uiCommand);
+    TEST_ASSERT_EQUAL_UINT16(20, l_astrctCommands[1].uiValue);
+
+    TEST_ASSERT_EQUAL_UINT8(1, g_queue.getPending(TEST_OTHER_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS));
+    TEST_ASSERT_EQUAL_UINT8(2, l_astrctCommands[0].uiCommand);
+    TEST_ASSERT_EQUAL_UINT8(0, g_queue.getPending(TEST_OTHER_DEVICE_ID + 1, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS));
+}
+
+void test_replace_and_confirm() {
+    STRUCT_RADIO_DOWNLINK_COMMAND l_astrctCommands[RADIO_DOWNLINK_MAX_COMMANDS];
+    byte l_byFirstSequence;
+    byte l_bySecondSequence;
+
+    g_queue.push(TEST_DEVICE_ID, 1, 10);
+    g_queue.push(TEST_OTHER_DEVICE_ID, 2, 3);
+    g_queue.push(TEST_DEVICE_ID, 3, 20);
+    g_queue.getPending(TEST_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS);
+    l_byFirstSequence = l_astrctCommands[0].uiSequence;
+    l_bySecondSequence = l_astrctCommands[1].uiSequence;
+
+    //same kind: replaced, queued last with a new sequence
+    TEST_ASSERT_TRUE(g_queue.push(TEST_DEVICE_ID, 1, 11));
+    TEST_ASSERT_EQUAL_UINT8(3, g_queue.getCount());
+    g_queue.getPending(TEST_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS);
+    TEST_ASSERT_EQUAL_UINT8(3, l_astrctCommands[0].uiCommand);
+    TEST_ASSERT_EQUAL_UINT8(1, l_astrctCommands[1].uiCommand);
+    TEST_ASSERT_EQUAL_UINT16(11, l_astrctCommands[1].uiValue);
+    TEST_ASSERT_NOT_EQUAL(l_byFirstSequence, l_astrctCommands[1].uiSequence);
+
+    //confirmed with the older ones of the device, the replaced value stays
+    g_queue.confirm(TEST_DEVICE_ID, l_bySecondSequence);
+    TEST_ASSERT_EQUAL_UINT8(1, g_queue.getPending(TEST_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS));
+    TEST_ASSERT_EQUAL_UINT8(1, l_astrctCommands[0].uiCommand);
+    TEST_ASSERT_EQUAL_UINT16(11, l_astrctCommands[0].uiValue);
+
+    //sequence of the replaced command, or confirmed twice, or of another device: nothing released
+    g_queue.confirm(TEST_DEVICE_ID, l_byFirstSequence);
+    g_queue.confirm(TEST_DEVICE_ID, l_bySecondSequence);
+    g_queue.confirm(TEST_OTHER_DEVICE_ID, l_astrctCommands[0].uiSequence);
+    TEST_ASSERT_EQUAL_UINT8(2, g_queue.getCount());
+
+    g_queue.confirm(TEST_DEVICE_ID, l_astrctCommands[0].uiSequence);
+    TEST_ASSERT_EQUAL_UINT8(1, g_queue.getCount());
+    TEST_ASSERT_EQUAL_UINT8(0, g_queue.getPending(TEST_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS));
+    TEST_ASSERT_EQUAL_UINT8(1, g_queue.getPending(TEST_OTHER_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS));
+}
+
+void test_overflow() {
+    STRUCT_RADIO_DOWNLINK_COMMAND l_astrctCommands[RADIO_DOWNLINK_MAX_COMMANDS];
+    byte l_byIndex;
+
+    TEST_ASSERT_TRUE(g_queue.push(TEST_OTHER_DEVICE_ID, 1, 1));
+    for (l_byIndex = 1; l_byIndex < RADIO_DOWNLINK_QUEUE_LENGTH; l_byIndex++) {
+        TEST_ASSERT_TRUE(g_queue.push(TEST_DEVICE_ID, l_byIndex, l_byIndex));
+    }
+    TEST_ASSERT_EQUAL_UINT8(RADIO_DOWNLINK_QUEUE_LENGTH, g_queue.getCount());
+
+    //full: the oldest command is dropped
+    TEST_ASSERT_FALSE(g_queue.push(TEST_DEVICE_ID, RADIO_DOWNLINK_QUEUE_LENGTH, 0));
+    TEST_ASSERT_EQUAL_UINT8(RADIO_DOWNLINK_QUEUE_LENGTH, g_queue.getCount());
+    TEST_ASSERT_EQUAL_UINT8(0, g_queue.getPending(TEST_OTHER_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS));
+
+    //a replacement frees its own entry: nothing dropped
+    TEST_ASSERT_TRUE(g_queue.push(TEST_DEVICE_ID, 1, 100));
+    TEST_ASSERT_EQUAL_UINT8(RADIO_DOWNLINK_QUEUE_LENGTH, g_queue.getCount());
+    g_queue.getPending(TEST_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS);
+    TEST_ASSERT_EQUAL_UINT8(2, l_astrctCommands[0].uiCommand);
+}
+
+void test_sequence_never_zero() {
+    STRUCT_RADIO_DOWNLINK_COMMAND l_astrctCommands[RADIO_DOWNLINK_MAX_COMMANDS];
+    byte l_byPreviousSequence = 0;
+
+    //across several wraps of the 8 bits sequence
+    for (uint16_t l_uiIndex = 0; l_uiIndex < 600; l_uiIndex++) {
+        g_queue.push(TEST_DEVICE_ID, 1, l_uiIndex);
+        TEST_ASSERT_EQUAL_UINT8(1, g_queue.getPending(TEST_DEVICE_ID, l_astrctCommands, RADIO_DOWNLINK_MAX_COMMANDS));
+        TEST_ASSERT_NOT_EQUAL(0, l_astrctCommands[0].uiSequence);
+        TEST_ASSERT_NOT_EQUAL(l_byPreviousSequence, l_astrctCommands[0].uiSequence);
+        l_byPreviousSequence = l_astrctCommands[0].uiSequence;
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_pending_per_device);
+    RUN_TEST(test_replace_and_confirm);
+    RUN_TEST(test_overflow);
+    RUN_TEST(test_sequence_never_zero);
+    return UNITY_END();
+}
@@ -0,0 +1,291 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host tests of CFlashLog over a simulated NVM (cf test/stubs/FlashStorage.h): append and scan, 
+ *  ring wrap-around and wear levelling, replay cursor, rebuild at init and power losses
+ */
+#include <unity.h>
+#include "logger/CFlashLog.h"
+
+#define TEST_ROWS                   4
+#define TEST_DEVICE_ID              3
+#define TEST_FIRST_TIMESTAMP        100
+#define TEST_RING_TURNS             50
+
+//the head row is erased as soon as the head enters it: one row of readings is dropped at once
+#define TEST_MAX_READINGS           (TEST_ROWS * FLASH_LOG_RECORDS_PER_ROW - 1)
+
+alignas(FLASH_LOG_ROW_SIZE) static byte g_abyFlashArea[TEST_ROWS * FLASH_LOG_ROW_SIZE];
+alignas(FLASH_LOG_ROW_SIZE) static byte g_abyFlashAreaSnapshot[TEST_ROWS * FLASH_LOG_ROW_SIZE];
+
+/**
+ *  Sensor values of a reading, derived from its timestamp
+ */
+static void getSensorValues(uint32_t p_ulTimestamp, byte *p_pbySensorValues) {
+    for (byte l_byIndex = 0; l_byIndex < RADIO_SENSOR_VALUES_LENGTH; l_byIndex++) {
+        p_pbySensorValues[l_byIndex] = (byte)(p_ulTimestamp * 7 + l_byIndex);
+    }
+}
+
+static boolean appendReading(CFlashLog *p_pLog, uint32_t p_ulTimestamp) {
+    byte l_abySensorValues[RADIO_SENSOR_VALUES_LENGTH];
+
+    getSensorValues(p_ulTimestamp, l_abySensorValues);
+    return p_pLog->append(TEST_DEVICE_ID, p_ulTimestamp, l_abySensorValues);
+}
+
+/**
+ *  Walk the log from a cursor: readings must be consecutive, and match appendReading()
+ *  params:
+ *      p_pLog:             log
+ *      p_uiCursor:         sequence to read from
+ *      p_pulFirstTimestamp:timestamp of the first reading read, unchanged if none
+ *  return:
+ *      readings count
+ */
+static uint16_t scanReadings(CFlashLog *p_pLog, uint16_t p_uiCursor, uint32_t *p_pulFirstTimestamp) {
+    STRUCT_FLASH_LOG_RECORD l_strctRecord;
+    byte l_abySensorValues[RADIO_SENSOR_VALUES_LENGTH];
+    uint32_t l_ulTimestamp = 0;
+    uint16_t l_uiCount = 0;
+
+    while (p_pLog->readNext(&p_uiCursor, &l_strctRecord)) {
+        getSensorValues(l_strctRecord.ulTimestamp, l_abySensorValues);
+        TEST_ASSERT_EQUAL_UINT8(TEST_DEVICE_ID, l_strctRecord.uiDeviceId);
+        TEST_ASSERT_EQUAL_MEMORY(l_abySensorValues, l_strctRecord.abySensorValues, RADIO_SENSOR_VALUES_LENGTH);
+
+        if (l_uiCount == 0) {
+            *p_pulFirstTimestamp = l_strctRecord.ulTimestamp;
+        } else {
+            TEST_ASSERT_EQUAL_UINT32(l_ulTimestamp + 1, l_strctRecord.ulTimestamp);
+        }
+        l_ulTimestamp = l_strctRecord.ulTimestamp;
+        l_uiCount++;
+    }
+
+    return l_uiCount;
+}
+
+/**
+ *  Counters kept by the log must match a full walk of the flash content
+ */
+static void checkCounters(CFlashLog *p_pLog) {
+    uint32_t l_ulFirstTimestamp = 0;
+
+    TEST_ASSERT_EQUAL_UINT16(scanReadings(p_pLog, p_pLog->getOldestSequence(), &l_ulFirstTimestamp), p_pLog->getRecordsCount());
+    TEST_ASSERT_EQUAL_UINT16(scanReadings(p_pLog, p_pLog->getReplayCursor(), &l_ulFirstTimestamp), p_pLog->getPendingCount());
+
+    if (p_pLog->getPendingCount() != 0) {
+        TEST_ASSERT_EQUAL_UINT32(l_ulFirstTimestamp, p_pLog->getOldestPendingTimestamp());
+    }
+}
+
+void setUp() {
+    //fresh firmware image: the area is zeroed, not erased
+    memset(g_abyFlashArea, 0, sizeof(g_abyFlashArea));
+    g_ulStubFlashFaults = 0;
+    g_ulStubFlashErases = 0;
+    g_lStubFlashWordsBudget = STUB_FLASH_UNLIMITED;
+}
+
+void tearDown() {
+    TEST_ASSERT_EQUAL_UINT32(0, g_ulStubFlashFaults);
+}
+
+void test_init() {
+    CFlashLog l_log;
+    STRUCT_FLASH_LOG_RECORD l_strctRecord;
+    uint16_t l_uiCursor = 0;
+
+    TEST_ASSERT_FALSE(l_log.init(&g_abyFlashArea[FLASH_LOG_ROW_SIZE / 2], TEST_ROWS - 1));
+    TEST_ASSERT_FALSE(l_log.init(g_abyFlashArea, 1));
+    TEST_ASSERT_FALSE(l_log.append(TEST_DEVICE_ID, 0, g_abyFlashArea));
+
+    TEST_ASSERT_TRUE(l_log.init(g_abyFlashArea, TEST_ROWS));
+    TEST_ASSERT_EQUAL_UINT16(0, l_log.getRecordsCount());
+    TEST_ASSERT_EQUAL_UINT16(0, l_log.getPendingCount());
+    TEST_ASSERT_EQUAL_UINT32(0, l_log.getNewestTimestamp());
+    TEST_ASSERT_FALSE(l_log.readNext(&l_uiCursor, &l_strctRecord));
+
+    //cursor records are not readings
+    TEST_ASSERT_FALSE(l_log.append(FLASH_LOG_CURSOR_DEVICE_ID, 0, g_abyFlashArea));
+}
+
+void test_append_and_scan() {
+    CFlashLog l_log;
+    uint32_t l_ulFirstTimestamp = 0;
+
+    TEST_ASSERT_TRUE(l_log.init(g_abyFlashArea, TEST_ROWS));
+
+    for (uint32_t l_ulTimestamp = TEST_FIRST_TIMESTAMP; l_ulTimestamp < TEST_FIRST_TIMESTAMP + TEST_MAX_READINGS; l_ulTimestamp++) {
+        TEST_ASSERT_TRUE(appendReading(&l_log, l_ulTimestamp));
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(TEST_MAX_READINGS, l_log.getRecordsCount());
+    TEST_ASSERT_EQUAL_UINT16(TEST_MAX_READINGS, l_log.getPendingCount());
+    TEST_ASSERT_EQUAL_UINT32(TEST_FIRST_TIMESTAMP, l_log.getOldestPendingTimestamp());
+    TEST_ASSERT_EQUAL_UINT32(TEST_FIRST_TIMESTAMP + TEST_MAX_READINGS - 1, l_log.getNewestTimestamp());
+    TEST_ASSERT_EQUAL_UINT16(TEST_MAX_READINGS, scanReadings(&l_log, l_log.getReplayCursor(), &l_ulFirstTimestamp));
+    TEST_ASSERT_EQUAL_UINT32(TEST_FIRST_TIMESTAMP, l_ulFirstTimestamp);
+}
+
+void test_ring_wrap_around() {
+    CFlashLog l_log;
+    uint32_t l_aulRowErases[TEST_ROWS] = {0};
+    uint32_t l_ulErases;
+    uint32_t l_ulTimestamp;
+    uint32_t l_ulFirstTimestamp = 0;
+    uint16_t l_uiRow;
+
+    TEST_ASSERT_TRUE(l_log.init(g_abyFlashArea, TEST_ROWS));
+
+    for (l_ulTimestamp = TEST_FIRST_TIMESTAMP; l_ulTimestamp < TEST_FIRST_TIMESTAMP + TEST_RING_TURNS * TEST_ROWS * FLASH_LOG_RECORDS_PER_ROW; l_ulTimestamp++) {
+        l_ulErases = g_ulStubFlashErases;
+        TEST_ASSERT_TRUE(appendReading(&l_log, l_ulTimestamp));
+
+        if (g_ulStubFlashErases != l_ulErases) {
+            l_aulRowErases[((const byte *)g_pvStubFlashLastErase - g_abyFlashArea) / FLASH_LOG_ROW_SIZE]++;
+        }
+
+        //the oldest row is dropped, readings left are the newest ones
+        TEST_ASSERT_LESS_OR_EQUAL(TEST_MAX_READINGS, l_log.getRecordsCount());
+        TEST_ASSERT_EQUAL_UINT16(l_log.getRecordsCount(), l_log.getPendingCount());
+    }
+
+    TEST_ASSERT_GREATER_OR_EQUAL(TEST_MAX_READINGS + 1 - FLASH_LOG_RECORDS_PER_ROW, l_log.getRecordsCount());
+    TEST_ASSERT_EQUAL_UINT16(l_log.getRecordsCount(), scanReadings(&l_log, l_log.getOldestSequence(), &l_ulFirstTimestamp));
+    TEST_ASSERT_EQUAL_UINT32(l_ulTimestamp - l_log.getRecordsCount(), l_ulFirstTimestamp);
+    checkCounters(&l_log);
+
+    //every row erased once per turn
+    for (l_uiRow = 0; l_uiRow < TEST_ROWS; l_uiRow++) {
+        TEST_ASSERT_INT_WITHIN(1, TEST_RING_TURNS, l_aulRowErases[l_uiRow]);
+    }
+}
+
+void test_replay_cursor() {
+    CFlashLog l_log;
+    CFlashLog l_logRebuilt;
+    STRUCT_FLASH_LOG_RECORD l_strctRecord;
+    uint32_t l_ulTimestamp = TEST_FIRST_TIMESTAMP;
+    uint16_t l_uiCursor;
+    uint16_t l_uiRead;
+
+    TEST_ASSERT_TRUE(l_log.init(g_abyFlashArea, TEST_ROWS));
+
+    for (uint16_t l_uiRound = 0; l_uiRound < 400; l_uiRound++) {
+        for (uint16_t l_uiIndex = (l_uiRound * 7) % 5 + 1; l_uiIndex != 0; l_uiIndex--) {
+            TEST_ASSERT_TRUE(appendReading(&l_log, l_ulTimestamp++));
+        }
+        checkCounters(&l_log);
+
+        //replay a batch
+        if ((l_uiRound % 3) == 0) {
+            l_uiCursor = l_log.getReplayCursor();
+            for (l_uiRead = 0; (l_uiRead < 4) && l_log.readNext(&l_uiCursor, &l_strctRecord); l_uiRead++);
+
+            TEST_ASSERT_TRUE(l_log.commitReplayCursor(l_uiCursor));
+            TEST_ASSERT_EQUAL_UINT16(l_uiCursor, l_log.getReplayCursor());
+            checkCounters(&l_log);
+        }
+
+        //restart: same state rebuilt from the flash content
+        if ((l_uiRound % 50) == 49) {
+            TEST_ASSERT_TRUE(l_logRebuilt.init(g_abyFlashArea, TEST_ROWS));
+            TEST_ASSERT_EQUAL_UINT16(l_log.getReplayCursor(), l_logRebuilt.getReplayCursor());
+            TEST_ASSERT_EQUAL_UINT16(l_log.getRecordsCount(), l_logRebuilt.getRecordsCount());
+            TEST_ASSERT_EQUAL_UINT16(l_log.getPendingCount(), l_logRebuilt.getPendingCount());
+            TEST_ASSERT_EQUAL_UINT32(l_log.getNewestTimestamp(), l_logRebuilt.getNewestTimestamp());
+            if (l_log.getPendingCount() != 0) {
+                TEST_ASSERT_EQUAL_UINT32(l_log.getOldestPendingTimestamp(), l_logRebuilt.getOldestPendingTimestamp());
+            }
+            checkCounters(&l_logRebuilt);
+        }
+    }
+}
+
+/**
+ *  Power loss at every flash word of an append, or of a cursor commit: the log rebuilt at init 
+ *  holds the record or not, never a torn one, and keeps working
+ */
+void test_power_loss() {
+    CFlashLog l_log;
+    CFlashLog l_logRebuilt;
+    STRUCT_FLASH_LOG_RECORD l_strctRecord;
+    uint32_t l_ulTimestamp;
+    uint32_t l_ulFirstTimestamp = 0;
+    uint16_t l_uiCursor, l_uiCursorBefore;
+    uint16_t l_uiRecordsCount;
+    //last slot of a row: the append erases the next row too
+    const uint16_t l_auiPrefillCounts[] = {20, FLASH_LOG_RECORDS_PER_ROW - 1};
+
+    for (byte l_byCase = 0; l_byCase < sizeof(l_auiPrefillCounts) / sizeof(l_auiPrefillCounts[0]); l_byCase++) {
+        setUp();
+        TEST_ASSERT_TRUE(l_log.init(g_abyFlashArea, TEST_ROWS));
+        for (l_ulTimestamp = TEST_FIRST_TIMESTAMP; l_ulTimestamp < TEST_FIRST_TIMESTAMP + (uint32_t)l_auiPrefillCounts[l_byCase]; l_ulTimestamp++) {
+            TEST_ASSERT_TRUE(appendReading(&l_log, l_ulTimestamp));
+        }
+        l_uiRecordsCount = l_log.getRecordsCount();
+        l_uiCursorBefore = l_log.getReplayCursor();
+        memcpy(g_abyFlashAreaSnapshot, g_abyFlashArea, sizeof(g_abyFlashArea));
+
+        for (int32_t l_lBudget = 0; l_lBudget <= (int32_t)(sizeof(STRUCT_FLASH_LOG_RECORD) / STUB_FLASH_WORD_SIZE); l_lBudget++) {
+            //reading
+            memcpy(g_abyFlashArea, g_abyFlashAreaSnapshot, sizeof(g_abyFlashArea));
+            TEST_ASSERT_TRUE(l_log.init(g_abyFlashArea, TEST_ROWS));
+            g_lStubFlashWordsBudget = l_lBudget;
+            appendReading(&l_log, l_ulTimestamp);
+            g_lStubFlashWordsBudget = STUB_FLASH_UNLIMITED;
+
+            TEST_ASSERT_TRUE(l_logRebuilt.init(g_abyFlashArea, TEST_ROWS));
+            TEST_ASSERT_INT_WITHIN(1, l_uiRecordsCount, l_logRebuilt.getRecordsCount());
+            TEST_ASSERT_GREATER_OR_EQUAL(l_uiRecordsCount, l_logRebuilt.getRecordsCount());
+            TEST_ASSERT_EQUAL_UINT16(l_logRebuilt.getRecordsCount(), scanReadings(&l_logRebuilt, l_logRebuilt.getOldestSequence(), &l_ulFirstTimestamp));
+            TEST_ASSERT_EQUAL_UINT32(TEST_FIRST_TIMESTAMP, l_ulFirstTimestamp);
+            TEST_ASSERT_TRUE(appendReading(&l_logRebuilt, TEST_FIRST_TIMESTAMP + l_logRebuilt.getRecordsCount()));
+            checkCounters(&l_logRebuilt);
+
+            //cursor
+            memcpy(g_abyFlashArea, g_abyFlashAreaSnapshot, sizeof(g_abyFlashArea));
+            TEST_ASSERT_TRUE(l_log.init(g_abyFlashArea, TEST_ROWS));
+            l_uiCursor = l_log.getReplayCursor();
+            TEST_ASSERT_TRUE(l_log.readNext(&l_uiCursor, &l_strctRecord));
+            g_lStubFlashWordsBudget = l_lBudget;
+            l_log.commitReplayCursor(l_uiCursor);
+            g_lStubFlashWordsBudget = STUB_FLASH_UNLIMITED;
+
+            TEST_ASSERT_TRUE(l_logRebuilt.init(g_abyFlashArea, TEST_ROWS));
+            TEST_ASSERT_TRUE((l_logRebuilt.getReplayCursor() == l_uiCursorBefore) || (l_logRebuilt.getReplayCursor() == l_uiCursor));
+            TEST_ASSERT_EQUAL_UINT16(l_uiRecordsCount, l_logRebuilt.getRecordsCount());
+            TEST_ASSERT_TRUE(appendReading(&l_logRebuilt, l_ulTimestamp));
+            checkCounters(&l_logRebuilt);
+        }
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_init);
+    RUN_TEST(test_append_and_scan);
+    RUN_TEST(test_ring_wrap_around);
+    RUN_TEST(test_replay_cursor);
+    RUN_TEST(test_power_loss);
+    return UNITY_END();
+}
@@ -0,0 +1,372 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host tests of CCC1100::walkFrames(): several frames returned by a single RXPayloadBurst() 
+ *  are parsed in place, and every consistent one reaches the circular buffers.
+ *  A fuzz pass feeds random concatenated frames, a bench pass times the walk
+ */
+#include <unity.h>
+#include <time.h>
+#include "radio/CCC1100.h"
+
+#define TEST_DEVICE_ADDR            1
+#define TEST_OTHER_ADDR             7
+#define TEST_SIGNATURE              0x5AA5
+#define TEST_FUZZ_ITERATIONS        100000
+#define TEST_BENCH_ITERATIONS       20000
+
+//frame length without data: length byte, header, message type and length, RSSI and LQI
+#define TEST_FRAME_OVERHEAD         (sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_HEADER) + 2 + 2)
+#define TEST_MAX_FRAME_LENGTH       (TEST_FRAME_OVERHEAD + MAX_RADIO_MESSAGE_DATA_LENGTH)
+
+/**
+ *  Access to the private frame walk, cf friend declaration of CCC1100
+ */
+class CCC1100Test {
+public:
+    static byte *getRXBuffer(CCC1100 *p_pRadio) {
+        return p_pRadio->m_strctRXFrame.unPayload.byArray;
+    }
+
+    static void walkFrames(CCC1100 *p_pRadio, uint16_t p_uiReceivedLength) {
+        p_pRadio->walkFrames(p_uiReceivedLength);
+    }
+
+    static void setLinkProfile(CCC1100 *p_pRadio, CCC1100::ENM_LINK_PROFILE p_enmLinkProfile) {
+        p_pRadio->setLinkProfile(p_enmLinkProfile);
+    }
+
+    //sum over the hopping sequence: acknowledges may move the hopping index
+    static uint16_t getInvalidFrames(CCC1100 *p_pRadio) {
+        uint16_t l_uiInvalidFrames = 0;
+
+        for (byte l_byIndex = 0; l_byIndex < HOPPING_SEQUENCE_LENGTH; l_byIndex++) {
+            l_uiInvalidFrames += p_pRadio->m_astrctHoppingStats[l_byIndex].uiInvalidFrames;
+        }
+
+        return l_uiInvalidFrames;
+    }
+};
+
+static CCC1100 g_radio;
+static CCC1100 g_radioCheck;
+static uint32_t g_ulRandomState;
+
+/**
+ *  xorshift32: same sequence on every host
+ */
+static uint32_t nextRandom() {
+    g_ulRandomState ^= g_ulRandomState << 13;
+    g_ulRandomState ^= g_ulRandomState >> 17;
+    g_ulRandomState ^= g_ulRandomState << 5;
+
+    return g_ulRandomState;
+}
+
+/**
+ *  Write a message frame, as received from the RX FIFO
+ *  params:
+ *      p_pbyFrame:         first byte of the frame
+ *      p_byRecipientAddr:  recipient, BROADCAST_ADDRESS for a frame not acknowledged
+ *      p_bySenderAddr:     sender
+ *      p_uiToken:          network signature
+ *      p_byDataLength:     message data length, data bytes are p_bySenderAddr + index
+ *      p_byLQI:            link quality, CRC flag excluded
+ *  return:
+ *      frame length, including RSSI and LQI bytes
+ */
+static uint16_t writeFrame(byte *p_pbyFrame, byte p_byRecipientAddr, byte p_bySenderAddr, uint16_t p_uiToken, byte p_byDataLength, byte p_byLQI) {
+    CCC1100::STRUCT_RADIO_PAYLOAD_HEADER *l_pstrctHeader = (CCC1100::STRUCT_RADIO_PAYLOAD_HEADER *)p_pbyFrame;
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE *l_pstrctMessage = (CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE *)&p_pbyFrame[sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_HEADER)];
+    uint16_t l_uiFrameLength = TEST_FRAME_OVERHEAD + p_byDataLength;
+
+    l_pstrctHeader->byPayloadLength = l_uiFrameLength - 3;
+    l_pstrctHeader->byRecipientAddr = p_byRecipientAddr;
+    l_pstrctHeader->bySenderAddr = p_bySenderAddr;
+    l_pstrctHeader->wMessageToken = p_uiToken;
+    l_pstrctHeader->byPayloadType = CCC1100::ENM_PAYLOAD_TYPE::MSG;
+    l_pstrctHeader->byFlags = 0;
+    l_pstrctMessage->byMessageType = ENM_RADIO_MSG_TYPE::POST_SENSOR_VALUES;
+    l_pstrctMessage->byDataLength = p_byDataLength;
+
+    for (byte l_byIndex = 0; l_byIndex < p_byDataLength; l_byIndex++) {
+        l_pstrctMessage->abyData[l_byIndex] = p_bySenderAddr + l_byIndex;
+    }
+
+    p_pbyFrame[l_uiFrameLength - 2] = 0x20;
+    p_pbyFrame[l_uiFrameLength - 1] = LQI_CRC_OK | p_byLQI;
+
+    return l_uiFrameLength;
+}
+
+/**
+ *  Check the next queued message against writeFrame() content
+ */
+static void checkMessage(CCC1100 *p_pRadio, byte p_bySenderAddr, byte p_byDataLength, byte p_byLQI) {
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage;
+
+    TEST_ASSERT_EQUAL_INT16(p_bySenderAddr, p_pRadio->getMessage(&l_strctMessage));
+    TEST_ASSERT_EQUAL_UINT8(p_byDataLength, l_strctMessage.byDataLength);
+    TEST_ASSERT_EQUAL_UINT8(p_byLQI, p_pRadio->getMessageLQI());
+
+    for (byte l_byIndex = 0; l_byIndex < MAX_RADIO_MESSAGE_DATA_LENGTH; l_byIndex++) {
+        //bytes past the frame are cleared, never taken from the next frame
+        TEST_ASSERT_EQUAL_UINT8((l_byIndex < p_byDataLength) ? (byte)(p_bySenderAddr + l_byIndex) : 0, l_strctMessage.abyData[l_byIndex]);
+    }
+}
+
+void setUp() {
+    g_ulRandomState = 0x12345678;
+
+    TEST_ASSERT_TRUE(g_radio.init(TEST_DEVICE_ADDR, CCC1100::ENM_OUTPUT_POWER_DBM::PLUS_0, TEST_SIGNATURE, 1, 0, CCC1100::ENM_FEC_MODE::FEC_OFF));
+    memset(CCC1100Test::getRXBuffer(&g_radio), 0, FRAME_BUFFER_SIZE);
+}
+
+void tearDown() {}
+
+void test_back_to_back_frames() {
+    byte *l_pbyBuffer = CCC1100Test::getRXBuffer(&g_radio);
+    byte l_abyDataLengths[] = {0, 5, 30, MAX_RADIO_MESSAGE_DATA_LENGTH};
+    byte l_abyReceived[FRAME_BUFFER_SIZE];
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage;
+    uint16_t l_uiLength = 0;
+
+    for (byte l_byIndex = 0; l_byIndex < sizeof(l_abyDataLengths); l_byIndex++) {
+        l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], BROADCAST_ADDRESS, 10 + l_byIndex, TEST_SIGNATURE, l_abyDataLengths[l_byIndex], 20 + l_byIndex);
+    }
+    memcpy(l_abyReceived, l_pbyBuffer, FRAME_BUFFER_SIZE);
+
+    CCC1100Test::walkFrames(&g_radio, l_uiLength);
+
+    //nothing moved
+    TEST_ASSERT_EQUAL_MEMORY(l_abyReceived, l_pbyBuffer, FRAME_BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_UINT16(0, CCC1100Test::getInvalidFrames(&g_radio));
+
+    for (byte l_byIndex = 0; l_byIndex < sizeof(l_abyDataLengths); l_byIndex++) {
+        checkMessage(&g_radio, 10 + l_byIndex, l_abyDataLengths[l_byIndex], 20 + l_byIndex);
+    }
+    TEST_ASSERT_EQUAL_INT16(-1, g_radio.getMessage(&l_strctMessage));
+}
+
+void test_frames_addressing() {
+    byte *l_pbyBuffer = CCC1100Test::getRXBuffer(&g_radio);
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage;
+    uint32_t l_ulAcknowledges = SPI.m_ulTXFIFOBursts;
+    uint16_t l_uiLength = 0;
+
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], TEST_OTHER_ADDR, 10, TEST_SIGNATURE, 4, 1);
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], TEST_DEVICE_ADDR, 11, TEST_SIGNATURE, 4, 2);
+
+    CCC1100Test::walkFrames(&g_radio, l_uiLength);
+
+    //the frame for another device is ignored, the one for this device is acknowledged
+    checkMessage(&g_radio, 11, 4, 2);
+    TEST_ASSERT_EQUAL_INT16(-1, g_radio.getMessage(&l_strctMessage));
+    TEST_ASSERT_EQUAL_UINT32(l_ulAcknowledges + 1, SPI.m_ulTXFIFOBursts);
+}
+
+void test_truncated_frame_stops_walk() {
+    byte *l_pbyBuffer = CCC1100Test::getRXBuffer(&g_radio);
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage;
+    uint16_t l_uiLength = 0;
+
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], BROADCAST_ADDRESS, 10, TEST_SIGNATURE, 8, 1);
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], BROADCAST_ADDRESS, 11, TEST_SIGNATURE, 40, 2);
+
+    CCC1100Test::walkFrames(&g_radio, l_uiLength - 1);
+
+    checkMessage(&g_radio, 10, 8, 1);
+    TEST_ASSERT_EQUAL_INT16(-1, g_radio.getMessage(&l_strctMessage));
+    TEST_ASSERT_EQUAL_UINT16(1, CCC1100Test::getInvalidFrames(&g_radio));
+}
+
+void test_inconsistent_length_stops_walk() {
+    byte *l_pbyBuffer = CCC1100Test::getRXBuffer(&g_radio);
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage;
+    uint16_t l_uiLength = 0;
+
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], BROADCAST_ADDRESS, 10, TEST_SIGNATURE, 8, 1);
+    //header cut short, then a valid frame which can't be trusted anymore
+    l_pbyBuffer[l_uiLength] = sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_HEADER) - 2;
+    l_uiLength += sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_HEADER) + 1;
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], BROADCAST_ADDRESS, 11, TEST_SIGNATURE, 8, 2);
+
+    CCC1100Test::walkFrames(&g_radio, l_uiLength);
+
+    checkMessage(&g_radio, 10, 8, 1);
+    TEST_ASSERT_EQUAL_INT16(-1, g_radio.getMessage(&l_strctMessage));
+    TEST_ASSERT_EQUAL_UINT16(1, CCC1100Test::getInvalidFrames(&g_radio));
+
+    //longer than the largest message
+    memset(CCC1100Test::getRXBuffer(&g_radio), 0, FRAME_BUFFER_SIZE);
+    l_uiLength = writeFrame(l_pbyBuffer, BROADCAST_ADDRESS, 12, TEST_SIGNATURE, MAX_RADIO_MESSAGE_DATA_LENGTH, 3);
+    l_pbyBuffer[0]++;
+
+    CCC1100Test::walkFrames(&g_radio, l_uiLength + 1);
+
+    TEST_ASSERT_EQUAL_INT16(-1, g_radio.getMessage(&l_strctMessage));
+    TEST_ASSERT_EQUAL_UINT16(2, CCC1100Test::getInvalidFrames(&g_radio));
+}
+
+void test_foreign_signature_skipped() {
+    byte *l_pbyBuffer = CCC1100Test::getRXBuffer(&g_radio);
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage;
+    uint16_t l_uiLength = 0;
+
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], BROADCAST_ADDRESS, 10, TEST_SIGNATURE, 8, 1);
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], BROADCAST_ADDRESS, 11, TEST_SIGNATURE + 1, 8, 2);
+    l_uiLength += writeFrame(&l_pbyBuffer[l_uiLength], BROADCAST_ADDRESS, 12, TEST_SIGNATURE, 8, 3);
+
+    CCC1100Test::walkFrames(&g_radio, l_uiLength);
+
+    checkMessage(&g_radio, 10, 8, 1);
+    checkMessage(&g_radio, 12, 8, 3);
+    TEST_ASSERT_EQUAL_INT16(-1, g_radio.getMessage(&l_strctMessage));
+    TEST_ASSERT_EQUAL_UINT16(1, CCC1100Test::getInvalidFrames(&g_radio));
+}
+
+void test_fec_profile_frames() {
+    byte *l_pbyBuffer = CCC1100Test::getRXBuffer(&g_radio);
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage;
+
+    CCC1100Test::setLinkProfile(&g_radio, CCC1100::ENM_LINK_PROFILE::FEC);
+
+    //fixed length packets: padding up to FEC_PACKET_LENGTH, then RSSI and LQI
+    writeFrame(l_pbyBuffer, BROADCAST_ADDRESS, 10, TEST_SIGNATURE, FEC_MAX_RADIO_MESSAGE_DATA_LENGTH, 1);
+    writeFrame(&l_pbyBuffer[FEC_PACKET_LENGTH + 2], BROADCAST_ADDRESS, 11, TEST_SIGNATURE, 3, 0);
+    l_pbyBuffer[2 * FEC_PACKET_LENGTH + 3] = LQI_CRC_OK | 2;
+
+    CCC1100Test::walkFrames(&g_radio, 2 * (FEC_PACKET_LENGTH + 2));
+
+    checkMessage(&g_radio, 10, FEC_MAX_RADIO_MESSAGE_DATA_LENGTH, 1);
+    TEST_ASSERT_EQUAL_INT16(11, g_radio.getMessage(&l_strctMessage));
+    TEST_ASSERT_EQUAL_UINT8(3, l_strctMessage.byDataLength);
+    TEST_ASSERT_EQUAL_UINT8(2, g_radio.getMessageLQI());
+    TEST_ASSERT_EQUAL_INT16(-1, g_radio.getMessage(&l_strctMessage));
+    TEST_ASSERT_EQUAL_UINT16(0, CCC1100Test::getInvalidFrames(&g_radio));
+
+    CCC1100Test::setLinkProfile(&g_radio, CCC1100::ENM_LINK_PROFILE::STANDARD);
+}
+
+/**
+ *  Random concatenated frames, mostly well-formed. The walk runs on two radios whose buffers 
+ *  only differ past the received length: both must queue the same messages
+ */
+void test_fuzz_walk() {
+    byte *l_pbyBuffer = CCC1100Test::getRXBuffer(&g_radio);
+    byte *l_pbyBufferCheck = CCC1100Test::getRXBuffer(&g_radioCheck);
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage, l_strctMessageCheck;
+    const byte l_abyRecipients[] = {BROADCAST_ADDRESS, TEST_DEVICE_ADDR, TEST_OTHER_ADDR};
+    uint32_t l_ulQueued = 0;
+    uint32_t l_ulAcknowledges, l_ulAcknowledgesCheck;
+    uint16_t l_uiLength, l_uiOffset, l_uiFrameOffset;
+    int16_t l_iSender;
+
+    TEST_ASSERT_TRUE(g_radioCheck.init(TEST_DEVICE_ADDR, CCC1100::ENM_OUTPUT_POWER_DBM::PLUS_0, TEST_SIGNATURE, 1, 0, CCC1100::ENM_FEC_MODE::FEC_OFF));
+
+    for (uint32_t l_ulIteration = 0; l_ulIteration < TEST_FUZZ_ITERATIONS; l_ulIteration++) {
+        l_uiOffset = 0;
+
+        while (l_uiOffset < FRAME_BUFFER_SIZE - TEST_MAX_FRAME_LENGTH) {
+            if ((nextRandom() % 10) < 8) {
+                l_uiFrameOffset = l_uiOffset;
+                l_uiOffset += writeFrame(&l_pbyBuffer[l_uiOffset], l_abyRecipients[nextRandom() % sizeof(l_abyRecipients)], 2 + nextRandom() % 100, 
+                                         ((nextRandom() % 10) != 0) ? TEST_SIGNATURE : nextRandom(), nextRandom() % (MAX_RADIO_MESSAGE_DATA_LENGTH + 1), nextRandom() & 0x7F);
+
+                //corrupted header or message length
+                if ((nextRandom() % 10) == 0) {
+                    l_pbyBuffer[l_uiFrameOffset + nextRandom() % (TEST_FRAME_OVERHEAD - 2)] ^= 1 << (nextRandom() % 8);
+                }
+            } else {
+                for (byte l_byIndex = 1 + nextRandom() % 16; l_byIndex != 0; l_byIndex--) {
+                    l_pbyBuffer[l_uiOffset++] = nextRandom();
+                }
+            }
+        }
+
+        l_uiLength = nextRandom() % (l_uiOffset + 1);
+        memcpy(l_pbyBufferCheck, l_pbyBuffer, l_uiLength);
+        memset(&l_pbyBuffer[l_uiLength], 0x00, FRAME_BUFFER_SIZE - l_uiLength);
+        memset(&l_pbyBufferCheck[l_uiLength], 0xFF, FRAME_BUFFER_SIZE - l_uiLength);
+
+        l_ulAcknowledges = SPI.m_ulTXFIFOBursts;
+        CCC1100Test::walkFrames(&g_radio, l_uiLength);
+        l_ulAcknowledgesCheck = SPI.m_ulTXFIFOBursts;
+        CCC1100Test::walkFrames(&g_radioCheck, l_uiLength);
+        TEST_ASSERT_EQUAL_UINT32(l_ulAcknowledgesCheck - l_ulAcknowledges, SPI.m_ulTXFIFOBursts - l_ulAcknowledgesCheck);
+
+        do {
+            l_iSender = g_radio.getMessage(&l_strctMessage);
+            TEST_ASSERT_EQUAL_INT16(l_iSender, g_radioCheck.getMessage(&l_strctMessageCheck));
+
+            if (l_iSender != -1) {
+                TEST_ASSERT_EQUAL_MEMORY(&l_strctMessageCheck, &l_strctMessage, sizeof(CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE));
+                TEST_ASSERT_EQUAL_UINT8(g_radioCheck.getMessageLQI(), g_radio.getMessageLQI());
+                l_ulQueued++;
+            }
+        } while (l_iSender != -1);
+
+        TEST_ASSERT_EQUAL_UINT16(CCC1100Test::getInvalidFrames(&g_radioCheck), CCC1100Test::getInvalidFrames(&g_radio));
+    }
+
+    //well-formed frames do reach the circular buffers
+    TEST_ASSERT_GREATER_THAN(TEST_FUZZ_ITERATIONS / 4, l_ulQueued);
+}
+
+void test_bench_walk() {
+    byte *l_pbyBuffer = CCC1100Test::getRXBuffer(&g_radio);
+    byte l_abyReceived[FRAME_BUFFER_SIZE];
+    CCC1100::STRUCT_RADIO_PAYLOAD_MESSAGE l_strctMessage;
+    char l_acMessage[80];
+    uint16_t l_uiLength = 0;
+    byte l_byFrames = 0;
+    clock_t l_clkStart;
+
+    while (l_uiLength + TEST_FRAME_OVERHEAD + 16 <= FRAME_BUFFER_SIZE) {
+        l_uiLength += writeFrame(&l_abyReceived[l_uiLength], BROADCAST_ADDRESS, 10 + l_byFrames, TEST_SIGNATURE, 16, l_byFrames);
+        l_byFrames++;
+    }
+
+    //getMessage() pulls through the RX frame buffer: it is refilled, as RXPayloadBurst() does
+    l_clkStart = clock();
+    for (uint32_t l_ulIteration = 0; l_ulIteration < TEST_BENCH_ITERATIONS; l_ulIteration++) {
+        memcpy(l_pbyBuffer, l_abyReceived, l_uiLength);
+        CCC1100Test::walkFrames(&g_radio, l_uiLength);
+        while (g_radio.getMessage(&l_strctMessage) != -1);
+    }
+
+    snprintf(l_acMessage, sizeof(l_acMessage), "copy + walk + pull: %u frames per burst, %.1f ns per frame", l_byFrames, 
+             (double)(clock() - l_clkStart) * 1e9 / CLOCKS_PER_SEC / TEST_BENCH_ITERATIONS / l_byFrames);
+    TEST_MESSAGE(l_acMessage);
+    TEST_ASSERT_EQUAL_UINT16(0, CCC1100Test::getInvalidFrames(&g_radio));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_back_to_back_frames);
+    RUN_TEST(test_frames_addressing);
+    RUN_TEST(test_truncated_frame_stops_walk);
+    RUN_TEST(test_inconsistent_length_stops_walk);
+    RUN_TEST(test_foreign_signature_skipped);
+    RUN_TEST(test_fec_profile_frames);
+    RUN_TEST(test_fuzz_walk);
+    RUN_TEST(test_bench_walk);
+    return UNITY_END();
+}
@@ -0,0 +1,223 @@
+/**	
+ *	This is a free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *  This software is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with Foobar.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ *	Author: Gilles PELIZZO
+ *	Date: October 19th, 2026.
+ */
+
+/**
+ *  Host tests of the CHTU21 fixed point math, against the former floating point formulas 
+ *  (Antoine partial pressure and dew point) computed in double precision, and of the burst filter 
+ *  of oversampled measurements
+ */
+#include <unity.h>
+#include "CHTU21.h"
+
+//Antoine constants, cf SENSOR_CONSTANT_*
+#define TEST_CONSTANT_A                 8.1332
+#define TEST_CONSTANT_B                 1762.39
+#define TEST_CONSTANT_C                 235.66
+
+//sensor range, hundredths
+#define TEST_TEMPERATURE_MIN            -4000
+#define TEST_TEMPERATURE_MAX            12500
+#define TEST_TEMPERATURE_STEP           5
+#define TEST_HUMIDITY_MIN               100
+#define TEST_HUMIDITY_MAX               10000
+#define TEST_HUMIDITY_STEP              25
+
+//bounds: partial pressure relative error beyond the output resolution, dew point in degrees
+#define TEST_PARTIAL_PRESSURE_MAX_ERROR 0.0002
+#define TEST_DEW_POINT_MAX_ERROR        0.03
+
+/**
+ *  Access to the private math, cf friend declaration of CHTU21
+ */
+class CHTU21Test {
+public:
+    static uint32_t computePartialPressure(CHTU21 *p_pSensor, int16_t p_iTemperatureValue) {
+        return p_pSensor->computePartialPressure(p_iTemperatureValue);
+    }
+
+    static int16_t computeDewPoint(CHTU21 *p_pSensor, int16_t p_iTemperatureValue, int16_t p_iHumidityValue) {
+        return p_pSensor->computeDewPoint(p_iTemperatureValue, p_iHumidityValue);
+    }
+
+    static uint32_t exp2Q12(CHTU21 *p_pSensor, int32_t p_lValue) {
+        return p_pSensor->exp2Q12(p_lValue);
+    }
+
+    static int32_t log2Q12(CHTU21 *p_pSensor, uint32_t p_ulValue) {
+        return p_pSensor->log2Q12(p_ulValue);
+    }
+
+    static int16_t filterValues(CHTU21 *p_pSensor, int16_t *p_piValues, uint8_t p_uiCount, uint16_t p_uiMinDeviation, 
+                                STRUCT_SENSOR_VALUE_STATISTICS *p_pstrctStatistics, uint8_t *p_puiRejectedCount) {
+        return p_pSensor->filterValues(p_piValues, p_uiCount, p_uiMinDeviation, p_pstrctStatistics, p_puiRejectedCount);
+    }
+
+    static uint16_t squareRoot(CHTU21 *p_pSensor, uint32_t p_ulValue) {
+        return p_pSensor->squareRoot(p_ulValue);
+    }
+};
+
+static CHTU21 g_sensor;
+
+/**
+ *  Former floating point partial pressure, mmHg
+ */
+static double getPartialPressureReference(double p_dTemperature) {
+    return pow(10.0, TEST_CONSTANT_A - TEST_CONSTANT_B / (p_dTemperature + TEST_CONSTANT_C));
+}
+
+/**
+ *  Former floating point dew point, degrees
+ */
+static double getDewPointReference(double p_dTemperature, double p_dHumidity) {
+    double l_dLog10 = log10(p_dHumidity * getPartialPressureReference(p_dTemperature) / 100) - TEST_CONSTANT_A;
+
+    return -(TEST_CONSTANT_B / l_dLog10 + TEST_CONSTANT_C);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_exp2_log2() {
+    double l_dError;
+    double l_dMaxError = 0;
+    char l_acMessage[80];
+
+    //2^x: 0.02%, checked from 2^12 where the rounding of the integer result is negligible
+    for (int32_t l_lValue = 12 * 4096; l_lValue < 24 * 4096; l_lValue++) {
+        l_dError = fabs(CHTU21Test::exp2Q12(&g_sensor, l_lValue) / exp2(l_lValue / 4096.0) - 1);
+        if (l_dError > l_dMaxError) {
+            l_dMaxError = l_dError;
+        }
+    }
+    snprintf(l_acMessage, sizeof(l_acMessage), "exp2Q12 max relative error: %.6f", l_dMaxError);
+    TEST_MESSAGE(l_acMessage);
+    TEST_ASSERT_TRUE(l_dMaxError < 0.0002);
+
+    //log2(x): 0.0004
+    l_dMaxError = 0;
+    for (uint32_t l_ulValue = 1; l_ulValue < 0x40000; l_ulValue++) {
+        l_dError = fabs(CHTU21Test::log2Q12(&g_sensor, l_ulValue) / 4096.0 - log2((double)l_ulValue));
+        if (l_dError > l_dMaxError) {
+            l_dMaxError = l_dError;
+        }
+    }
+    snprintf(l_acMessage, sizeof(l_acMessage), "log2Q12 max error: %.6f", l_dMaxError);
+    TEST_MESSAGE(l_acMessage);
+    TEST_ASSERT_TRUE(l_dMaxError < 0.0004);
+}
+
+void test_partial_pressure() {
+    double l_dReference;
+    double l_dError;
+    double l_dMaxError = 0;
+    char l_acMessage[80];
+
+    for (int16_t l_iTemperature = TEST_TEMPERATURE_MIN; l_iTemperature <= TEST_TEMPERATURE_MAX; l_iTemperature++) {
+        l_dReference = getPartialPressureReference(l_iTemperature / 100.0);
+
+        //hundredths of mmHg: rounding to the output resolution is not an error
+        l_dError = fabs(CHTU21Test::computePartialPressure(&g_sensor, l_iTemperature) / 100.0 - l_dReference);
+        l_dError = max(l_dError - 0.005, 0.0) / l_dReference;
+        if (l_dError > l_dMaxError) {
+            l_dMaxError = l_dError;
+        }
+    }
+
+    snprintf(l_acMessage, sizeof(l_acMessage), "partial pressure max relative error: %.6f", l_dMaxError);
+    TEST_MESSAGE(l_acMessage);
+    TEST_ASSERT_TRUE(l_dMaxError < TEST_PARTIAL_PRESSURE_MAX_ERROR);
+}
+
+void test_dew_point() {
+    double l_dError;
+    double l_dMaxError = 0;
+    char l_acMessage[80];
+
+    for (int16_t l_iTemperature = TEST_TEMPERATURE_MIN; l_iTemperature <= TEST_TEMPERATURE_MAX; l_iTemperature += TEST_TEMPERATURE_STEP) {
+        for (int16_t l_iHumidity = TEST_HUMIDITY_MIN; l_iHumidity <= TEST_HUMIDITY_MAX; l_iHumidity += TEST_HUMIDITY_STEP) {
+            l_dError = fabs(CHTU21Test::computeDewPoint(&g_sensor, l_iTemperature, l_iHumidity) / 100.0 - 
+                            getDewPointReference(l_iTemperature / 100.0, l_iHumidity / 100.0));
+            if (l_dError > l_dMaxError) {
+                l_dMaxError = l_dError;
+            }
+        }
+    }
+
+    snprintf(l_acMessage, sizeof(l_acMessage), "dew point max error: %.4f", l_dMaxError);
+    TEST_MESSAGE(l_acMessage);
+    TEST_ASSERT_TRUE(l_dMaxError < TEST_DEW_POINT_MAX_ERROR);
+
+    //saturated air: dew point is the temperature
+    TEST_ASSERT_INT_WITHIN(3, 2000, CHTU21Test::computeDewPoint(&g_sensor, 2000, 10000));
+}
+
+void test_square_root() {
+    uint32_t l_ulValue;
+    uint32_t l_ulRoot;
+
+    for (l_ulValue = 0; l_ulValue < 0x100000; l_ulValue++) {
+        l_ulRoot = CHTU21Test::squareRoot(&g_sensor, l_ulValue);
+        TEST_ASSERT_TRUE((l_ulRoot * l_ulRoot <= l_ulValue) && ((l_ulRoot + 1) * (l_ulRoot + 1) > l_ulValue));
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(65535, CHTU21Test::squareRoot(&g_sensor, 0xFFFFFFFF));
+    TEST_ASSERT_EQUAL_UINT16(65535, CHTU21Test::squareRoot(&g_sensor, 65535UL * 65535UL));
+    TEST_ASSERT_EQUAL_UINT16(65534, CHTU21Test::squareRoot(&g_sensor, 65535UL * 65535UL - 1));
+}
+
+void test_burst_filter() {
+    int16_t l_aiSpiked[] = {2000, 2001, 2003, 1999, 2500, 2002, 2000, 1998, 2001};
+    int16_t l_aiEven[] = {1030, 1000, 1020, 1010};
+    int16_t l_iSingle = -1234;
+    STRUCT_SENSOR_VALUE_STATISTICS l_strctStatistics;
+    uint8_t l_uiRejectedCount = 0;
+
+    //spike rejected from the value, kept in the statistics
+    TEST_ASSERT_EQUAL_INT16(2001, CHTU21Test::filterValues(&g_sensor, l_aiSpiked, sizeof(l_aiSpiked) / sizeof(int16_t), 30, &l_strctStatistics, &l_uiRejectedCount));
+    TEST_ASSERT_EQUAL_UINT8(1, l_uiRejectedCount);
+    TEST_ASSERT_EQUAL_INT16(1998, l_strctStatistics.iMinValue);
+    TEST_ASSERT_EQUAL_INT16(2500, l_strctStatistics.iMaxValue);
+    TEST_ASSERT_EQUAL_INT16(2056, l_strctStatistics.iMeanValue);
+    TEST_ASSERT_EQUAL_UINT16(156, l_strctStatistics.uiStdDevValue);
+
+    //even count: median between the two middle samples, every sample within the minimum deviation
+    TEST_ASSERT_EQUAL_INT16(1015, CHTU21Test::filterValues(&g_sensor, l_aiEven, sizeof(l_aiEven) / sizeof(int16_t), 30, &l_strctStatistics, &l_uiRejectedCount));
+    TEST_ASSERT_EQUAL_UINT8(1, l_uiRejectedCount);
+    TEST_ASSERT_EQUAL_INT16(1000, l_strctStatistics.iMinValue);
+    TEST_ASSERT_EQUAL_INT16(1030, l_strctStatistics.iMaxValue);
+    TEST_ASSERT_EQUAL_UINT16(11, l_strctStatistics.uiStdDevValue);
+
+    //single sample, negative: rounded towards the nearest
+    TEST_ASSERT_EQUAL_INT16(-1234, CHTU21Test::filterValues(&g_sensor, &l_iSingle, 1, 30, &l_strctStatistics, &l_uiRejectedCount));
+    TEST_ASSERT_EQUAL_UINT8(1, l_uiRejectedCount);
+    TEST_ASSERT_EQUAL_INT16(-1234, l_strctStatistics.iMeanValue);
+    TEST_ASSERT_EQUAL_UINT16(0, l_strctStatistics.uiStdDevValue);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_exp2_log2);
+    RUN_TEST(test_partial_pressure);
+    RUN_TEST(test_dew_point);
+    RUN_TEST(test_square_root);
+    RUN_TEST(test_burst_filter);
+    return UNITY_END();
+}